@@ -0,0 +1,43 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * alloc_counter.cpp -- counts heap allocations by interposing the
+ * malloc family of glibc. GLib and operator new both end up here,
+ * so the counter covers GVariant building as well as std::string
+ * and std::vector copies.
+ ********************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+uint64_t bench_allocations = 0;
+
+extern "C" {
+void* __libc_malloc (size_t size);
+void* __libc_calloc (size_t count, size_t size);
+void* __libc_realloc (void* ptr, size_t size);
+
+void*
+malloc (size_t size)
+{
+    __atomic_add_fetch(&bench_allocations, 1, __ATOMIC_RELAXED);
+
+    return __libc_malloc(size);
+}
+
+void*
+calloc (size_t count, size_t size)
+{
+    __atomic_add_fetch(&bench_allocations, 1, __ATOMIC_RELAXED);
+
+    return __libc_calloc(count, size);
+}
+
+void*
+realloc (void* ptr, size_t size)
+{
+    __atomic_add_fetch(&bench_allocations, 1, __ATOMIC_RELAXED);
+
+    return __libc_realloc(ptr, size);
+}
+};
@@ -0,0 +1,371 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * amplification.cpp -- how much bus traffic does one user action
+ * cause. Scripted scenarios push the hook sequence wayfire fires
+ * for the action through the backend on the synthetic core and
+ * count the signals and their body bytes (as g_variant_get_size,
+ * like bench-storm) through signal_sink, no bus involved.
+ *
+ * The counts are compared with the committed baselines in
+ * amplification-baseline.txt, a scenario that grows by more than
+ * threshold (default 0.10) in either fails the run. After an
+ * intended change, rewrite the baselines with --update.
+ *
+ * Usage: bench-amplification <baseline> [threshold] [--update]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <wayfire/util/log.hpp>
+
+#include "dbus_app_groups.hpp"
+#include "dbus_interface_backend.hpp"
+#include "dbus_workspace_summary.hpp"
+#include "mock_core.hpp"
+
+struct amplification_t
+{
+    uint64_t messages = 0;
+    uint64_t bytes    = 0;
+    /* per signal name, for the report */
+    std::map<std::string, uint64_t> signals;
+};
+
+struct amplification_scenario_t
+{
+    const char* name;
+    std::function<void(mock_core_t*)> run;
+};
+
+static amplification_t counted;
+static bool counting = false;
+
+static void
+count_signal (const gchar* signal_name, GVariant* signal_data)
+{
+    if (!counting) {
+        return;
+    }
+
+    counted.messages++;
+    counted.bytes += signal_data ? g_variant_get_size(signal_data) : 0;
+    counted.signals[signal_name]++;
+}
+
+/***
+ * Called by a scenario once its setup is done,
+ * the action starts here.
+ ***/
+static void
+start_counting ()
+{
+    /* take in what the setup changed without hooks */
+    dbus_app_groups_get();
+    dbus_workspace_summary_masks(0);
+    counted  = amplification_t();
+    counting = true;
+}
+
+/***
+ * A toplevel the scenarios act on, mapped on the first output's
+ * current workspace and not focused.
+ ***/
+static mock_view_t*
+scenario_view (mock_core_t* core)
+{
+    mock_view_t* view = core->add_view(core->outputs[0].get());
+
+    view->app_id = "org.example.app";
+    view->title  = "Document - Example";
+    view->geometry = {100, 100, 800, 600};
+
+    return view;
+}
+
+static const amplification_scenario_t scenarios [] = {
+    {"open_window", [] (mock_core_t* core)
+        {
+            mock_view_t* view = core->add_view(core->outputs[0].get());
+
+            start_counting();
+            on_view_added(view);
+            view->app_id = "org.example.editor";
+            on_view_app_id_changed(view);
+            view->title = "Untitled - Editor";
+            on_view_title_changed(view);
+            view->geometry = {100, 100, 800, 600};
+            on_view_geometry_changed(view);
+            view->activated = true;
+            on_view_focus_changed(view);
+            on_view_workspaces_changed(view);
+        }
+    },
+    {"maximise", [] (mock_core_t* core)
+        {
+            mock_view_t* view = scenario_view(core);
+
+            start_counting();
+            on_view_tiled(view, 15);
+            /* the request comes before the view changes, as in wayfire */
+            on_view_maximized(view, true);
+            view->maximized = true;
+            view->geometry = {0, 0, 1920, 1080};
+            on_view_geometry_changed(view);
+        }
+    },
+    {"click_to_focus", [] (mock_core_t* core)
+        {
+            mock_view_t* view = scenario_view(core);
+
+            view->attention = true;
+            start_counting();
+            on_pointer_button({500.0, 400.0}, 272, false, view);
+            view->activated = true;
+            on_view_focus_changed(view);
+            on_view_hints_changed(view);
+            on_pointer_button({500.0, 400.0}, 272, true, view);
+        }
+    },
+    {"switch_workspace", [] (mock_core_t* core)
+        {
+            mock_output_t* output = core->outputs[0].get();
+            mock_view_t* view = scenario_view(core);
+
+            view->geometry.x += output->width;
+            start_counting();
+            output->workspace = {1, 0};
+            on_output_workspace_changed(output, 1, 0);
+            view->geometry.x -= output->width;
+            view->activated = true;
+            on_view_focus_changed(view);
+        }
+    },
+    {"drag", [] (mock_core_t* core)
+        {
+            mock_view_t* view = scenario_view(core);
+
+            start_counting();
+            on_pointer_button({500.0, 110.0}, 272, false, view);
+            on_view_moving(view);
+            for (int i = 0; i < 30; i++)
+            {
+                view->geometry.x += 10;
+                on_view_geometry_changed(view);
+            }
+
+            on_view_moving(view);
+            on_pointer_button({800.0, 110.0}, 272, true, view);
+        }
+    },
+    {"hotplug_output", [] (mock_core_t* core)
+        {
+            mock_output_t* output;
+            mock_output_t* primary = core->outputs[0].get();
+            std::vector<mock_view_t*> moved;
+
+            core->outputs.push_back(std::make_unique<mock_output_t> (
+                core->outputs.size() + 1, primary->grid));
+            output = core->outputs.back().get();
+
+            start_counting();
+            on_output_added(output);
+            on_output_configuration_changed(output);
+
+            /* two windows end up on it, then it is unplugged again */
+            for (int i = 0; i < 2; i++)
+            {
+                moved.push_back(core->add_view(output));
+                moved.back()->title = "Moved " + std::to_string(i);
+            }
+
+            on_output_removed(output);
+            for (mock_view_t* view : moved)
+            {
+                on_view_output_move_requested(view, output->id, primary->id);
+                view->move_to_output(primary);
+                on_view_output_moved(view, output->id, primary->id);
+                on_view_geometry_changed(view);
+                on_view_workspaces_changed(view);
+            }
+
+            on_output_configuration_changed(primary);
+        }
+    },
+};
+
+static bool
+load_baselines (const char* path,
+                std::map<std::string, amplification_t>& baselines)
+{
+    std::ifstream file(path);
+    std::string line;
+
+    if (!file) {
+        return false;
+    }
+
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string name;
+        amplification_t baseline;
+
+        if (line.empty() || (line[0] == '#')) {
+            continue;
+        }
+
+        if (fields >> name >> baseline.messages >> baseline.bytes) {
+            baselines[name] = baseline;
+        }
+    }
+
+    return true;
+}
+
+static bool
+save_baselines (const char* path,
+                const std::vector<std::pair<std::string,
+                                            amplification_t>>& results)
+{
+    std::ofstream file(path);
+
+    file << "# bench-amplification baselines: scenario, signals, body bytes\n";
+    for (const auto& result : results)
+    {
+        file << result.first << " " << result.second.messages << " " <<
+            result.second.bytes << "\n";
+    }
+
+    return file.good();
+}
+
+static bool
+exceeds (uint64_t value, uint64_t baseline, double threshold)
+{
+    return value > baseline * (1.0 + threshold);
+}
+
+int
+main (int argc, char* argv [])
+{
+    std::map<std::string, amplification_t> baselines;
+    std::vector<std::pair<std::string, amplification_t>> results;
+    double threshold = 0.10;
+    bool update = false;
+    int failed = 0;
+
+    if (argc < 2) {
+        g_printerr("usage: bench-amplification <baseline> [threshold] [--update]\n");
+
+        return 1;
+    }
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (g_strcmp0(argv[i], "--update") == 0) {
+            update = true;
+        }
+        else
+        {
+            threshold = atof(argv[i]);
+        }
+    }
+
+    if (!load_baselines(argv[1], baselines) && !update) {
+        g_printerr("bench-amplification: cannot read %s\n", argv[1]);
+
+        return 1;
+    }
+
+    wf::log::initialize_logging(std::cerr, wf::log::LOG_LEVEL_ERROR,
+                                wf::log::LOG_COLOR_MODE_OFF);
+    geometry_signal = TRUE;
+    find_view_under_action = false;
+    signal_sink = count_signal;
+
+    printf("%-20s %10s %10s %10s %10s\n", "scenario", "signals", "baseline",
+           "bytes", "baseline");
+    for (const amplification_scenario_t& scenario : scenarios)
+    {
+        mock_core_t core(10, 2, {3, 3});
+        std::map<std::string, amplification_t>::iterator baseline;
+        const char* verdict = "";
+
+        /* the population's focus, the scenarios focus something else */
+        dbus_core = &core;
+        focused_view_id = core.cursor_focus ? core.cursor_focus->id : 0;
+        scenario.run(&core);
+        counting  = false;
+        dbus_core = nullptr;
+
+        baseline = baselines.find(scenario.name);
+        if (baseline == baselines.end()) {
+            verdict = update ? "" : "  no baseline";
+            failed += update ? 0 : 1;
+            printf("%-20s %10llu %10s %10llu %10s%s\n", scenario.name,
+                   (unsigned long long)counted.messages, "-",
+                   (unsigned long long)counted.bytes, "-", verdict);
+        }
+        else
+        {
+            if (exceeds(counted.messages, baseline->second.messages,
+                        threshold) ||
+                exceeds(counted.bytes, baseline->second.bytes, threshold)) {
+                verdict = "  REGRESSED";
+                failed += update ? 0 : 1;
+            }
+            else
+            if ((counted.messages < baseline->second.messages) ||
+                (counted.bytes < baseline->second.bytes))
+            {
+                verdict = "  improved, update the baseline";
+            }
+
+            printf("%-20s %10llu %10llu %10llu %10llu%s\n", scenario.name,
+                   (unsigned long long)counted.messages,
+                   (unsigned long long)baseline->second.messages,
+                   (unsigned long long)counted.bytes,
+                   (unsigned long long)baseline->second.bytes, verdict);
+        }
+
+        for (const auto& signal : counted.signals)
+        {
+            printf("    %-32s %llu\n", signal.first.c_str(),
+                   (unsigned long long)signal.second);
+        }
+
+        results.emplace_back(scenario.name, counted);
+    }
+
+    signal_sink = nullptr;
+
+    if (update) {
+        if (!save_baselines(argv[1], results)) {
+            g_printerr("bench-amplification: cannot write %s\n", argv[1]);
+
+            return 1;
+        }
+
+        printf("baselines written to %s\n", argv[1]);
+
+        return 0;
+    }
+
+    if (failed) {
+        printf("%d scenario(s) above the baseline by more than %.0f%%\n",
+               failed, threshold * 100);
+
+        return 1;
+    }
+
+    return 0;
+}
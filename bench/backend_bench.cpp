@@ -0,0 +1,219 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * backend_bench.cpp -- in-process microbenchmark of the dbus
+ * backend. Every method of the interface and every signal hook is
+ * driven against a synthetic core, no bus and no compositor are
+ * involved. Reports ns/op and heap allocations per op.
+ *
+ * Usage: bench-backend [max_views]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <wayfire/util/log.hpp>
+
+#include "dbus_interface_backend.hpp"
+#include "bench_util.hpp"
+#include "mock_core.hpp"
+
+struct bench_scenario_t
+{
+    int views;
+    int outputs;
+    dbus_workspace_t grid;
+};
+
+static const bench_scenario_t scenarios [] = {
+    {10, 1, {3, 3}},
+    {100, 2, {3, 3}},
+    {1000, 3, {5, 5}},
+    {10000, 4, {10, 10}},
+};
+
+static void
+bench_method (const char* method_name, GVariant* parameters, int views)
+{
+    bench_result_t result;
+
+    if (parameters) {
+        g_variant_ref_sink(parameters);
+    }
+
+    result = bench_run([=] ()
+    {
+        handle_method_call(nullptr, nullptr, "/org/wayland/compositor",
+                           "org.wayland.compositor", method_name, parameters,
+                           nullptr, nullptr);
+    });
+    bench_print(method_name, views, result);
+
+    if (parameters) {
+        g_variant_unref(parameters);
+    }
+}
+
+static void
+bench_hook (const char* name, int views, const std::function<void()>& hook)
+{
+    bench_print(name, views, bench_run(hook));
+}
+
+static void
+bench_scenario (const bench_scenario_t& scenario)
+{
+    mock_core_t mock_core(scenario.views, scenario.outputs, scenario.grid);
+    mock_view_t* view;
+    mock_view_t* other;
+    mock_output_t* output;
+    uint id;
+    int n = scenario.views;
+
+    dbus_core = &mock_core;
+
+    /* a toplevel from the middle of the view list */
+    view = mock_core.views[mock_core.views.size() / 2].get();
+    view->parent = nullptr;
+    view->activated = true;
+    other = mock_core.views[mock_core.views.size() / 2 + 1].get();
+    other->activated = true;
+    output = view->output;
+    id = view->id;
+
+    printf("\n%d views, %d outputs, %dx%d workspaces\n", scenario.views,
+           scenario.outputs, scenario.grid.x, scenario.grid.y);
+    bench_print_header("method");
+
+    /************************* Queries ************************/
+    bench_method("query_cursor_position", nullptr, n);
+    bench_method("query_output_ids", nullptr, n);
+    bench_method("query_active_output", nullptr, n);
+    bench_method("query_output_name", g_variant_new("(u)", output->id), n);
+    bench_method("query_output_manufacturer", g_variant_new("(u)", output->id), n);
+    bench_method("query_output_model", g_variant_new("(u)", output->id), n);
+    bench_method("query_output_serial", g_variant_new("(u)", output->id), n);
+    bench_method("query_output_workspace", g_variant_new("(u)", output->id), n);
+    bench_method("query_outputs", nullptr, n);
+    bench_method("query_workspace_summary", g_variant_new("(u)", output->id), n);
+    bench_method("query_workspace_grid_size", nullptr, n);
+    bench_method("query_xwayland_display", nullptr, n);
+    bench_method("query_worker_stats", nullptr, n);
+    bench_method("query_view_vector_ids", nullptr, n);
+    bench_method("query_view_vector_taskman_ids", nullptr, n);
+    /* minimized toplevels on the first output's workspace (1, 0) */
+    bench_method("query_views_filtered",
+                 g_variant_new("(uuuii)", 6, 6, output->id, 1, 0), n);
+    bench_method("query_views_by_pid", g_variant_new("(i)", view->pid), n);
+    bench_method("query_view_by_xid",
+                 g_variant_new("(u)", view->xwayland_window_id), n);
+    bench_method("query_views_by_app_id",
+                 g_variant_new("(s)", view->app_id.c_str()), n);
+    bench_method("query_views_matching", g_variant_new("(su)", "doc", 10), n);
+    bench_method("query_views_matching",
+                 g_variant_new("(su)", "document 12", 10), n);
+    bench_method("query_focus_history", g_variant_new("(u)", 10), n);
+    bench_method("query_app_groups", nullptr, n);
+    bench_method("query_view_app_id", g_variant_new("(u)", id), n);
+    bench_method("query_view_app_id_gtk_shell", g_variant_new("(u)", id), n);
+    bench_method("query_view_app_id_xwayland_net_wm_name",
+                 g_variant_new("(u)", id), n);
+    bench_method("query_view_title", g_variant_new("(u)", id), n);
+    bench_method("query_view_credentials", g_variant_new("(u)", id), n);
+    bench_method("query_view_active", g_variant_new("(u)", id), n);
+    bench_method("query_view_minimized", g_variant_new("(u)", id), n);
+    bench_method("query_view_maximized", g_variant_new("(u)", id), n);
+    bench_method("query_view_fullscreen", g_variant_new("(u)", id), n);
+    bench_method("query_view_output", g_variant_new("(u)", id), n);
+    bench_method("query_view_above", g_variant_new("(u)", id), n);
+    bench_method("query_view_workspaces", g_variant_new("(u)", id), n);
+    bench_method("query_view_group_leader", g_variant_new("(u)", id), n);
+    bench_method("query_view_group", g_variant_new("(u)", id), n);
+    bench_method("query_view_role", g_variant_new("(u)", id), n);
+    bench_method("query_view_attention", g_variant_new("(u)", id), n);
+    bench_method("query_view_xwayland_wid", g_variant_new("(u)", id), n);
+    bench_method("query_view_above_view", g_variant_new("(u)", id), n);
+    bench_method("query_view_below_view", g_variant_new("(u)", id), n);
+
+    /************************* Actions ************************/
+    bench_method("minimize_view", g_variant_new("(uu)", id, 2), n);
+    bench_method("maximize_view", g_variant_new("(uu)", id, 2), n);
+    bench_method("focus_view", g_variant_new("(uu)", id, 1), n);
+    bench_method("fullscreen_view", g_variant_new("(uu)", id, 2), n);
+    bench_method("change_view_above", g_variant_new("(uu)", id, 2), n);
+    bench_method("change_view_minimize_hint",
+                 g_variant_new("(uiiii)", id, 10, 10, 32, 32), n);
+    bench_method("update_view_minimize_hint", g_variant_new("(u)", id), n);
+    bench_method("change_workspace_view", g_variant_new("(uii)", id, 1, 1), n);
+    bench_method("change_workspace_output",
+                 g_variant_new("(uii)", output->id, 1, 0), n);
+    bench_method("shade_view", g_variant_new("(ud)", id, 0.5), n);
+    bench_method("bring_view_to_front", g_variant_new("(u)", id), n);
+    bench_method("restack_view_above", g_variant_new("(uu)", id, other->id), n);
+    bench_method("ensure_view_visible", g_variant_new("(u)", id), n);
+
+    /************************* Hooks ************************/
+    bench_print_header("hook");
+    bench_hook("on_view_added", n, [=] () { on_view_added(view); });
+    bench_hook("on_view_closed", n, [=] () { on_view_closed(view); });
+    bench_hook("on_view_app_id_changed", n,
+        [=] () { on_view_app_id_changed(view); });
+    bench_hook("on_view_title_changed", n,
+        [=] () { on_view_title_changed(view); });
+    bench_hook("on_view_geometry_changed", n,
+        [=] () { on_view_geometry_changed(view); });
+    bench_hook("on_view_tiled", n, [=] () { on_view_tiled(view, 15); });
+    bench_hook("on_view_maximized", n, [=] () { on_view_maximized(view, true); });
+    bench_hook("on_view_minimized", n, [=] () { on_view_minimized(view, true); });
+    bench_hook("on_view_fullscreen_changed", n,
+        [=] () { on_view_fullscreen_changed(view, true); });
+    bench_hook("on_view_role_changed", n, [=] () { on_view_role_changed(view); });
+    bench_hook("on_view_workspaces_changed", n,
+        [=] () { on_view_workspaces_changed(view); });
+    bench_hook("on_view_focus_changed", n, [=] ()
+    {
+        /* alternate so the hook never takes the "old focus" shortcut */
+        on_view_focus_changed(view);
+        on_view_focus_changed(other);
+    });
+    bench_hook("on_view_hints_changed", n,
+        [=] () { on_view_hints_changed(view); });
+    bench_hook("on_view_keep_above", n, [=] () { on_view_keep_above(view); });
+    bench_hook("on_view_parent_changed", n,
+        [=] () { on_view_parent_changed(view); });
+    bench_hook("on_view_output_moved", n,
+        [=] () { on_view_output_moved(view, 1, 2); });
+    bench_hook("on_output_workspace_changed", n,
+        [=] () { on_output_workspace_changed(output, 1, 0); });
+    bench_hook("on_pointer_button", n, [=] ()
+    {
+        on_pointer_button({100.0, 100.0}, 272, true, view);
+    });
+
+    dbus_core = nullptr;
+}
+
+int
+main (int argc, char* argv [])
+{
+    int max_views = (argc > 1) ? atoi(argv[1]) : 10000;
+
+    wf::log::initialize_logging(std::cerr, wf::log::LOG_LEVEL_ERROR,
+                                wf::log::LOG_COLOR_MODE_OFF);
+    /* hooks check it before doing any work */
+    geometry_signal = TRUE;
+
+    for (const bench_scenario_t& scenario : scenarios)
+    {
+        if (scenario.views > max_views) {
+            break;
+        }
+
+        bench_scenario(scenario);
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * bench_bus.hpp -- helpers for the benchmarks that talk to
+ * org.wayland.compositor over a real bus.
+ ********************************************************************/
+
+#ifndef BENCH_BUS_HPP
+#define BENCH_BUS_HPP
+
+#include <gio/gio.h>
+
+/***
+ * The service is started right before the benchmark,
+ * give it up to ten seconds to take the name.
+ ***/
+static inline bool
+bench_wait_for_service (GDBusConnection* connection)
+{
+    for (int i = 0; i < 100; i++)
+    {
+        GVariant* reply;
+        gboolean has_owner = FALSE;
+
+        reply = g_dbus_connection_call_sync(connection, "org.freedesktop.DBus",
+                                            "/org/freedesktop/DBus",
+                                            "org.freedesktop.DBus",
+                                            "NameHasOwner",
+                                            g_variant_new("(s)",
+                                                          "org.wayland.compositor"),
+                                            G_VARIANT_TYPE("(b)"),
+                                            G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+                                            nullptr);
+        if (reply) {
+            g_variant_get(reply, "(b)", &has_owner);
+            g_variant_unref(reply);
+        }
+
+        if (has_owner) {
+            return true;
+        }
+
+        g_usleep(100000);
+    }
+
+    return false;
+}
+
+/***
+ * A synchronous call on the compositor object, nullptr on error.
+ ***/
+static inline GVariant*
+bench_call (GDBusConnection* connection, const char* method_name,
+            GVariant* parameters, GError** error)
+{
+    return g_dbus_connection_call_sync(connection, "org.wayland.compositor",
+                                       "/org/wayland/compositor",
+                                       "org.wayland.compositor", method_name,
+                                       parameters, nullptr,
+                                       G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+                                       error);
+}
+
+#endif
@@ -0,0 +1,105 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * bench_util.hpp -- timing and allocation counting shared by the
+ * benchmarks.
+ ********************************************************************/
+
+#ifndef BENCH_UTIL_HPP
+#define BENCH_UTIL_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+/* bumped by the malloc family in alloc_counter.cpp */
+extern uint64_t bench_allocations;
+
+struct bench_result_t
+{
+    uint64_t iterations;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+static inline uint64_t
+bench_now_ns ()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/***
+ * Runs op until min_time_ns has passed (and at least
+ * min_iterations times), after a short warm-up.
+ ***/
+static inline bench_result_t
+bench_run (const std::function<void()>& op, uint64_t min_time_ns = 50000000,
+           uint64_t min_iterations = 10)
+{
+    bench_result_t result = {0, 0, 0};
+    uint64_t start;
+    uint64_t elapsed;
+    uint64_t allocations;
+    uint64_t batch = 1;
+
+    for (int i = 0; i < 3; i++)
+    {
+        op();
+    }
+
+    allocations = bench_allocations;
+    start = bench_now_ns();
+    do {
+        for (uint64_t i = 0; i < batch; i++)
+        {
+            op();
+        }
+
+        result.iterations += batch;
+        batch *= 2;
+        elapsed = bench_now_ns() - start;
+    } while (elapsed < min_time_ns || result.iterations < min_iterations);
+
+    result.ns_per_op = 1.0 * elapsed / result.iterations;
+    result.allocs_per_op = 1.0 * (bench_allocations - allocations) /
+        result.iterations;
+
+    return result;
+}
+
+/***
+ * The p-quantile (0..1) of an ascending sorted sample.
+ ***/
+static inline uint64_t
+bench_percentile (const std::vector<uint64_t>& sorted, double p)
+{
+    size_t index;
+
+    if (sorted.empty()) {
+        return 0;
+    }
+
+    index = (size_t)(p * (sorted.size() - 1) + 0.5);
+
+    return sorted[index];
+}
+
+static inline void
+bench_print_header (const char* label)
+{
+    printf("%-40s %8s %14s %12s %12s\n", label, "views", "iterations",
+           "ns/op", "allocs/op");
+}
+
+static inline void
+bench_print (const char* name, int views, const bench_result_t& result)
+{
+    printf("%-40s %8d %14llu %12.1f %12.1f\n", name, views,
+           (unsigned long long)result.iterations, result.ns_per_op,
+           result.allocs_per_op);
+}
+
+#endif
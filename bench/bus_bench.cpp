@@ -0,0 +1,234 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * bus_bench.cpp -- end to end latency of the interface over a real
+ * bus. N clients, each on its own connection and thread, replay a
+ * panel's workload (taskman id list, per view title / app_id /
+ * state queries, the occasional focus_view) while subscribed to
+ * all signals. Reports throughput and p50/p99 round trip per
+ * method. Meant to run against bench-standin, see
+ * run-bus-bench.sh.
+ *
+ * Usage: bench-bus [clients] [seconds]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_bus.hpp"
+#include "bench_util.hpp"
+
+/* per view queries of one panel refresh, a panel shows a few dozen */
+#define VIEWS_PER_ROUND 32
+
+struct bus_client_t
+{
+    std::map<std::string, std::vector<uint64_t>> latencies;
+    uint64_t signals = 0;
+    uint64_t errors  = 0;
+};
+
+static void
+count_signal (GDBusConnection* connection, const gchar* sender_name,
+              const gchar* object_path, const gchar* interface_name,
+              const gchar* signal_name, GVariant* parameters,
+              gpointer user_data)
+{
+    ((bus_client_t*)user_data)->signals++;
+}
+
+/***
+ * One synchronous call, its round trip goes into the client's
+ * samples for method_name. Returns the reply or nullptr.
+ ***/
+static GVariant*
+timed_call (GDBusConnection* connection, bus_client_t* client,
+            const char* method_name, GVariant* parameters)
+{
+    GError* error = nullptr;
+    GVariant* reply;
+    uint64_t start;
+
+    start = bench_now_ns();
+    reply = bench_call(connection, method_name, parameters, &error);
+    client->latencies[method_name].push_back(bench_now_ns() - start);
+
+    if (error) {
+        client->errors++;
+        g_error_free(error);
+    }
+
+    return reply;
+}
+
+static void
+run_client (const std::string& address, bus_client_t* client, uint64_t deadline)
+{
+    GMainContext* context = g_main_context_new();
+    GDBusConnection* connection;
+    GError* error = nullptr;
+    uint round = 0;
+
+    /* signals are dispatched to the thread default context */
+    g_main_context_push_thread_default(context);
+    connection = g_dbus_connection_new_for_address_sync(
+        address.c_str(),
+        (GDBusConnectionFlags)(G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                               G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+        nullptr, nullptr, &error);
+    if (!connection) {
+        g_printerr("bench-bus: %s\n", error->message);
+        g_error_free(error);
+        client->errors++;
+        g_main_context_pop_thread_default(context);
+        g_main_context_unref(context);
+
+        return;
+    }
+
+    g_dbus_connection_signal_subscribe(connection, "org.wayland.compositor",
+                                       "org.wayland.compositor", nullptr,
+                                       "/org/wayland/compositor", nullptr,
+                                       G_DBUS_SIGNAL_FLAGS_NONE, count_signal,
+                                       client, nullptr);
+
+    while (bench_now_ns() < deadline)
+    {
+        GVariant* reply;
+        GVariantIter* iter;
+        std::vector<uint> ids;
+        uint id;
+
+        reply = timed_call(connection, client, "query_view_vector_taskman_ids",
+                           nullptr);
+        if (reply) {
+            g_variant_get(reply, "(au)", &iter);
+            while (g_variant_iter_next(iter, "u", &id))
+            {
+                ids.push_back(id);
+            }
+
+            g_variant_iter_free(iter);
+            g_variant_unref(reply);
+        }
+
+        for (size_t i = 0; i < ids.size() && i < VIEWS_PER_ROUND; i++)
+        {
+            const char* methods [] = {"query_view_title", "query_view_app_id",
+                "query_view_minimized", "query_view_active"};
+
+            for (const char* method_name : methods)
+            {
+                reply = timed_call(connection, client, method_name,
+                                   g_variant_new("(u)", ids[i]));
+                if (reply) {
+                    g_variant_unref(reply);
+                }
+            }
+        }
+
+        if (!ids.empty() && (round % 10 == 0)) {
+            id = ids[g_random_int_range(0, ids.size())];
+            reply = timed_call(connection, client, "focus_view",
+                               g_variant_new("(uu)", id, 1));
+            if (reply) {
+                g_variant_unref(reply);
+            }
+        }
+
+        while (g_main_context_iteration(context, FALSE))
+        {}
+
+        round++;
+    }
+
+    g_dbus_connection_close_sync(connection, nullptr, nullptr);
+    g_object_unref(connection);
+    g_main_context_pop_thread_default(context);
+    g_main_context_unref(context);
+}
+
+int
+main (int argc, char* argv [])
+{
+    int client_count = (argc > 1) ? atoi(argv[1]) : 4;
+    int seconds = (argc > 2) ? atoi(argv[2]) : 5;
+    std::vector<bus_client_t> clients(client_count);
+    std::vector<std::thread> threads;
+    std::map<std::string, std::vector<uint64_t>> latencies;
+    GDBusConnection* connection;
+    GError* error = nullptr;
+    gchar* address;
+    uint64_t start;
+    uint64_t elapsed;
+    uint64_t calls   = 0;
+    uint64_t signals = 0;
+    uint64_t errors  = 0;
+
+    address = g_dbus_address_get_for_bus_sync(G_BUS_TYPE_SESSION, nullptr, &error);
+    if (!address) {
+        g_printerr("bench-bus: %s\n", error->message);
+        g_error_free(error);
+
+        return 1;
+    }
+
+    connection = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
+    if (!connection || !bench_wait_for_service(connection)) {
+        g_printerr("bench-bus: org.wayland.compositor is not on the bus\n");
+
+        return 1;
+    }
+
+    start = bench_now_ns();
+    for (bus_client_t& client : clients)
+    {
+        threads.emplace_back(run_client, std::string(address), &client,
+                             start + seconds * 1000000000ull);
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    elapsed = bench_now_ns() - start;
+
+    for (bus_client_t& client : clients)
+    {
+        for (auto& samples : client.latencies)
+        {
+            std::vector<uint64_t>& merged = latencies[samples.first];
+            merged.insert(merged.end(), samples.second.begin(),
+                          samples.second.end());
+            calls += samples.second.size();
+        }
+
+        signals += client.signals;
+        errors  += client.errors;
+    }
+
+    printf("%d clients, %.1f s, %llu calls, %.0f calls/s, %llu signals received, "
+           "%llu errors\n", client_count, elapsed / 1e9, (unsigned long long)calls,
+           calls / (elapsed / 1e9), (unsigned long long)signals,
+           (unsigned long long)errors);
+    printf("%-40s %10s %12s %12s\n", "method", "calls", "p50 us", "p99 us");
+    for (auto& samples : latencies)
+    {
+        std::sort(samples.second.begin(), samples.second.end());
+        printf("%-40s %10zu %12.1f %12.1f\n", samples.first.c_str(),
+               samples.second.size(),
+               bench_percentile(samples.second, 0.50) / 1e3,
+               bench_percentile(samples.second, 0.99) / 1e3);
+    }
+
+    g_free(address);
+    g_object_unref(connection);
+
+    return errors ? 1 : 0;
+}
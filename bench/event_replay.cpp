@@ -0,0 +1,378 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * event_replay.cpp -- feeds a compositor event trace (recorded by the
+ * plugin with WAYFIRE_DBUS_EVENT_TRACE set, see dbus_event_trace.hpp)
+ * back through the backend's hooks on top of the synthetic core.
+ * Before every hook the mock view or output gets the state it had
+ * when the event was recorded, so the hook does the same work it
+ * did in the session. Only the hook calls are timed.
+ *
+ * Under dbus-run-session the backend owns the name and the cost
+ * includes sending the signals, otherwise the signals are built
+ * and dropped.
+ *
+ * Reports per event type: count, mean / p50 / p99 ns and allocations.
+ *
+ * Usage: bench-event-replay <trace> [repeat] [geometry_signal]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <wayfire/util/log.hpp>
+
+#include "dbus_event_trace.hpp"
+#include "dbus_interface_backend.hpp"
+#include "bench_util.hpp"
+#include "mock_core.hpp"
+
+static const char* event_names [DBUS_EVENT_TYPE_COUNT] = {
+    "output_snapshot", "view_snapshot", "pointer_button", "tablet_button",
+    "view_added", "view_timeout", "view_closed", "view_app_id_changed",
+    "view_title_changed", "view_fullscreen_changed", "view_geometry_changed",
+    "view_tiled", "view_output_moved", "view_output_move_requested",
+    "view_role_changed", "view_workspaces_changed", "view_maximized",
+    "view_minimized", "view_focus_changed", "view_hints_changed",
+    "view_moving", "view_resizing", "view_keep_above",
+    "output_configuration_changed", "output_workspace_changed",
+    "output_added", "output_removed", "view_parent_changed",
+};
+
+struct event_stats_t
+{
+    std::vector<uint64_t> samples;
+    uint64_t allocations = 0;
+};
+
+static mock_output_t*
+replay_output (mock_core_t* core, uint32_t output_id)
+{
+    for (auto& output : core->outputs)
+    {
+        if (output->id == output_id) {
+            return output.get();
+        }
+    }
+
+    core->outputs.push_back(std::make_unique<mock_output_t> (output_id,
+        dbus_workspace_t{3, 3}));
+
+    return core->outputs.back().get();
+}
+
+static mock_output_t*
+apply_output_state (mock_core_t* core, const dbus_event_t& event)
+{
+    mock_output_t* output = replay_output(core, event.id);
+
+    output->name = event.output_name;
+    output->workspace = event.workspace;
+    if ((event.grid.x > 0) && (event.grid.y > 0)) {
+        output->grid = event.grid;
+    }
+
+    return output;
+}
+
+static mock_view_t*
+apply_view_state (mock_core_t* core, const dbus_event_t& event)
+{
+    mock_output_t* output = replay_output(core, event.output_id);
+    mock_view_t* view = core->find_view(event.id);
+
+    if (!view) {
+        view = core->add_view(output);
+        view->id = event.id;
+    }
+    else
+    if (view->output != output)
+    {
+        view->move_to_output(output);
+    }
+
+    view->role   = (dbus_view_role_t)event.role;
+    view->app_id = event.app_id;
+    view->title  = event.title;
+    view->geometry  = event.geometry;
+    view->mapped    = event.flags & DBUS_EVENT_MAPPED;
+    view->minimized = event.flags & DBUS_EVENT_MINIMIZED;
+    view->maximized = event.flags & DBUS_EVENT_MAXIMIZED;
+    view->fullscreened = event.flags & DBUS_EVENT_FULLSCREEN;
+    view->activated = event.flags & DBUS_EVENT_ACTIVATED;
+    view->above     = event.flags & DBUS_EVENT_ABOVE;
+    view->attention = event.flags & DBUS_EVENT_ATTENTION;
+    view->xwayland_window_id = event.xwayland_window_id;
+    view->pid = event.pid;
+    if (view->activated) {
+        core->cursor_focus = view;
+    }
+
+    return view;
+}
+
+static void
+call_hook (const dbus_event_t& event, mock_view_t* view, mock_output_t* output)
+{
+    switch (event.type)
+    {
+      case DBUS_EVENT_POINTER_BUTTON:
+        on_pointer_button({(double)event.args[0], (double)event.args[1]},
+                          event.args[2], event.args[3], view);
+        break;
+
+      case DBUS_EVENT_TABLET_BUTTON:
+        on_tablet_button();
+        break;
+
+      case DBUS_EVENT_VIEW_ADDED:
+        on_view_added(view);
+        break;
+
+      case DBUS_EVENT_VIEW_TIMEOUT:
+        on_view_timeout(view);
+        break;
+
+      case DBUS_EVENT_VIEW_CLOSED:
+        on_view_closed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_APP_ID_CHANGED:
+        on_view_app_id_changed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_TITLE_CHANGED:
+        on_view_title_changed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_FULLSCREEN_CHANGED:
+        on_view_fullscreen_changed(view, event.args[0]);
+        break;
+
+      case DBUS_EVENT_VIEW_GEOMETRY_CHANGED:
+        on_view_geometry_changed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_TILED:
+        on_view_tiled(view, event.args[0]);
+        break;
+
+      case DBUS_EVENT_VIEW_OUTPUT_MOVED:
+        on_view_output_moved(view, event.args[0], event.args[1]);
+        break;
+
+      case DBUS_EVENT_VIEW_OUTPUT_MOVE_REQUESTED:
+        on_view_output_move_requested(view, event.args[0], event.args[1]);
+        break;
+
+      case DBUS_EVENT_VIEW_ROLE_CHANGED:
+        on_view_role_changed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_WORKSPACES_CHANGED:
+        on_view_workspaces_changed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_MAXIMIZED:
+        on_view_maximized(view, event.args[0]);
+        break;
+
+      case DBUS_EVENT_VIEW_MINIMIZED:
+        on_view_minimized(view, event.args[0]);
+        break;
+
+      case DBUS_EVENT_VIEW_FOCUS_CHANGED:
+        on_view_focus_changed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_HINTS_CHANGED:
+        on_view_hints_changed(view);
+        break;
+
+      case DBUS_EVENT_VIEW_MOVING:
+        on_view_moving(view);
+        break;
+
+      case DBUS_EVENT_VIEW_RESIZING:
+        on_view_resizing(view);
+        break;
+
+      case DBUS_EVENT_VIEW_KEEP_ABOVE:
+        on_view_keep_above(view);
+        break;
+
+      case DBUS_EVENT_OUTPUT_CONFIGURATION_CHANGED:
+        on_output_configuration_changed(output);
+        break;
+
+      case DBUS_EVENT_OUTPUT_WORKSPACE_CHANGED:
+        on_output_workspace_changed(output, event.args[0], event.args[1]);
+        break;
+
+      case DBUS_EVENT_OUTPUT_ADDED:
+        on_output_added(output);
+        break;
+
+      case DBUS_EVENT_OUTPUT_REMOVED:
+        on_output_removed(output);
+        break;
+
+      case DBUS_EVENT_VIEW_PARENT_CHANGED:
+        on_view_parent_changed(view);
+        break;
+
+      default:
+        break;
+    }
+}
+
+static void
+replay (const std::vector<dbus_event_t>& events,
+        std::vector<event_stats_t>& stats)
+{
+    mock_core_t core(0, 0, {3, 3});
+
+    dbus_core = &core;
+    focused_view_id = 0;
+
+    for (const dbus_event_t& event : events)
+    {
+        mock_view_t* view     = nullptr;
+        mock_output_t* output = nullptr;
+        uint64_t allocations;
+        uint64_t start;
+
+        if ((event.type == DBUS_EVENT_OUTPUT_SNAPSHOT) ||
+            ((event.type >= DBUS_EVENT_OUTPUT_CONFIGURATION_CHANGED) &&
+             (event.type <= DBUS_EVENT_OUTPUT_REMOVED))) {
+            output = apply_output_state(&core, event);
+        }
+        else
+        if (event.id != 0)
+        {
+            view = apply_view_state(&core, event);
+        }
+
+        if ((event.type == DBUS_EVENT_VIEW_PARENT_CHANGED) && view) {
+            view->parent = core.find_view(event.args[0]);
+        }
+
+        if ((event.type == DBUS_EVENT_OUTPUT_SNAPSHOT) ||
+            (event.type == DBUS_EVENT_VIEW_SNAPSHOT)) {
+            continue;
+        }
+
+        allocations = bench_allocations;
+        start = bench_now_ns();
+        call_hook(event, view, output);
+        stats[event.type].samples.push_back(bench_now_ns() - start);
+        stats[event.type].allocations += bench_allocations - allocations;
+
+        if ((event.type == DBUS_EVENT_VIEW_CLOSED) && view) {
+            core.remove_view(view);
+        }
+    }
+
+    /* let the worker thread catch up before the next round */
+    if (dbus_connection) {
+        g_dbus_connection_flush_sync(dbus_connection, nullptr, nullptr);
+    }
+
+    dbus_core = nullptr;
+}
+
+int
+main (int argc, char* argv [])
+{
+    int repeat = (argc > 2) ? MAX(1, atoi(argv[2])) : 5;
+    std::vector<event_stats_t> stats(DBUS_EVENT_TYPE_COUNT);
+    std::vector<dbus_event_t> events;
+    dbus_event_t event = {};
+    gchar* address;
+    uint64_t total_ns = 0;
+    uint64_t total_events = 0;
+    FILE* file;
+
+    if (argc < 2) {
+        g_printerr("usage: bench-event-replay <trace> [repeat] [geometry_signal]\n");
+
+        return 1;
+    }
+
+    file = dbus_event_trace_open_read(argv[1]);
+    if (!file) {
+        g_printerr("bench-event-replay: %s is not an event trace\n", argv[1]);
+
+        return 1;
+    }
+
+    while (dbus_event_trace_read(file, &event))
+    {
+        events.push_back(event);
+    }
+
+    fclose(file);
+
+    wf::log::initialize_logging(std::cerr, wf::log::LOG_LEVEL_ERROR,
+                                wf::log::LOG_COLOR_MODE_OFF);
+    geometry_signal = (argc > 3) ? atoi(argv[3]) : TRUE;
+
+    address = g_dbus_address_get_for_bus_sync(G_BUS_TYPE_SESSION, nullptr,
+                                              nullptr);
+    if (address) {
+        acquire_bus();
+        while (!dbus_connection)
+        {
+            g_main_context_iteration(nullptr, TRUE);
+        }
+    }
+
+    printf("%zu events, %d rounds, %s\n", events.size(), repeat,
+           address ? "on the session bus" : "no bus, signals are dropped");
+    for (int i = 0; i < repeat; i++)
+    {
+        replay(events, stats);
+    }
+
+    printf("%-32s %10s %10s %10s %10s %10s\n", "event", "count", "mean ns",
+           "p50 ns", "p99 ns", "allocs");
+    for (int type = 0; type < DBUS_EVENT_TYPE_COUNT; type++)
+    {
+        std::vector<uint64_t>& samples = stats[type].samples;
+        uint64_t sum = 0;
+
+        if (samples.empty()) {
+            continue;
+        }
+
+        for (uint64_t sample : samples)
+        {
+            sum += sample;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        printf("%-32s %10zu %10.0f %10.0f %10.0f %10.1f\n", event_names[type],
+               samples.size(), 1.0 * sum / samples.size(),
+               1.0 * bench_percentile(samples, 0.50),
+               1.0 * bench_percentile(samples, 0.99),
+               1.0 * stats[type].allocations / samples.size());
+        total_ns += sum;
+        total_events += samples.size();
+    }
+
+    if (total_events) {
+        printf("%-32s %10llu %10.0f\n", "all", (unsigned long long)total_events,
+               1.0 * total_ns / total_events);
+    }
+
+    if (address) {
+        release_bus();
+        g_free(address);
+    }
+
+    return 0;
+}
@@ -0,0 +1,321 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * integration_bench.cpp -- measures the plugin inside a real
+ * (headless) wayfire, see run-integration-bench.sh.
+ * Times method round trips, which include wayfire's own costs
+ * (get_views_in_layer, move_to_workspace, transformers), and the
+ * latency from an action call to the signal it causes, e.g.
+ * minimize_view -> view_minimized_changed.
+ *
+ * Usage: bench-integration [views] [samples]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_bus.hpp"
+#include "bench_util.hpp"
+
+/* the frame time probe, never minimized or moved away */
+#define PROBE_APP_ID "bench-probe"
+
+struct pending_action_t
+{
+    const char* signal_name;
+    uint view_id;
+    uint64_t signal_ns;
+    bool replied;
+};
+
+static pending_action_t pending;
+
+static void
+signal_received (GDBusConnection* connection, const gchar* sender_name,
+                 const gchar* object_path, const gchar* interface_name,
+                 const gchar* signal_name, GVariant* parameters,
+                 gpointer user_data)
+{
+    GVariant* child;
+    uint view_id;
+
+    if (!pending.signal_name || pending.signal_ns ||
+        (g_strcmp0(signal_name, pending.signal_name) != 0)) {
+        return;
+    }
+
+    child   = g_variant_get_child_value(parameters, 0);
+    view_id = g_variant_get_uint32(child);
+    g_variant_unref(child);
+
+    if (view_id == pending.view_id) {
+        pending.signal_ns = bench_now_ns();
+    }
+}
+
+static void
+action_replied (GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    GVariant* reply;
+
+    reply = g_dbus_connection_call_finish((GDBusConnection*)source, result,
+                                          nullptr);
+    if (reply) {
+        g_variant_unref(reply);
+    }
+
+    pending.replied = true;
+}
+
+static std::vector<uint>
+get_view_ids (GDBusConnection* connection)
+{
+    std::vector<uint> ids;
+    GVariantIter* iter;
+    GVariant* reply;
+    uint id;
+
+    reply = bench_call(connection, "query_view_vector_taskman_ids", nullptr,
+                       nullptr);
+    if (!reply) {
+        return ids;
+    }
+
+    g_variant_get(reply, "(au)", &iter);
+    while (g_variant_iter_next(iter, "u", &id))
+    {
+        GVariant* app_id;
+        const gchar* value;
+
+        app_id = bench_call(connection, "query_view_app_id",
+                            g_variant_new("(u)", id), nullptr);
+        if (!app_id) {
+            continue;
+        }
+
+        g_variant_get(app_id, "(&s)", &value);
+        if (g_strcmp0(value, PROBE_APP_ID) != 0) {
+            ids.push_back(id);
+        }
+
+        g_variant_unref(app_id);
+    }
+
+    g_variant_iter_free(iter);
+    g_variant_unref(reply);
+
+    return ids;
+}
+
+static void
+print_samples (const char* name, std::vector<uint64_t>& samples,
+               uint64_t failures)
+{
+    std::sort(samples.begin(), samples.end());
+    printf("%-48s %8zu %12.1f %12.1f %8llu\n", name, samples.size(),
+           bench_percentile(samples, 0.50) / 1e3,
+           bench_percentile(samples, 0.99) / 1e3,
+           (unsigned long long)failures);
+}
+
+static void
+bench_round_trip (GDBusConnection* connection, const char* method_name,
+                  const std::vector<uint>& ids, int samples, bool with_id)
+{
+    std::vector<uint64_t> latencies;
+    uint64_t failures = 0;
+
+    for (int i = 0; i < samples; i++)
+    {
+        GVariant* parameters = nullptr;
+        GVariant* reply;
+        uint64_t start;
+
+        if (with_id) {
+            parameters = g_variant_new("(u)", ids[i % ids.size()]);
+        }
+
+        start = bench_now_ns();
+        reply = bench_call(connection, method_name, parameters, nullptr);
+        latencies.push_back(bench_now_ns() - start);
+
+        if (reply) {
+            g_variant_unref(reply);
+        }
+        else
+        {
+            failures++;
+        }
+    }
+
+    print_samples(method_name, latencies, failures);
+}
+
+/***
+ * Time from sending method_name until signal_name for the same
+ * view arrives. The reply is awaited too, so it cannot be taken
+ * for the next action's.
+ ***/
+static bool
+time_action (GDBusConnection* connection, const char* method_name,
+             GVariant* parameters, const char* signal_name, uint view_id,
+             uint64_t* latency)
+{
+    uint64_t start;
+    uint64_t timeout;
+
+    pending = {signal_name, view_id, 0, false};
+    start   = bench_now_ns();
+    timeout = start + 1000000000ull;
+    g_dbus_connection_call(connection, "org.wayland.compositor",
+                           "/org/wayland/compositor", "org.wayland.compositor",
+                           method_name, parameters, nullptr,
+                           G_DBUS_CALL_FLAGS_NONE, -1, nullptr, action_replied,
+                           nullptr);
+
+    while ((!pending.signal_ns || !pending.replied) && (bench_now_ns() < timeout))
+    {
+        g_main_context_iteration(nullptr, FALSE);
+    }
+
+    while (!pending.replied)
+    {
+        g_main_context_iteration(nullptr, TRUE);
+    }
+
+    pending.signal_name = nullptr;
+    if (!pending.signal_ns) {
+        return false;
+    }
+
+    *latency = pending.signal_ns - start;
+
+    return true;
+}
+
+static void
+bench_action (GDBusConnection* connection, const char* method_name,
+              const char* signal_name, const std::vector<uint>& ids, int samples)
+{
+    std::vector<uint64_t> latencies;
+    uint64_t failures = 0;
+    std::string name  = std::string(method_name) + " -> " + signal_name;
+
+    for (int i = 0; i < samples; i++)
+    {
+        uint view_id = ids[i % ids.size()];
+        uint64_t latency;
+
+        /* set then unset, every call changes state and emits */
+        for (uint action : {1u, 0u})
+        {
+            if (time_action(connection, method_name,
+                            g_variant_new("(uu)", view_id, action),
+                            signal_name, view_id, &latency)) {
+                latencies.push_back(latency);
+            }
+            else
+            {
+                failures++;
+            }
+        }
+    }
+
+    print_samples(name.c_str(), latencies, failures);
+}
+
+static void
+bench_focus (GDBusConnection* connection, const std::vector<uint>& ids,
+             int samples)
+{
+    std::vector<uint64_t> latencies;
+    uint64_t failures = 0;
+
+    /* alternate, focusing the focused view emits nothing */
+    for (int i = 0; i < 2 * samples; i++)
+    {
+        uint view_id = ids[i % 2];
+        uint64_t latency;
+
+        if (time_action(connection, "focus_view",
+                        g_variant_new("(uu)", view_id, 1),
+                        "view_focus_changed", view_id, &latency)) {
+            latencies.push_back(latency);
+        }
+        else
+        {
+            failures++;
+        }
+    }
+
+    print_samples("focus_view -> view_focus_changed", latencies, failures);
+}
+
+int
+main (int argc, char* argv [])
+{
+    int views   = (argc > 1) ? atoi(argv[1]) : 8;
+    int samples = (argc > 2) ? atoi(argv[2]) : 200;
+    GDBusConnection* connection;
+    std::vector<uint> ids;
+
+    connection = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
+    if (!connection || !bench_wait_for_service(connection)) {
+        g_printerr("bench-integration: org.wayland.compositor is not on the bus\n");
+
+        return 1;
+    }
+
+    /* the test clients map asynchronously */
+    for (int i = 0; i < 100; i++)
+    {
+        ids = get_view_ids(connection);
+        if ((int)ids.size() >= views) {
+            break;
+        }
+
+        g_usleep(100000);
+    }
+
+    if (ids.size() < 2) {
+        g_printerr("bench-integration: only %zu views mapped\n", ids.size());
+
+        return 1;
+    }
+
+    g_dbus_connection_signal_subscribe(connection, "org.wayland.compositor",
+                                       "org.wayland.compositor", nullptr,
+                                       "/org/wayland/compositor", nullptr,
+                                       G_DBUS_SIGNAL_FLAGS_NONE, signal_received,
+                                       nullptr, nullptr);
+
+    printf("%zu views, %d samples\n", ids.size(), samples);
+    printf("%-48s %8s %12s %12s %8s\n", "round trip", "samples", "p50 us",
+           "p99 us", "failed");
+    bench_round_trip(connection, "query_view_vector_ids", ids, samples, false);
+    bench_round_trip(connection, "query_view_vector_taskman_ids", ids, samples,
+                     false);
+    bench_round_trip(connection, "query_output_ids", ids, samples, false);
+    bench_round_trip(connection, "query_view_title", ids, samples, true);
+    bench_round_trip(connection, "query_view_workspaces", ids, samples, true);
+    bench_round_trip(connection, "query_view_above_view", ids, samples, true);
+    bench_round_trip(connection, "query_view_credentials", ids, samples, true);
+
+    printf("%-48s %8s %12s %12s %8s\n", "action -> signal", "samples", "p50 us",
+           "p99 us", "failed");
+    bench_action(connection, "minimize_view", "view_minimized_changed", ids,
+                 samples);
+    bench_action(connection, "maximize_view", "view_maximized_changed", ids,
+                 samples);
+    bench_action(connection, "fullscreen_view", "view_fullscreen_changed", ids,
+                 samples);
+    bench_focus(connection, ids, samples);
+
+    g_object_unref(connection);
+
+    return 0;
+}
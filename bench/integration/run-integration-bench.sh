@@ -0,0 +1,69 @@
+#!/bin/sh
+# Runs the plugin in a headless wayfire and measures it from outside.
+# Meant to be started under dbus-run-session so the bus is private.
+# Needs no GPU: wlroots' headless backend with the pixman renderer.
+#
+# Usage: run-integration-bench.sh <wayfire> <dbus_interface.so> <source dir>
+#            <bench-client> <bench-integration> <bench-bus> [views] [load seconds]
+
+wayfire="$1"
+plugin="$2"
+source_dir="$3"
+client="$4"
+integration="$5"
+load="$6"
+views="${7:-8}"
+seconds="${8:-5}"
+
+work_dir=$(mktemp -d)
+trap 'kill $client_pids $wayfire_pid 2>/dev/null; rm -rf "$work_dir"' EXIT
+
+export XDG_RUNTIME_DIR="$work_dir"
+export WLR_BACKENDS=headless
+export WLR_RENDERER=pixman
+export WLR_LIBINPUT_NO_DEVICES=1
+export WLR_HEADLESS_OUTPUTS=1
+export WAYFIRE_PLUGIN_PATH=$(dirname "$plugin")
+export WAYFIRE_PLUGIN_XML_PATH="$source_dir"
+export GSETTINGS_SCHEMA_DIR="$work_dir"
+glib-compile-schemas --targetdir="$work_dir" "$source_dir" || exit 1
+
+"$wayfire" -c "$source_dir/bench/integration/wayfire.ini" \
+    > "$work_dir/wayfire.log" 2>&1 &
+wayfire_pid=$!
+
+for i in $(seq 100); do
+    socket=$(ls "$work_dir" | grep '^wayland-[0-9]*$' | head -n 1)
+    [ -n "$socket" ] && break
+    sleep 0.1
+done
+
+if [ -z "$socket" ]; then
+    echo "wayfire did not start:"
+    cat "$work_dir/wayfire.log"
+    exit 1
+fi
+
+export WAYLAND_DISPLAY="$socket"
+
+"$client" bench-probe > "$work_dir/probe.log" &
+probe_pid=$!
+client_pids="$probe_pid"
+for i in $(seq "$views"); do
+    "$client" "bench-client-$i" "Bench client $i" &
+    client_pids="$client_pids $!"
+done
+
+"$integration" "$views" || exit 1
+
+# compositor frame time as seen by the probe, idle and under bus load
+kill -USR1 "$probe_pid"
+sleep "$seconds"
+kill -USR1 "$probe_pid"
+"$load" 8 "$seconds" > "$work_dir/load.log"
+kill -USR1 "$probe_pid"
+sleep 0.5
+
+echo "frame time, idle:        $(sed -n 2p "$work_dir/probe.log")"
+echo "frame time, under load:  $(sed -n 3p "$work_dir/probe.log")"
+echo "load: $(head -n 1 "$work_dir/load.log")"
@@ -0,0 +1,299 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * test_client.cpp -- a minimal xdg-shell client for the integration
+ * benchmark. It maps one shm toplevel and commits on every frame
+ * callback, so the compositor keeps repainting it. The interval
+ * between frame callbacks is the compositor's frame time as a
+ * client sees it; on SIGUSR1 the p50/p99/max of the intervals since
+ * the last SIGUSR1 are printed to stdout.
+ *
+ * Usage: bench-client [app_id] [title]
+ ********************************************************************/
+
+extern "C" {
+#include <sys/mman.h>
+#include <unistd.h>
+};
+
+#include <wayland-client.h>
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "xdg-shell-client-protocol.h"
+
+#define WIDTH 320
+#define HEIGHT 240
+
+static struct wl_compositor* compositor;
+static struct wl_shm* shm;
+static struct xdg_wm_base* wm_base;
+static struct wl_surface* surface;
+static struct wl_buffer* buffer;
+static bool configured = false;
+
+static volatile sig_atomic_t running = 1;
+static volatile sig_atomic_t report_requested = 0;
+static std::vector<uint64_t> frame_intervals;
+static uint64_t last_frame_ns = 0;
+
+static uint64_t
+now_ns ()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void
+report_frames ()
+{
+    std::vector<uint64_t> sorted = frame_intervals;
+
+    frame_intervals.clear();
+    if (sorted.empty()) {
+        printf("frames 0\n");
+        fflush(stdout);
+
+        return;
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+    printf("frames %zu p50 %.2f ms p99 %.2f ms max %.2f ms\n", sorted.size(),
+           sorted[sorted.size() / 2] / 1e6,
+           sorted[(size_t)(0.99 * (sorted.size() - 1))] / 1e6,
+           sorted.back() / 1e6);
+    fflush(stdout);
+}
+
+static struct wl_buffer*
+create_buffer ()
+{
+    struct wl_shm_pool* pool;
+    struct wl_buffer* result;
+    int stride = WIDTH * 4;
+    int size   = stride * HEIGHT;
+    uint32_t* pixels;
+    int fd;
+
+    fd = memfd_create("bench-client", MFD_CLOEXEC);
+    if ((fd < 0) || (ftruncate(fd, size) < 0)) {
+        return nullptr;
+    }
+
+    pixels = (uint32_t*)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                             fd, 0);
+    if (pixels == MAP_FAILED) {
+        close(fd);
+
+        return nullptr;
+    }
+
+    for (int i = 0; i < WIDTH * HEIGHT; i++)
+    {
+        pixels[i] = 0xff336699;
+    }
+
+    pool   = wl_shm_create_pool(shm, fd, size);
+    result = wl_shm_pool_create_buffer(pool, 0, WIDTH, HEIGHT, stride,
+                                       WL_SHM_FORMAT_ARGB8888);
+    wl_shm_pool_destroy(pool);
+    munmap(pixels, size);
+    close(fd);
+
+    return result;
+}
+
+static void redraw ();
+
+static void
+frame_done (void* data, struct wl_callback* callback, uint32_t time)
+{
+    uint64_t now = now_ns();
+
+    wl_callback_destroy(callback);
+    if (last_frame_ns) {
+        frame_intervals.push_back(now - last_frame_ns);
+    }
+
+    last_frame_ns = now;
+    redraw();
+}
+
+static const struct wl_callback_listener frame_listener = {
+    frame_done,
+};
+
+static void
+redraw ()
+{
+    struct wl_callback* callback;
+
+    callback = wl_surface_frame(surface);
+    wl_callback_add_listener(callback, &frame_listener, nullptr);
+    wl_surface_attach(surface, buffer, 0, 0);
+    wl_surface_damage(surface, 0, 0, WIDTH, HEIGHT);
+    wl_surface_commit(surface);
+}
+
+/************************* xdg-shell ************************/
+static void
+wm_base_ping (void* data, struct xdg_wm_base* wm_base, uint32_t serial)
+{
+    xdg_wm_base_pong(wm_base, serial);
+}
+
+static const struct xdg_wm_base_listener wm_base_listener = {
+    wm_base_ping,
+};
+
+static void
+xdg_surface_configure (void* data, struct xdg_surface* xdg_surface,
+                       uint32_t serial)
+{
+    xdg_surface_ack_configure(xdg_surface, serial);
+    if (!configured) {
+        configured = true;
+        redraw();
+    }
+}
+
+static const struct xdg_surface_listener xdg_surface_listener = {
+    xdg_surface_configure,
+};
+
+static void
+toplevel_configure (void* data, struct xdg_toplevel* toplevel, int32_t width,
+                    int32_t height, struct wl_array* states)
+{}
+
+static void
+toplevel_close (void* data, struct xdg_toplevel* toplevel)
+{
+    running = 0;
+}
+
+static const struct xdg_toplevel_listener toplevel_listener = {
+    toplevel_configure,
+    toplevel_close,
+};
+
+/************************* Globals ************************/
+static void
+registry_global (void* data, struct wl_registry* registry, uint32_t name,
+                 const char* interface, uint32_t version)
+{
+    /* version 1 everywhere, so no event is sent that we don't listen to */
+    if (strcmp(interface, wl_compositor_interface.name) == 0) {
+        compositor = (struct wl_compositor*)wl_registry_bind(registry, name,
+            &wl_compositor_interface, 1);
+    }
+    else
+    if (strcmp(interface, wl_shm_interface.name) == 0)
+    {
+        shm = (struct wl_shm*)wl_registry_bind(registry, name,
+            &wl_shm_interface, 1);
+    }
+    else
+    if (strcmp(interface, xdg_wm_base_interface.name) == 0)
+    {
+        wm_base = (struct xdg_wm_base*)wl_registry_bind(registry, name,
+            &xdg_wm_base_interface, 1);
+        xdg_wm_base_add_listener(wm_base, &wm_base_listener, nullptr);
+    }
+}
+
+static void
+registry_global_remove (void* data, struct wl_registry* registry, uint32_t name)
+{}
+
+static const struct wl_registry_listener registry_listener = {
+    registry_global,
+    registry_global_remove,
+};
+
+static void
+on_signal (int signal_number)
+{
+    if (signal_number == SIGUSR1) {
+        report_requested = 1;
+    }
+    else
+    {
+        running = 0;
+    }
+}
+
+int
+main (int argc, char* argv [])
+{
+    const char* app_id = (argc > 1) ? argv[1] : "bench-client";
+    const char* title  = (argc > 2) ? argv[2] : app_id;
+    struct wl_display* display;
+    struct wl_registry* registry;
+    struct xdg_surface* xdg_surface;
+    struct xdg_toplevel* toplevel;
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    sigaction(SIGUSR1, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+
+    display = wl_display_connect(nullptr);
+    if (!display) {
+        fprintf(stderr, "bench-client: cannot connect to the compositor\n");
+
+        return 1;
+    }
+
+    registry = wl_display_get_registry(display);
+    wl_registry_add_listener(registry, &registry_listener, nullptr);
+    wl_display_roundtrip(display);
+    if (!compositor || !shm || !wm_base) {
+        fprintf(stderr, "bench-client: missing globals\n");
+
+        return 1;
+    }
+
+    buffer = create_buffer();
+    if (!buffer) {
+        fprintf(stderr, "bench-client: cannot create a shm buffer\n");
+
+        return 1;
+    }
+
+    surface     = wl_compositor_create_surface(compositor);
+    xdg_surface = xdg_wm_base_get_xdg_surface(wm_base, surface);
+    xdg_surface_add_listener(xdg_surface, &xdg_surface_listener, nullptr);
+    toplevel = xdg_surface_get_toplevel(xdg_surface);
+    xdg_toplevel_add_listener(toplevel, &toplevel_listener, nullptr);
+    xdg_toplevel_set_app_id(toplevel, app_id);
+    xdg_toplevel_set_title(toplevel, title);
+    wl_surface_commit(surface);
+
+    /* frame callbacks wake us up every refresh, signals are seen in time */
+    while (running && (wl_display_dispatch(display) != -1))
+    {
+        if (report_requested) {
+            report_requested = 0;
+            report_frames();
+        }
+    }
+
+    xdg_toplevel_destroy(toplevel);
+    xdg_surface_destroy(xdg_surface);
+    wl_surface_destroy(surface);
+    wl_buffer_destroy(buffer);
+    wl_display_disconnect(display);
+
+    return 0;
+}
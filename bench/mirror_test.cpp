@@ -0,0 +1,247 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * mirror_test.cpp -- checks wfdbus_mirror.hpp against bench-standin
+ * on a private bus: sync() has to fill in what the service answers
+ * to direct queries, view_added / view_closed / view_title_changed
+ * have to bring the mirror up to date without another sync(). The
+ * stand-in is started here and driven over its stdin.
+ * Meant to be started under dbus-run-session.
+ *
+ * Usage: test-mirror <bench-standin>
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstdio>
+#include <string>
+
+#include "bench_bus.hpp"
+#include "wfdbus_mirror.hpp"
+
+/* how long the mirror gets to catch up with a change */
+#define MIRROR_TEST_TIMEOUT_US (5 * G_USEC_PER_SEC)
+
+static int failures = 0;
+
+static void
+check (bool passed, const std::string& what)
+{
+    printf("%s: %s\n", passed ? "PASS" : "FAIL", what.c_str());
+    failures += passed ? 0 : 1;
+}
+
+static std::string
+query_string (GDBusConnection* connection, const char* method_name,
+              guint view_id)
+{
+    GVariant* reply;
+    const gchar* value;
+    std::string result;
+
+    reply = bench_call(connection, method_name, g_variant_new("(u)", view_id),
+                       nullptr);
+    if (!reply) {
+        return "";
+    }
+
+    g_variant_get(reply, "(&s)", &value);
+    result = value;
+    g_variant_unref(reply);
+
+    return result;
+}
+
+static bool
+query_ids (GDBusConnection* connection, const char* method_name,
+           std::vector<guint>* ids)
+{
+    GVariant* reply;
+    GVariantIter* iter;
+    guint id;
+
+    reply = bench_call(connection, method_name, nullptr, nullptr);
+    if (!reply) {
+        return false;
+    }
+
+    g_variant_get(reply, "(au)", &iter);
+    while (g_variant_iter_next(iter, "u", &id))
+    {
+        ids->push_back(id);
+    }
+
+    g_variant_iter_free(iter);
+    g_variant_unref(reply);
+
+    return true;
+}
+
+/***
+ * Iterates the main context until done returns true,
+ * false if it doesn't within MIRROR_TEST_TIMEOUT_US.
+ ***/
+static bool
+wait_for (const std::function<bool()>& done)
+{
+    gint64 deadline = g_get_monotonic_time() + MIRROR_TEST_TIMEOUT_US;
+
+    while (!done())
+    {
+        if (g_get_monotonic_time() > deadline) {
+            return false;
+        }
+
+        if (!g_main_context_iteration(nullptr, FALSE)) {
+            g_usleep(1000);
+        }
+    }
+
+    return true;
+}
+
+static void
+send_command (int fd, const std::string& command)
+{
+    std::string line = command + "\n";
+
+    if (write(fd, line.c_str(), line.size()) != (ssize_t)line.size()) {
+        g_printerr("test-mirror: cannot drive the stand-in\n");
+    }
+}
+
+static void
+test_sync (GDBusConnection* connection, wfdbus::mirror_t& mirror)
+{
+    std::vector<guint> ids;
+    bool same_titles  = true;
+    bool same_app_ids = true;
+
+    check(mirror.sync(), "sync() reaches the service");
+    check(query_ids(connection, "query_view_vector_taskman_ids", &ids) &&
+          (ids.size() == mirror.get_views().size()),
+          "sync() mirrors every mapped toplevel");
+
+    for (guint view_id : ids)
+    {
+        const wfdbus::view_t* view = mirror.find_view(view_id);
+
+        if (!view) {
+            same_titles = same_app_ids = false;
+            continue;
+        }
+
+        same_titles &= view->title ==
+            query_string(connection, "query_view_title", view_id);
+        same_app_ids &= view->app_id ==
+            query_string(connection, "query_view_app_id", view_id);
+    }
+
+    check(same_titles, "sync() titles match query_view_title");
+    check(same_app_ids, "sync() app ids match query_view_app_id");
+
+    ids.clear();
+    check(query_ids(connection, "query_output_ids", &ids) &&
+          (ids.size() == mirror.get_outputs().size()),
+          "sync() mirrors every output");
+}
+
+static void
+test_signals (wfdbus::mirror_t& mirror, int control)
+{
+    const wfdbus::view_t* view;
+    uint64_t calls;
+    guint added = 0;
+
+    mirror.set_signal_callback([&] (const gchar* signal_name, guint id,
+                                    GVariant* parameters)
+    {
+        if (g_strcmp0(signal_name, "view_added") == 0) {
+            added = id;
+        }
+    });
+
+    send_command(control, "map");
+    check(wait_for([&] ()
+    {
+        view = added ? mirror.find_view(added) : nullptr;
+
+        return view && (view->title == "Mapped " + std::to_string(added));
+    }), "view_added brings the new view in with its title");
+    if (!added) {
+        return;
+    }
+
+    view = mirror.find_view(added);
+    check(view && (view->app_id == "org.example.mapped") &&
+          (view->role == wfdbus::VIEW_ROLE_TOPLEVEL),
+          "view_added fetches the new view's app id and role");
+
+    calls = mirror.get_call_count();
+    send_command(control, "title " + std::to_string(added));
+    check(wait_for([&] ()
+    {
+        view = mirror.find_view(added);
+
+        return view && (view->title == "Retitled " + std::to_string(added));
+    }), "view_title_changed updates the title");
+    check(mirror.get_call_count() == calls,
+          "view_title_changed needs no call");
+
+    send_command(control, "close " + std::to_string(added));
+    check(wait_for([&] ()
+    {
+        return mirror.find_view(added) == nullptr;
+    }), "view_closed drops the view");
+
+    check(mirror.get_error_count() == 0, "no call failed");
+}
+
+int
+main (int argc, char* argv [])
+{
+    GDBusConnection* connection;
+    GError* error = nullptr;
+    GPid standin;
+    int control;
+
+    if (argc < 2) {
+        g_printerr("usage: test-mirror <bench-standin>\n");
+
+        return 2;
+    }
+
+    /* a few views, no title flapping, the test changes titles itself */
+    gchar* standin_argv [] = {argv[1], (gchar*)"8", (gchar*)"0", nullptr};
+    if (!g_spawn_async_with_pipes(nullptr, standin_argv, nullptr,
+                                  G_SPAWN_DEFAULT, nullptr, nullptr, &standin,
+                                  &control, nullptr, nullptr, &error)) {
+        g_printerr("test-mirror: %s\n", error->message);
+        g_error_free(error);
+
+        return 2;
+    }
+
+    connection = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
+    if (!connection || !bench_wait_for_service(connection)) {
+        g_printerr("test-mirror: org.wayland.compositor is not on the bus\n");
+        kill(standin, SIGTERM);
+
+        return 2;
+    }
+
+    {
+        wfdbus::mirror_t mirror(connection);
+
+        test_sync(connection, mirror);
+        test_signals(mirror, control);
+    }
+
+    close(control);
+    kill(standin, SIGTERM);
+    g_spawn_close_pid(standin);
+    g_object_unref(connection);
+
+    return failures ? 1 : 0;
+}
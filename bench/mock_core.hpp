@@ -0,0 +1,609 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * mock_core.hpp -- a synthetic dbus_core_t for the benchmarks.
+ * It models just enough of the compositor (views, outputs,
+ * workspace grids, stacking) for the backend to do the same
+ * amount of work it does against wayfire.
+ ********************************************************************/
+
+#ifndef MOCK_CORE_HPP
+#define MOCK_CORE_HPP
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+class mock_output_t : public dbus_output_t
+{
+  public:
+    uint32_t id;
+    std::string name;
+    dbus_workspace_t workspace = {0, 0};
+    dbus_workspace_t grid;
+    int width  = 1920;
+    int height = 1080;
+    /* topmost first */
+    std::vector<dbus_view_t*> stack;
+
+    mock_output_t(uint32_t id, dbus_workspace_t grid) : id(id), grid(grid)
+    {
+        name = "HEADLESS-" + std::to_string(id);
+    }
+
+    uint32_t
+    get_id () override
+    {
+        return id;
+    }
+
+    std::string
+    get_name () override
+    {
+        return name;
+    }
+
+    const char*
+    get_make () override
+    {
+        return "wayfire";
+    }
+
+    const char*
+    get_model () override
+    {
+        return "headless";
+    }
+
+    const char*
+    get_serial () override
+    {
+        return nullptr;
+    }
+
+    dbus_geometry_t
+    get_layout_geometry () override
+    {
+        /* side by side */
+        return {(int)(id - 1) * width, 0, width, height};
+    }
+
+    double
+    get_scale () override
+    {
+        return 1.0;
+    }
+
+    uint32_t
+    get_transform () override
+    {
+        return 0;
+    }
+
+    dbus_workspace_t
+    get_workspace () override
+    {
+        return workspace;
+    }
+
+    dbus_workspace_t
+    get_workspace_grid_size () override
+    {
+        return grid;
+    }
+
+    void
+    request_workspace (int x, int y) override
+    {
+        workspace = {x, y};
+    }
+
+    dbus_point_t
+    get_cursor_position () override
+    {
+        return {width / 2.0, height / 2.0};
+    }
+};
+
+class mock_view_t : public dbus_view_t
+{
+  public:
+    uint32_t id;
+    std::string app_id;
+    std::string title;
+    dbus_view_role_t role = DBUS_VIEW_ROLE_TOPLEVEL;
+    bool mapped     = true;
+    bool minimized  = false;
+    bool maximized  = false;
+    bool fullscreened = false;
+    bool activated  = false;
+    bool above      = false;
+    bool attention  = false;
+    bool modal      = false;
+    mock_view_t* parent = nullptr;
+    mock_output_t* output = nullptr;
+    /* relative to the output's current workspace */
+    dbus_geometry_t geometry = {0, 0, 800, 600};
+    dbus_geometry_t minimize_hint = {0, 0, 0, 0};
+    uint32_t xwayland_window_id = 0;
+    double alpha = 1.0;
+    pid_t pid = 0;
+    /* lets a driver play the compositor's part of a focus change */
+    std::function<void(mock_view_t*)> on_focus_request;
+
+    uint32_t
+    get_id () override
+    {
+        return id;
+    }
+
+    std::string
+    get_app_id () override
+    {
+        return app_id;
+    }
+
+    std::string
+    get_gtk_shell_app_id () override
+    {
+        return app_id;
+    }
+
+    std::string
+    get_title () override
+    {
+        return title;
+    }
+
+    dbus_view_role_t
+    get_role () override
+    {
+        return role;
+    }
+
+    bool
+    is_modal_dialog () override
+    {
+        return modal;
+    }
+
+    bool
+    is_mapped () override
+    {
+        return mapped;
+    }
+
+    bool
+    is_toplevel () override
+    {
+        return mapped && (role == DBUS_VIEW_ROLE_TOPLEVEL) && output;
+    }
+
+    dbus_view_t*
+    get_parent () override
+    {
+        return parent;
+    }
+
+    bool
+    is_minimized () override
+    {
+        return minimized;
+    }
+
+    bool
+    is_maximized () override
+    {
+        return maximized;
+    }
+
+    bool
+    is_fullscreen () override
+    {
+        return fullscreened;
+    }
+
+    bool
+    is_activated () override
+    {
+        return activated;
+    }
+
+    bool
+    is_above () override
+    {
+        return above;
+    }
+
+    bool
+    demands_attention () override
+    {
+        return attention;
+    }
+
+    void
+    clear_attention () override
+    {
+        attention = false;
+    }
+
+    dbus_output_t*
+    get_output () override
+    {
+        return output;
+    }
+
+    dbus_geometry_t
+    get_output_geometry () override
+    {
+        return geometry;
+    }
+
+    std::vector<dbus_workspace_t>
+    get_workspaces () override
+    {
+        std::vector<dbus_workspace_t> result;
+
+        if (!output) {
+            return result;
+        }
+
+        for (int x = 0; x < output->grid.x; x++)
+        {
+            for (int y = 0; y < output->grid.y; y++)
+            {
+                int ws_x = (x - output->workspace.x) * output->width;
+                int ws_y = (y - output->workspace.y) * output->height;
+                int x1 = std::max(geometry.x, ws_x);
+                int y1 = std::max(geometry.y, ws_y);
+                int x2 = std::min(geometry.x + geometry.width, ws_x + output->width);
+                int y2 = std::min(geometry.y + geometry.height, ws_y + output->height);
+                double area;
+
+                if ((x2 <= x1) || (y2 <= y1)) {
+                    continue;
+                }
+
+                area = 1.0 * (x2 - x1) * (y2 - y1);
+                area /= 1.0 * geometry.width * geometry.height;
+                if (area > 0.1) {
+                    result.push_back({x, y});
+                }
+            }
+        }
+
+        return result;
+    }
+
+    uint32_t
+    get_xwayland_window_id () override
+    {
+        return xwayland_window_id;
+    }
+
+    std::string
+    get_xwayland_instance () override
+    {
+        return xwayland_window_id ? app_id : "";
+    }
+
+    bool
+    get_xwayland_size (uint32_t* width, uint32_t* height) override
+    {
+        if (!xwayland_window_id) {
+            return false;
+        }
+
+        *width = geometry.width;
+        *height = geometry.height;
+
+        return true;
+    }
+
+    void
+    get_client_credentials (pid_t* pid, uid_t* uid, gid_t* gid) override
+    {
+        *pid = this->pid;
+        *uid = 1000;
+        *gid = 1000;
+    }
+
+    /************************* Actions ************************/
+    void
+    minimize (bool state) override
+    {
+        minimized = state;
+    }
+
+    void
+    maximize (bool state) override
+    {
+        maximized = state;
+    }
+
+    void
+    fullscreen (bool state) override
+    {
+        fullscreened = state;
+    }
+
+    void
+    set_activated (bool state) override
+    {
+        activated = state;
+    }
+
+    void
+    focus_request () override
+    {
+        bring_to_front();
+        if (on_focus_request) {
+            on_focus_request(this);
+        }
+    }
+
+    void
+    close () override
+    {}
+
+    void
+    set_minimize_hint (dbus_geometry_t hint) override
+    {
+        minimize_hint = hint;
+    }
+
+    void
+    toggle_above () override
+    {
+        above = !above;
+    }
+
+    void
+    ensure_visible () override
+    {}
+
+    void
+    bring_to_front () override
+    {
+        std::vector<dbus_view_t*>& stack = output->stack;
+        auto it = std::find(stack.begin(), stack.end(), this);
+
+        if (it != stack.end()) {
+            std::rotate(stack.begin(), it, it + 1);
+        }
+    }
+
+    void
+    restack (dbus_view_t* related_view, bool above) override
+    {
+        std::vector<dbus_view_t*>& stack = output->stack;
+        auto it = std::find(stack.begin(), stack.end(), this);
+
+        if (it == stack.end()) {
+            return;
+        }
+
+        stack.erase(it);
+        it = std::find(stack.begin(), stack.end(), related_view);
+        if (!above && (it != stack.end())) {
+            ++it;
+        }
+
+        stack.insert(it, this);
+    }
+
+    void
+    set_alpha (double alpha) override
+    {
+        this->alpha = alpha;
+    }
+
+    void
+    move_to_output (dbus_output_t* output) override
+    {
+        std::vector<dbus_view_t*>& stack = this->output->stack;
+
+        stack.erase(std::remove(stack.begin(), stack.end(), this), stack.end());
+        this->output = static_cast<mock_output_t*> (output);
+        this->output->stack.insert(this->output->stack.begin(), this);
+    }
+
+    void
+    move_to_workspace (int x, int y) override
+    {
+        geometry.x = (x - output->workspace.x) * output->width + 100;
+        geometry.y = (y - output->workspace.y) * output->height + 100;
+    }
+};
+
+class mock_core_t : public dbus_core_t
+{
+  public:
+    std::vector<std::unique_ptr<mock_view_t>> views;
+    std::vector<std::unique_ptr<mock_output_t>> outputs;
+    mock_view_t* cursor_focus = nullptr;
+    uint32_t next_view_id = 1;
+
+    /***
+     * A desktop-like population: mostly toplevels spread over
+     * all outputs and workspaces, one panel and one background
+     * per output and a dialog for every tenth toplevel.
+     ***/
+    mock_core_t(int view_count, int output_count, dbus_workspace_t grid)
+    {
+        for (int i = 0; i < output_count; i++)
+        {
+            outputs.push_back(std::make_unique<mock_output_t> (i + 1, grid));
+        }
+
+        for (int i = 0; i < view_count; i++)
+        {
+            mock_output_t* output = outputs[i % output_count].get();
+            mock_view_t* view = add_view(output);
+
+            if (i < 2 * output_count) {
+                view->role = DBUS_VIEW_ROLE_DESKTOP_ENVIRONMENT;
+                view->app_id = (i < output_count) ? "wf-panel" : "wf-background";
+                view->title = view->app_id;
+                continue;
+            }
+
+            view->app_id = "org.example.app" + std::to_string(i % 40);
+            view->title = "Document " + std::to_string(i) +
+                " - Some Reasonably Long Application Title";
+            view->pid = 1000 + i % 40;
+            view->minimized = (i % 7 == 0);
+            view->maximized = (i % 5 == 0);
+            view->xwayland_window_id = (i % 4 == 0) ? 0x200000 + i : 0;
+
+            int ws = (i / output_count) % (grid.x * grid.y);
+            view->geometry = {(ws % grid.x) * output->width + 100,
+                (ws / grid.x) * output->height + 100, 800, 600};
+
+            if ((i % 10 == 0) && (i > 2 * output_count)) {
+                view->parent = views[i - 1].get();
+                view->modal = true;
+            }
+        }
+
+        cursor_focus = views.empty() ? nullptr : views.back().get();
+        if (cursor_focus) {
+            cursor_focus->activated = true;
+        }
+
+        dbus_core_views_changed();
+    }
+
+    ~mock_core_t()
+    {
+        dbus_core_views_changed();
+    }
+
+    mock_view_t*
+    add_view (mock_output_t* output)
+    {
+        views.push_back(std::make_unique<mock_view_t> ());
+        mock_view_t* view = views.back().get();
+        view->id = next_view_id++;
+        view->output = output;
+        output->stack.insert(output->stack.begin(), view);
+        dbus_core_views_changed();
+
+        return view;
+    }
+
+    void
+    remove_view (mock_view_t* view)
+    {
+        std::vector<dbus_view_t*>& stack = view->output->stack;
+        uint32_t view_id = view->id;
+
+        stack.erase(std::remove(stack.begin(), stack.end(), view), stack.end());
+        for (auto& other : views)
+        {
+            if (other->parent == view) {
+                other->parent = nullptr;
+            }
+        }
+
+        if (cursor_focus == view) {
+            cursor_focus = nullptr;
+        }
+
+        views.erase(std::remove_if(views.begin(), views.end(),
+            [view] (const std::unique_ptr<mock_view_t>& v)
+        {
+            return v.get() == view;
+        }), views.end());
+        /* as the wayfire core, once the view is destroyed */
+        dbus_core_view_destroyed(view_id);
+    }
+
+    mock_view_t*
+    find_view (uint32_t view_id)
+    {
+        for (auto& view : views)
+        {
+            if (view->id == view_id) {
+                return view.get();
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::vector<dbus_view_t*>
+    get_all_views () override
+    {
+        std::vector<dbus_view_t*> result;
+
+        for (auto& view : views)
+        {
+            result.push_back(view.get());
+        }
+
+        return result;
+    }
+
+    dbus_view_t*
+    get_cursor_focus_view () override
+    {
+        return cursor_focus;
+    }
+
+    std::vector<dbus_view_t*>
+    get_stacked_views (dbus_output_t* output) override
+    {
+        return static_cast<mock_output_t*> (output)->stack;
+    }
+
+    std::vector<dbus_output_t*>
+    get_outputs () override
+    {
+        std::vector<dbus_output_t*> result;
+
+        for (auto& output : outputs)
+        {
+            result.push_back(output.get());
+        }
+
+        return result;
+    }
+
+    dbus_output_t*
+    get_active_output () override
+    {
+        return outputs.front().get();
+    }
+
+    std::string
+    get_xwayland_display () override
+    {
+        return ":1";
+    }
+
+    void
+    set_cursor (const char* name) override
+    {}
+
+    void
+    set_input_grab (bool state) override
+    {}
+
+    void
+    scale (bool all_workspaces, std::string app_id_filter) override
+    {}
+
+    /* there is no event loop, idle work runs right away */
+    void
+    run_idle (std::function<void()> callback) override
+    {
+        callback();
+    }
+};
+
+#endif
@@ -0,0 +1,22 @@
+#!/bin/sh
+# Runs bench-bus against bench-standin.
+# Meant to be started under dbus-run-session so the bus is private.
+#
+# Usage: run-bus-bench.sh <bench-standin> <bench-bus> [views] [clients] [seconds]
+
+standin="$1"
+client="$2"
+views="${3:-1000}"
+clients="${4:-4}"
+seconds="${5:-5}"
+
+"$standin" "$views" &
+standin_pid=$!
+
+"$client" "$clients" "$seconds"
+status=$?
+
+kill "$standin_pid"
+wait "$standin_pid"
+
+exit $status
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Runs bench-xcb against a private Xvfb.
+#
+# Usage: run-xcb-bench.sh <Xvfb> <bench-xcb> [windows] [samples]
+
+xvfb="$1"
+bench="$2"
+shift 2
+
+work_dir=$(mktemp -d)
+trap 'kill $xvfb_pid 2>/dev/null; rm -rf "$work_dir"' EXIT
+
+# Xvfb picks a free display and writes its number to fd 3
+"$xvfb" -displayfd 3 -nolisten tcp 3> "$work_dir/display" 2> "$work_dir/xvfb.log" &
+xvfb_pid=$!
+
+for i in $(seq 100); do
+    [ -s "$work_dir/display" ] && break
+    sleep 0.1
+done
+
+if [ ! -s "$work_dir/display" ]; then
+    echo "Xvfb did not start:"
+    cat "$work_dir/xvfb.log"
+    exit 1
+fi
+
+DISPLAY=":$(head -n 1 "$work_dir/display")" "$bench" "$@"
@@ -0,0 +1,96 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * signal_record.cpp -- records every signal org.wayland.compositor
+ * emits on the session bus into a trace file (signal_trace.hpp),
+ * meant to run in a real session to capture a user's traffic for
+ * bench-replay. Stops after the given time or on SIGINT / SIGTERM.
+ *
+ * Usage: bench-record <file> [seconds]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <glib-unix.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "bench_util.hpp"
+#include "signal_trace.hpp"
+
+static signal_trace_writer_t writer;
+static uint64_t start_ns;
+static uint64_t recorded = 0;
+static GMainLoop* main_loop;
+
+static void
+record_signal (GDBusConnection* connection, const gchar* sender_name,
+               const gchar* object_path, const gchar* interface_name,
+               const gchar* signal_name, GVariant* parameters,
+               gpointer user_data)
+{
+    signal_trace_write(&writer, bench_now_ns() - start_ns, signal_name,
+                       parameters);
+    recorded++;
+}
+
+static gboolean
+quit (gpointer user_data)
+{
+    g_main_loop_quit(main_loop);
+
+    return G_SOURCE_REMOVE;
+}
+
+int
+main (int argc, char* argv [])
+{
+    int seconds = (argc > 2) ? atoi(argv[2]) : 0;
+    GDBusConnection* connection;
+
+    if (argc < 2) {
+        g_printerr("usage: bench-record <file> [seconds]\n");
+
+        return 1;
+    }
+
+    connection = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
+    if (!connection) {
+        g_printerr("bench-record: no session bus\n");
+
+        return 1;
+    }
+
+    if (!signal_trace_open_write(&writer, argv[1])) {
+        g_printerr("bench-record: cannot write %s\n", argv[1]);
+
+        return 1;
+    }
+
+    main_loop = g_main_loop_new(nullptr, FALSE);
+    g_unix_signal_add(SIGTERM, quit, nullptr);
+    g_unix_signal_add(SIGINT, quit, nullptr);
+    if (seconds > 0) {
+        g_timeout_add_seconds(seconds, quit, nullptr);
+    }
+
+    start_ns = bench_now_ns();
+    g_dbus_connection_signal_subscribe(connection, "org.wayland.compositor",
+                                       "org.wayland.compositor", nullptr,
+                                       "/org/wayland/compositor", nullptr,
+                                       G_DBUS_SIGNAL_FLAGS_NONE, record_signal,
+                                       nullptr, nullptr);
+    g_main_loop_run(main_loop);
+
+    if (!signal_trace_close_write(&writer)) {
+        g_printerr("bench-record: writing %s failed\n", argv[1]);
+
+        return 1;
+    }
+
+    printf("%llu signals in %.1f s\n", (unsigned long long)recorded,
+           (bench_now_ns() - start_ns) / 1e9);
+    g_object_unref(connection);
+    g_main_loop_unref(main_loop);
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * signal_replay.cpp -- a stand-in org.wayland.compositor that
+ * re-emits a trace recorded by bench-record, so a consumer (panel,
+ * dock, ...) can be benchmarked against real traffic without a
+ * compositor. Methods are answered by the plugin's backend on the
+ * synthetic core, like bench-standin; their ids need not match the
+ * ones in the trace.
+ *
+ * The trace is loaded into memory first, then after delay seconds
+ * (time for the consumer to start and subscribe) replayed at speed
+ * times the recorded rate, or as fast as possible with "max".
+ * Prints the achieved rate and how late signals went out.
+ *
+ * Usage: bench-replay <file> [speed|max] [delay] [views]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <wayfire/util/log.hpp>
+
+#include "dbus_interface_backend.hpp"
+#include "bench_bus.hpp"
+#include "bench_util.hpp"
+#include "mock_core.hpp"
+#include "signal_trace.hpp"
+
+/* with "max", signals per main loop iteration, so calls are still served */
+#define REPLAY_BATCH 1000
+
+struct replay_signal_t
+{
+    uint64_t time_ns;
+    std::string name;
+    GVariant* parameters;
+};
+
+static std::vector<replay_signal_t> trace;
+static size_t next_signal = 0;
+/* 0 for as fast as possible */
+static double speed = 1.0;
+static uint64_t start_ns;
+static std::vector<uint64_t> lateness;
+static GMainLoop* main_loop;
+
+static bool
+load_trace (const char* path)
+{
+    signal_trace_reader_t reader;
+    replay_signal_t signal;
+    const gchar* name;
+
+    if (!signal_trace_open_read(&reader, path)) {
+        return false;
+    }
+
+    while (signal_trace_read(&reader, &signal.time_ns, &name,
+                             &signal.parameters))
+    {
+        signal.name = name;
+        trace.push_back(signal);
+    }
+
+    signal_trace_close_read(&reader);
+
+    return true;
+}
+
+static gboolean replay_step (gpointer user_data);
+
+static void
+schedule_next ()
+{
+    uint64_t due;
+    uint64_t now;
+
+    if (next_signal == trace.size()) {
+        g_main_loop_quit(main_loop);
+
+        return;
+    }
+
+    if (speed == 0) {
+        g_idle_add(replay_step, nullptr);
+
+        return;
+    }
+
+    due = start_ns + trace[next_signal].time_ns / speed;
+    now = bench_now_ns();
+    if (due <= now) {
+        g_idle_add(replay_step, nullptr);
+    }
+    else
+    {
+        g_timeout_add((due - now) / 1000000, replay_step, nullptr);
+    }
+}
+
+static gboolean
+replay_step (gpointer user_data)
+{
+    uint64_t now = bench_now_ns();
+    int emitted  = 0;
+
+    while ((next_signal < trace.size()) && (emitted < REPLAY_BATCH))
+    {
+        replay_signal_t& signal = trace[next_signal];
+        uint64_t due = start_ns;
+
+        if (speed != 0) {
+            due += signal.time_ns / speed;
+            if (due > now) {
+                break;
+            }
+
+            lateness.push_back(now - due);
+        }
+
+        /* bus_emit_signal takes the trace's reference */
+        bus_emit_signal(signal.name.c_str(), signal.parameters);
+        signal.parameters = nullptr;
+        next_signal++;
+        emitted++;
+    }
+
+    schedule_next();
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+start_replay (gpointer user_data)
+{
+    start_ns = bench_now_ns();
+    schedule_next();
+
+    return G_SOURCE_REMOVE;
+}
+
+int
+main (int argc, char* argv [])
+{
+    const char* speed_arg = (argc > 2) ? argv[2] : "1";
+    int delay = (argc > 3) ? atoi(argv[3]) : 1;
+    int views = (argc > 4) ? atoi(argv[4]) : 100;
+    mock_core_t* mock_core;
+    uint64_t elapsed;
+
+    if (argc < 2) {
+        g_printerr("usage: bench-replay <file> [speed|max] [delay] [views]\n");
+
+        return 1;
+    }
+
+    speed = (g_strcmp0(speed_arg, "max") == 0) ? 0 : atof(speed_arg);
+    if (speed < 0) {
+        speed = 1.0;
+    }
+
+    if (!load_trace(argv[1]) || trace.empty()) {
+        g_printerr("bench-replay: %s is not a trace or empty\n", argv[1]);
+
+        return 1;
+    }
+
+    wf::log::initialize_logging(std::cerr, wf::log::LOG_LEVEL_ERROR,
+                                wf::log::LOG_COLOR_MODE_OFF);
+    mock_core = new mock_core_t(views, 2, {3, 3});
+    dbus_core = mock_core;
+
+    acquire_bus();
+    while (!dbus_connection)
+    {
+        g_main_context_iteration(nullptr, TRUE);
+    }
+
+    if (!bench_wait_for_service(dbus_connection)) {
+        g_printerr("bench-replay: could not take org.wayland.compositor\n");
+
+        return 1;
+    }
+
+    main_loop = g_main_loop_new(nullptr, FALSE);
+    g_timeout_add_seconds(MAX(delay, 0), start_replay, nullptr);
+    g_main_loop_run(main_loop);
+    elapsed = bench_now_ns() - start_ns;
+    g_dbus_connection_flush_sync(dbus_connection, nullptr, nullptr);
+
+    std::sort(lateness.begin(), lateness.end());
+    printf("%zu signals in %.2f s (recorded %.2f s), %.0f signals/s\n",
+           trace.size(), elapsed / 1e9, trace.back().time_ns / 1e9,
+           trace.size() / (elapsed / 1e9));
+    if (!lateness.empty()) {
+        printf("late by p50 %.1f us, p99 %.1f us, max %.1f us\n",
+               bench_percentile(lateness, 0.50) / 1e3,
+               bench_percentile(lateness, 0.99) / 1e3, lateness.back() / 1e3);
+    }
+
+    release_bus();
+    dbus_core = nullptr;
+    delete mock_core;
+    g_main_loop_unref(main_loop);
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * signal_trace.hpp -- the file format of bench-record / bench-replay,
+ * a recording of the signals org.wayland.compositor emitted.
+ *
+ * The file starts with the magic "WFSIGTR1", followed by one record
+ * per signal, all integers are LEB128 varints:
+ *   delta_ns     nanoseconds since the previous record
+ *   name_index   index into the signal name table
+ *   [name, type] only if name_index is the next free index: the
+ *                signal name and its parameters' type string, both
+ *                as length + bytes
+ *   body_size    then the parameters in GVariant normal form
+ * A title change takes about 40 bytes, most of it the title.
+ ********************************************************************/
+
+#ifndef SIGNAL_TRACE_HPP
+#define SIGNAL_TRACE_HPP
+
+#include <gio/gio.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#define SIGNAL_TRACE_MAGIC "WFSIGTR1"
+
+struct signal_trace_writer_t
+{
+    FILE* file;
+    uint64_t last_ns;
+    std::map<std::string, uint64_t> names;
+};
+
+struct signal_trace_reader_t
+{
+    FILE* file;
+    uint64_t time_ns;
+    /* signal name and parameters type of every name index */
+    std::vector<std::pair<std::string, std::string>> names;
+};
+
+static inline void
+signal_trace_put_varint (FILE* file, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        fputc((int)(value & 0x7f) | 0x80, file);
+        value >>= 7;
+    }
+
+    fputc((int)value, file);
+}
+
+static inline bool
+signal_trace_get_varint (FILE* file, uint64_t* value)
+{
+    int shift = 0;
+    int c;
+
+    *value = 0;
+    while ((c = fgetc(file)) != EOF)
+    {
+        *value |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            return true;
+        }
+
+        shift += 7;
+        if (shift > 63) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+static inline void
+signal_trace_put_string (FILE* file, const std::string& value)
+{
+    signal_trace_put_varint(file, value.size());
+    fwrite(value.data(), 1, value.size(), file);
+}
+
+static inline bool
+signal_trace_get_string (FILE* file, std::string* value)
+{
+    uint64_t size;
+
+    if (!signal_trace_get_varint(file, &size) || (size > 4096)) {
+        return false;
+    }
+
+    value->resize(size);
+
+    return fread(&(*value)[0], 1, size, file) == size;
+}
+
+static inline bool
+signal_trace_open_write (signal_trace_writer_t* writer, const char* path)
+{
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        return false;
+    }
+
+    /* records are small, let stdio batch the writes */
+    setvbuf(writer->file, nullptr, _IOFBF, 1 << 16);
+    fwrite(SIGNAL_TRACE_MAGIC, 1, sizeof(SIGNAL_TRACE_MAGIC) - 1, writer->file);
+    writer->last_ns = 0;
+    writer->names.clear();
+
+    return true;
+}
+
+/***
+ * Appends one signal. time_ns is relative to the start of the
+ * recording and must not go backwards.
+ ***/
+static inline void
+signal_trace_write (signal_trace_writer_t* writer, uint64_t time_ns,
+                    const gchar* signal_name, GVariant* parameters)
+{
+    std::map<std::string, uint64_t>::iterator name;
+    GVariant* normal = g_variant_get_normal_form(parameters);
+    gsize size = g_variant_get_size(normal);
+
+    signal_trace_put_varint(writer->file, time_ns - writer->last_ns);
+    writer->last_ns = time_ns;
+
+    name = writer->names.find(signal_name);
+    if (name != writer->names.end()) {
+        signal_trace_put_varint(writer->file, name->second);
+    }
+    else
+    {
+        uint64_t index = writer->names.size();
+
+        writer->names[signal_name] = index;
+        signal_trace_put_varint(writer->file, index);
+        signal_trace_put_string(writer->file, signal_name);
+        signal_trace_put_string(writer->file,
+                                g_variant_get_type_string(parameters));
+    }
+
+    signal_trace_put_varint(writer->file, size);
+    fwrite(g_variant_get_data(normal), 1, size, writer->file);
+    g_variant_unref(normal);
+}
+
+static inline bool
+signal_trace_close_write (signal_trace_writer_t* writer)
+{
+    return fclose(writer->file) == 0;
+}
+
+static inline bool
+signal_trace_open_read (signal_trace_reader_t* reader, const char* path)
+{
+    char magic [sizeof(SIGNAL_TRACE_MAGIC) - 1];
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        return false;
+    }
+
+    if ((fread(magic, 1, sizeof(magic), reader->file) != sizeof(magic)) ||
+        (memcmp(magic, SIGNAL_TRACE_MAGIC, sizeof(magic)) != 0)) {
+        fclose(reader->file);
+
+        return false;
+    }
+
+    reader->time_ns = 0;
+    reader->names.clear();
+
+    return true;
+}
+
+/***
+ * The next signal. *parameters is a new (non floating) reference,
+ * *signal_name is valid until the next call. Returns false at the
+ * end of the file or on a damaged record.
+ ***/
+static inline bool
+signal_trace_read (signal_trace_reader_t* reader, uint64_t* time_ns,
+                   const gchar** signal_name, GVariant** parameters)
+{
+    uint64_t delta;
+    uint64_t index;
+    uint64_t size;
+    gchar* body;
+
+    if (!signal_trace_get_varint(reader->file, &delta) ||
+        !signal_trace_get_varint(reader->file, &index)) {
+        return false;
+    }
+
+    if (index == reader->names.size()) {
+        std::pair<std::string, std::string> name;
+
+        if (!signal_trace_get_string(reader->file, &name.first) ||
+            !signal_trace_get_string(reader->file, &name.second) ||
+            !g_variant_type_string_is_valid(name.second.c_str())) {
+            return false;
+        }
+
+        reader->names.push_back(name);
+    }
+    else
+    if (index > reader->names.size())
+    {
+        return false;
+    }
+
+    if (!signal_trace_get_varint(reader->file, &size) || (size > (1 << 24))) {
+        return false;
+    }
+
+    body = (gchar*)g_malloc(size ? size : 1);
+    if (fread(body, 1, size, reader->file) != size) {
+        g_free(body);
+
+        return false;
+    }
+
+    reader->time_ns += delta;
+    *time_ns     = reader->time_ns;
+    *signal_name = reader->names[index].first.c_str();
+    *parameters  = g_variant_ref_sink(g_variant_new_from_data(
+        G_VARIANT_TYPE(reader->names[index].second.c_str()), body, size, FALSE,
+        g_free, body));
+
+    return true;
+}
+
+static inline void
+signal_trace_close_read (signal_trace_reader_t* reader)
+{
+    fclose(reader->file);
+}
+
+#endif
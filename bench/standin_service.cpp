@@ -0,0 +1,170 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * standin_service.cpp -- owns org.wayland.compositor on the session
+ * bus with the plugin's backend on top of the synthetic core, so
+ * the bus path can be measured without a compositor.
+ * Focus requests are answered like wayfire does (the old view is
+ * deactivated, view_focus_changed is emitted) and titles of random
+ * views flap at a fixed rate to give subscribers a signal stream.
+ * Lines on stdin play the compositor for a test client: "map" maps
+ * a new toplevel titled "Mapped <id>", "title <id>" retitles a view
+ * to "Retitled <id>", "close <id>" closes it.
+ *
+ * Usage: bench-standin [views] [title_changes_per_second]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <glib-unix.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <wayfire/util/log.hpp>
+
+#include "dbus_interface_backend.hpp"
+#include "mock_core.hpp"
+
+static mock_core_t* mock_core;
+static mock_view_t* active_view = nullptr;
+static GMainLoop* main_loop;
+static GIOChannel* stdin_channel;
+
+static void
+focus_view (mock_view_t* view)
+{
+    if (active_view == view) {
+        return;
+    }
+
+    if (active_view) {
+        active_view->activated = false;
+    }
+
+    active_view = view;
+    view->activated = true;
+    mock_core->cursor_focus = view;
+    on_view_focus_changed(view);
+}
+
+static gboolean
+flap_title (gpointer user_data)
+{
+    mock_view_t* view;
+
+    view = mock_core->views[g_random_int_range(0, mock_core->views.size())].get();
+    view->title = "Document " + std::to_string(g_random_int()) +
+        " - Some Reasonably Long Application Title";
+    on_view_title_changed(view);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+run_command (const std::string& command, uint32_t view_id)
+{
+    mock_view_t* view;
+
+    if (command == "map") {
+        view = mock_core->add_view(mock_core->outputs[0].get());
+        view->app_id = "org.example.mapped";
+        view->title  = "Mapped " + std::to_string(view->id);
+        view->on_focus_request = focus_view;
+        on_view_added(view);
+
+        return;
+    }
+
+    view = mock_core->find_view(view_id);
+    if (!view) {
+        return;
+    }
+
+    if (command == "title") {
+        view->title = "Retitled " + std::to_string(view_id);
+        on_view_title_changed(view);
+    }
+    else
+    if (command == "close")
+    {
+        if (active_view == view) {
+            active_view = nullptr;
+        }
+
+        view->mapped = false;
+        on_view_closed(view);
+        mock_core->remove_view(view);
+    }
+}
+
+static gboolean
+read_command (GIOChannel* channel, GIOCondition condition, gpointer user_data)
+{
+    gchar* line = nullptr;
+    gchar command [16];
+    uint32_t view_id = 0;
+
+    if (g_io_channel_read_line(channel, &line, nullptr, nullptr,
+                               nullptr) != G_IO_STATUS_NORMAL) {
+        return G_SOURCE_REMOVE;
+    }
+
+    if (sscanf(line, "%15s %u", command, &view_id) >= 1) {
+        run_command(command, view_id);
+    }
+
+    g_free(line);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+quit (gpointer user_data)
+{
+    g_main_loop_quit(main_loop);
+
+    return G_SOURCE_REMOVE;
+}
+
+int
+main (int argc, char* argv [])
+{
+    int views = (argc > 1) ? atoi(argv[1]) : 100;
+    int title_rate = (argc > 2) ? atoi(argv[2]) : 50;
+
+    wf::log::initialize_logging(std::cerr, wf::log::LOG_LEVEL_ERROR,
+                                wf::log::LOG_COLOR_MODE_OFF);
+
+    mock_core = new mock_core_t(views, 2, {3, 3});
+    dbus_core = mock_core;
+    for (auto& view : mock_core->views)
+    {
+        view->on_focus_request = focus_view;
+    }
+
+    main_loop = g_main_loop_new(nullptr, FALSE);
+    g_unix_signal_add(SIGTERM, quit, nullptr);
+    g_unix_signal_add(SIGINT, quit, nullptr);
+
+    if (title_rate > 0) {
+        g_timeout_add(MAX(1, 1000 / title_rate), flap_title, nullptr);
+    }
+
+    stdin_channel = g_io_channel_unix_new(STDIN_FILENO);
+    g_io_add_watch(stdin_channel, (GIOCondition)(G_IO_IN | G_IO_HUP),
+                   read_command, nullptr);
+
+    acquire_bus();
+    g_main_loop_run(main_loop);
+    release_bus();
+
+    dbus_core = nullptr;
+    delete mock_core;
+    g_io_channel_unref(stdin_channel);
+    g_main_loop_unref(main_loop);
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * storm_bench.cpp -- how fast can the plugin emit signals, and what
+ * does it cost the compositor thread. The backend owns the name on
+ * the session bus (run it under dbus-run-session) on top of the
+ * synthetic core, and bursts of events are pushed through the
+ * same hooks the plugin's signal handlers forward to: title
+ * flapping, an interactive drag and mass map/unmap. K listeners,
+ * each on its own connection and thread, receive the storm.
+ *
+ * Reports per scenario: emitted signals/s and body bytes/s on the
+ * emitting thread, its CPU time per event, and the listeners' lag
+ * (receive time of the n-th signal minus emit time of the n-th
+ * event) plus the time until the last listener has drained.
+ *
+ * Usage: bench-storm [listeners] [events_per_burst]
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wayfire/util/log.hpp>
+
+#include "dbus_interface_backend.hpp"
+#include "bench_util.hpp"
+#include "mock_core.hpp"
+
+struct storm_listener_t
+{
+    GMainContext* context;
+    GMainLoop* loop;
+    std::thread thread;
+    /* receive time of the n-th signal of the current burst */
+    std::vector<uint64_t> received_ns;
+    std::atomic<uint64_t> received{0};
+};
+
+static std::atomic<int> listeners_ready{0};
+static std::atomic<uint64_t> emitted_body_bytes{0};
+
+static uint64_t
+thread_cpu_ns ()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void
+storm_signal (GDBusConnection* connection, const gchar* sender_name,
+              const gchar* object_path, const gchar* interface_name,
+              const gchar* signal_name, GVariant* parameters,
+              gpointer user_data)
+{
+    storm_listener_t* listener = (storm_listener_t*)user_data;
+    uint64_t n = listener->received.load(std::memory_order_relaxed);
+
+    if (n < listener->received_ns.size()) {
+        listener->received_ns[n] = bench_now_ns();
+    }
+
+    listener->received.store(n + 1, std::memory_order_release);
+}
+
+/***
+ * Sees every message the emitting connection sends,
+ * on the GDBus worker thread.
+ ***/
+static GDBusMessage*
+count_outgoing (GDBusConnection* connection, GDBusMessage* message,
+                gboolean incoming, gpointer user_data)
+{
+    GVariant* body;
+
+    if (!incoming &&
+        (g_dbus_message_get_message_type(message) ==
+         G_DBUS_MESSAGE_TYPE_SIGNAL)) {
+        body = g_dbus_message_get_body(message);
+        if (body) {
+            emitted_body_bytes += g_variant_get_size(body);
+        }
+    }
+
+    return message;
+}
+
+static void
+run_listener (std::string address, storm_listener_t* listener)
+{
+    GDBusConnection* connection;
+    GVariant* reply;
+    GError* error = nullptr;
+
+    g_main_context_push_thread_default(listener->context);
+    connection = g_dbus_connection_new_for_address_sync(
+        address.c_str(),
+        (GDBusConnectionFlags)(G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                               G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+        nullptr, nullptr, &error);
+    if (!connection) {
+        g_printerr("bench-storm: %s\n", error->message);
+        g_error_free(error);
+        exit(1);
+    }
+
+    g_dbus_connection_signal_subscribe(connection, nullptr,
+                                       "org.wayland.compositor", nullptr,
+                                       "/org/wayland/compositor", nullptr,
+                                       G_DBUS_SIGNAL_FLAGS_NONE, storm_signal,
+                                       listener, nullptr);
+
+    /* AddMatch went out before this call, once it returns we are subscribed */
+    reply = g_dbus_connection_call_sync(connection, "org.freedesktop.DBus",
+                                        "/org/freedesktop/DBus",
+                                        "org.freedesktop.DBus", "GetId",
+                                        nullptr, nullptr,
+                                        G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+                                        nullptr);
+    if (reply) {
+        g_variant_unref(reply);
+    }
+
+    listeners_ready++;
+    g_main_loop_run(listener->loop);
+
+    g_object_unref(connection);
+    g_main_context_pop_thread_default(listener->context);
+}
+
+static void
+bench_burst (const char* name,
+             std::vector<std::unique_ptr<storm_listener_t>>& listeners, int events, const std::function<void(int)>& fire)
+{
+    std::vector<uint64_t> emitted_ns(events);
+    std::vector<uint64_t> lags;
+    uint64_t start;
+    uint64_t elapsed;
+    uint64_t cpu;
+    uint64_t drained = 0;
+    uint64_t deadline;
+    bool complete = true;
+
+    for (auto& listener : listeners)
+    {
+        listener->received_ns.assign(events, 0);
+        listener->received = 0;
+    }
+
+    emitted_body_bytes = 0;
+    cpu   = thread_cpu_ns();
+    start = bench_now_ns();
+    for (int i = 0; i < events; i++)
+    {
+        fire(i);
+        emitted_ns[i] = bench_now_ns();
+    }
+
+    elapsed = bench_now_ns() - start;
+    cpu     = thread_cpu_ns() - cpu;
+
+    deadline = bench_now_ns() + 30000000000ull;
+    for (auto& listener : listeners)
+    {
+        while ((listener->received.load(std::memory_order_acquire) <
+                (uint64_t)events) && (bench_now_ns() < deadline))
+        {
+            g_usleep(1000);
+        }
+
+        if (listener->received.load(std::memory_order_acquire) < (uint64_t)events) {
+            complete = false;
+            continue;
+        }
+
+        for (int i = 0; i < events; i++)
+        {
+            lags.push_back(listener->received_ns[i] - emitted_ns[i]);
+        }
+
+        drained = std::max(drained, listener->received_ns[events - 1] - start);
+    }
+
+    std::sort(lags.begin(), lags.end());
+    printf("%-24s %8d %12.0f %12.0f %10.0f %10.1f %10.1f %10.1f %10.1f%s\n", name,
+           events, events / (elapsed / 1e9),
+           emitted_body_bytes.load() / (elapsed / 1e9), 1.0 * cpu / events,
+           bench_percentile(lags, 0.50) / 1e3, bench_percentile(lags, 0.99) / 1e3,
+           lags.empty() ? 0.0 : lags.back() / 1e3, drained / 1e6,
+           complete ? "" : "  (signals lost)");
+}
+
+int
+main (int argc, char* argv [])
+{
+    int listener_count = (argc > 1) ? atoi(argv[1]) : 4;
+    int events = (argc > 2) ? MAX(1, atoi(argv[2])) : 20000;
+    std::vector<std::unique_ptr<storm_listener_t>> listeners;
+    mock_core_t mock_core(100, 1, {3, 3});
+    mock_view_t* dragged;
+    std::vector<mock_view_t*> mapped;
+    gchar* address;
+
+    wf::log::initialize_logging(std::cerr, wf::log::LOG_LEVEL_ERROR,
+                                wf::log::LOG_COLOR_MODE_OFF);
+    dbus_core = &mock_core;
+    geometry_signal = TRUE;
+
+    address = g_dbus_address_get_for_bus_sync(G_BUS_TYPE_SESSION, nullptr,
+                                              nullptr);
+    if (!address) {
+        g_printerr("bench-storm: no session bus, run under dbus-run-session\n");
+
+        return 1;
+    }
+
+    acquire_bus();
+    while (!dbus_connection)
+    {
+        g_main_context_iteration(nullptr, TRUE);
+    }
+
+    g_dbus_connection_add_filter(dbus_connection, count_outgoing, nullptr,
+                                 nullptr);
+
+    for (int i = 0; i < listener_count; i++)
+    {
+        storm_listener_t* listener = new storm_listener_t;
+
+        listener->context = g_main_context_new();
+        listener->loop    = g_main_loop_new(listener->context, FALSE);
+        listener->thread  = std::thread(run_listener, std::string(address),
+                                        listener);
+        listeners.emplace_back(listener);
+    }
+
+    while (listeners_ready < listener_count)
+    {
+        g_main_context_iteration(nullptr, FALSE);
+        g_usleep(1000);
+    }
+
+    printf("%d listeners\n", listener_count);
+    printf("%-24s %8s %12s %12s %10s %10s %10s %10s %10s\n", "burst", "events",
+           "signals/s", "bytes/s", "cpu ns/ev", "lag p50us", "lag p99us",
+           "lag max us", "drain ms");
+
+    bench_burst("title flapping", listeners, events, [&] (int i)
+    {
+        mock_view_t* view = mock_core.views[i % mock_core.views.size()].get();
+
+        view->title = (i & 1) ? "Building... 42%" : "Building... 43%";
+        on_view_title_changed(view);
+    });
+
+    dragged = mock_core.views.back().get();
+    bench_burst("drag geometry", listeners, events, [&] (int i)
+    {
+        dragged->geometry.x = i % 1000;
+        dragged->geometry.y = (i / 1000) % 1000;
+        on_view_geometry_changed(dragged);
+    });
+
+    bench_burst("mass map/unmap", listeners, events, [&] (int i)
+    {
+        if (i % 200 < 100) {
+            mapped.push_back(mock_core.add_view(mock_core.outputs[0].get()));
+            on_view_added(mapped.back());
+        }
+        else
+        {
+            on_view_closed(mapped.back());
+            mock_core.remove_view(mapped.back());
+            mapped.pop_back();
+        }
+    });
+
+    for (auto& listener : listeners)
+    {
+        g_main_loop_quit(listener->loop);
+        listener->thread.join();
+        g_main_loop_unref(listener->loop);
+        g_main_context_unref(listener->context);
+    }
+
+    release_bus();
+    dbus_core = nullptr;
+    g_free(address);
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * xcb_bench.cpp -- latency of the XWayland queries of the interface
+ * (dbus_xcb_query.cpp) against any X server, normally a private
+ * Xvfb, see run-xcb-bench.sh. N windows carrying _NET_WM_PID,
+ * WM_CLASS and _NET_WM_NAME are created first.
+ * Every query is timed on a shared connection and the way the
+ * plugin issues it (connect, query, disconnect), which separates
+ * connection setup from the query itself.
+ *
+ * Usage: bench-xcb [windows] [samples]
+ ********************************************************************/
+
+extern "C" {
+#include <unistd.h>
+};
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "dbus_xcb_query.hpp"
+#include "bench_util.hpp"
+
+static std::string display;
+static std::vector<uint32_t> windows;
+static uint64_t errors = 0;
+
+static xcb_atom_t
+intern (xcb_connection_t* conn, const char* name)
+{
+    xcb_atom_t atom = dbus_xcb_intern_atom(conn, name);
+
+    if (atom == XCB_ATOM_NONE) {
+        fprintf(stderr, "bench-xcb: cannot intern %s\n", name);
+        exit(1);
+    }
+
+    return atom;
+}
+
+static void
+create_windows (xcb_connection_t* conn, int count)
+{
+    xcb_screen_t* screen = xcb_setup_roots_iterator(xcb_get_setup(conn)).data;
+    xcb_atom_t net_wm_pid  = intern(conn, "_NET_WM_PID");
+    xcb_atom_t net_wm_name = intern(conn, "_NET_WM_NAME");
+    xcb_atom_t utf8_string = intern(conn, "UTF8_STRING");
+    uint32_t pid = getpid();
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t window = xcb_generate_id(conn);
+        std::string wm_class = "bench-xcb-" + std::to_string(i);
+        std::string name = "Synthetic window " + std::to_string(i) +
+            " - Some Reasonably Long Application Title";
+
+        /* instance and class, both NUL terminated */
+        wm_class += '\0';
+        wm_class += "BenchXcb";
+        wm_class += '\0';
+
+        xcb_create_window(conn, XCB_COPY_FROM_PARENT, window, screen->root,
+                          0, 0, 64, 64, 0, XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          screen->root_visual, 0, nullptr);
+        xcb_change_property(conn, XCB_PROP_MODE_REPLACE, window, net_wm_pid,
+                            XCB_ATOM_CARDINAL, 32, 1, &pid);
+        xcb_change_property(conn, XCB_PROP_MODE_REPLACE, window,
+                            XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                            wm_class.size(), wm_class.data());
+        xcb_change_property(conn, XCB_PROP_MODE_REPLACE, window, net_wm_name,
+                            utf8_string, 8, name.size(), name.data());
+        windows.push_back(window);
+    }
+
+    /* a round trip, so every request above has been processed */
+    free(xcb_get_input_focus_reply(conn, xcb_get_input_focus(conn), nullptr));
+}
+
+static void
+bench_query (const char* name, int samples,
+             const std::function<void(uint32_t window)>& query)
+{
+    std::vector<uint64_t> latencies;
+    uint64_t total = 0;
+
+    for (int i = 0; i < samples; i++)
+    {
+        uint64_t start = bench_now_ns();
+
+        query(windows[i % windows.size()]);
+        latencies.push_back(bench_now_ns() - start);
+        total += latencies.back();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    printf("%-48s %8d %10.1f %10.1f %10.1f\n", name, samples,
+           total / 1e3 / samples, bench_percentile(latencies, 0.50) / 1e3,
+           bench_percentile(latencies, 0.99) / 1e3);
+}
+
+static void
+check (bool ok)
+{
+    if (!ok) {
+        errors++;
+    }
+}
+
+int
+main (int argc, char* argv [])
+{
+    int window_count = (argc > 1) ? atoi(argv[1]) : 100;
+    int samples = (argc > 2) ? atoi(argv[2]) : 2000;
+    pid_t pid = getpid();
+    xcb_connection_t* conn;
+    xcb_atom_t net_wm_pid;
+    xcb_atom_t net_wm_name;
+
+    display = getenv("DISPLAY") ? getenv("DISPLAY") : "";
+    conn = dbus_xcb_connect(display, 0);
+    if (!conn || (window_count < 1)) {
+        fprintf(stderr, "bench-xcb: cannot connect to DISPLAY '%s'\n",
+                display.c_str());
+
+        return 1;
+    }
+
+    create_windows(conn, window_count);
+    net_wm_pid  = intern(conn, "_NET_WM_PID");
+    net_wm_name = intern(conn, "_NET_WM_NAME");
+
+    printf("%d windows on %s\n", window_count, display.c_str());
+    printf("%-48s %8s %10s %10s %10s\n", "query", "samples", "mean us",
+           "p50 us", "p99 us");
+
+    bench_query("connect + disconnect", samples, [&] (uint32_t window)
+    {
+        xcb_connection_t* c = dbus_xcb_connect(display, DBUS_XCB_TIMEOUT_MS);
+
+        check(c != nullptr);
+        if (c) {
+            dbus_xcb_disconnect(c);
+        }
+    });
+
+    /************************* Shared connection ************************/
+    bench_query("intern_atom", samples, [&] (uint32_t window)
+    {
+        check(dbus_xcb_intern_atom(conn, "_NET_WM_PID") == net_wm_pid);
+    });
+    bench_query("get_cardinal _NET_WM_PID", samples, [&] (uint32_t window)
+    {
+        uint32_t value = 0;
+
+        check(dbus_xcb_get_cardinal(conn, window, net_wm_pid, &value) &&
+              (value == (uint32_t)pid));
+    });
+    bench_query("get_string WM_CLASS", samples, [&] (uint32_t window)
+    {
+        std::string value;
+        bool is_cardinal;
+
+        check(dbus_xcb_get_string(conn, window, XCB_ATOM_WM_CLASS, &value,
+                                  &is_cardinal) && !is_cardinal);
+    });
+    bench_query("get_string _NET_WM_NAME", samples, [&] (uint32_t window)
+    {
+        std::string value;
+        bool is_cardinal;
+
+        check(dbus_xcb_get_string(conn, window, net_wm_name, &value,
+                                  &is_cardinal) && !is_cardinal);
+    });
+    bench_query("get_client_pid (xcb-res)", samples, [&] (uint32_t window)
+    {
+        check(dbus_xcb_get_client_pid(conn, window) == pid);
+    });
+
+    /************************* As the plugin does it ************************/
+    bench_query("query_view_xwayland_atom_cardinal", samples,
+        [&] (uint32_t window)
+    {
+        xcb_connection_t* c = dbus_xcb_connect(display, DBUS_XCB_TIMEOUT_MS);
+        uint32_t value = 0;
+
+        if (!c) {
+            check(false);
+
+            return;
+        }
+
+        check(dbus_xcb_get_cardinal(c, window,
+                                    dbus_xcb_intern_atom(c, "_NET_WM_PID"),
+                                    &value));
+        dbus_xcb_disconnect(c);
+    });
+    bench_query("query_view_xwayland_atom_string", samples,
+        [&] (uint32_t window)
+    {
+        xcb_connection_t* c = dbus_xcb_connect(display, DBUS_XCB_TIMEOUT_MS);
+        std::string value;
+        bool is_cardinal;
+
+        if (!c) {
+            check(false);
+
+            return;
+        }
+
+        check(dbus_xcb_get_string(c, window,
+                                  dbus_xcb_intern_atom(c, "_NET_WM_NAME"),
+                                  &value, &is_cardinal));
+        dbus_xcb_disconnect(c);
+    });
+    bench_query("query_view_credentials", samples, [&] (uint32_t window)
+    {
+        xcb_connection_t* c = dbus_xcb_connect(display, DBUS_XCB_TIMEOUT_MS);
+
+        if (!c) {
+            check(false);
+
+            return;
+        }
+
+        check(dbus_xcb_get_client_pid(c, window) == pid);
+        dbus_xcb_disconnect(c);
+    });
+
+    printf("%llu errors\n", (unsigned long long)errors);
+    dbus_xcb_disconnect(conn);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_app_groups.cpp -- the groups' counts, the members are kept
+ * by a dbus_member_table_t keyed by app id.
+ ********************************************************************/
+
+#include "dbus_app_groups.hpp"
+#include "dbus_member_table.hpp"
+
+static dbus_app_groups_t groups;
+
+struct app_groups_aggregate_t
+{
+    typedef std::string key_t;
+    typedef dbus_app_group_t state_t;
+
+    struct member_t
+    {
+        std::string app_id;
+        bool urgent;
+        bool minimized;
+    };
+
+    static const key_t&
+    key (const member_t& member)
+    {
+        return member.app_id;
+    }
+
+    static state_t
+    state (const key_t& app_id)
+    {
+        dbus_app_groups_t::const_iterator group = groups.find(app_id);
+
+        return (group != groups.end()) ? group->second : state_t();
+    }
+
+    static void
+    states (std::unordered_map<key_t, state_t>* by_key)
+    {
+        by_key->insert(groups.begin(), groups.end());
+    }
+
+    static bool
+    same (const state_t& a, const state_t& b)
+    {
+        return (a.views == b.views) &&
+               ((a.urgent > 0) == (b.urgent > 0)) &&
+               ((a.minimized == a.views) == (b.minimized == b.views));
+    }
+
+    static void
+    count (const member_t& member, uint32_t step)
+    {
+        dbus_app_group_t& group = groups[member.app_id];
+
+        group.views     += step;
+        group.urgent    += member.urgent ? step : 0;
+        group.minimized += member.minimized ? step : 0;
+        if (group.views == 0) {
+            groups.erase(member.app_id);
+        }
+    }
+
+    static void
+    clear ()
+    {
+        groups.clear();
+    }
+
+    static bool
+    is_member (dbus_view_t* view)
+    {
+        return view->is_mapped() &&
+               (view->get_role() == DBUS_VIEW_ROLE_TOPLEVEL);
+    }
+
+    static member_t
+    member (dbus_view_t* view)
+    {
+        return {view->get_app_id(), view->demands_attention(),
+            view->is_minimized()};
+    }
+};
+
+static dbus_member_table_t<app_groups_aggregate_t> members;
+
+void
+dbus_app_groups_update (dbus_view_t* view, std::vector<std::string>* changed)
+{
+    members.update(view, changed);
+}
+
+void
+dbus_app_groups_update_minimized (dbus_view_t* view, bool minimized,
+                                  std::vector<std::string>* changed)
+{
+    members.update(view, [=] (app_groups_aggregate_t::member_t* member)
+    {
+        member->minimized = minimized;
+    }, changed);
+}
+
+void
+dbus_app_groups_remove (uint32_t view_id, std::vector<std::string>* changed)
+{
+    members.remove(view_id, changed);
+}
+
+void
+dbus_app_groups_invalidate ()
+{
+    members.invalidate();
+}
+
+const dbus_app_groups_t&
+dbus_app_groups_get ()
+{
+    members.ensure(nullptr);
+
+    return groups;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_app_groups.hpp -- the mapped toplevels grouped by app id,
+ * with the state docks show per application, kept up to date by
+ * the backend's hooks. Every update reports the app ids whose
+ * aggregate changed, for app_group_changed.
+ ********************************************************************/
+
+#ifndef DBUS_APP_GROUPS_HPP
+#define DBUS_APP_GROUPS_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+/***
+ * Counts of the group's views. As reported: views, urgent
+ * (urgent > 0) and minimized (all views are). The focus isn't
+ * part of it, clients have view_focus_changed for that.
+ ***/
+struct dbus_app_group_t
+{
+    uint32_t views     = 0;
+    uint32_t urgent    = 0;
+    uint32_t minimized = 0;
+};
+
+/* by app id, a group without views is not kept */
+typedef std::map<std::string, dbus_app_group_t> dbus_app_groups_t;
+
+/***
+ * Follow a view's app id, role, minimized and attention state
+ * (map, focus and the hooks of those) and its unmap.
+ * changed gets the app ids whose reported state changed.
+ ***/
+void dbus_app_groups_update (dbus_view_t* view,
+                             std::vector<std::string>* changed);
+/* the minimize hook is a request, the view hasn't changed yet */
+void dbus_app_groups_update_minimized (dbus_view_t* view, bool minimized,
+                                       std::vector<std::string>* changed);
+void dbus_app_groups_remove (uint32_t view_id,
+                             std::vector<std::string>* changed);
+
+/***
+ * The groups are rebuilt from dbus_core on the next update or
+ * query, for changes no hook reports. Groups that differ from
+ * before are reported by that update.
+ ***/
+void dbus_app_groups_invalidate ();
+
+const dbus_app_groups_t& dbus_app_groups_get ();
+
+#endif
@@ -0,0 +1,163 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ * Copyright (C) 2019 - 2020 Damian Ivanov <damianatorrpm@gmail.com>
+ *
+ * dbus_core.hpp -- the thin slice of the compositor core the
+ * dbus backend talks to. The plugin implements it on top of
+ * wf::get_core() (dbus_core_wayfire.hpp), the benchmarks on top
+ * of a synthetic core (bench/mock_core.hpp).
+ ********************************************************************/
+
+#ifndef DBUS_CORE_HPP
+#define DBUS_CORE_HPP
+
+#include <sys/types.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct dbus_point_t
+{
+    double x;
+    double y;
+};
+
+struct dbus_workspace_t
+{
+    int x;
+    int y;
+};
+
+struct dbus_geometry_t
+{
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+/***
+ * View roles as they are reported over the bus
+ ***/
+enum dbus_view_role_t : uint32_t
+{
+    DBUS_VIEW_ROLE_UNKNOWN     = 0,
+    DBUS_VIEW_ROLE_TOPLEVEL    = 1,
+    DBUS_VIEW_ROLE_DESKTOP_ENVIRONMENT = 2,
+    DBUS_VIEW_ROLE_UNMANAGED   = 3,
+};
+
+class dbus_output_t
+{
+  public:
+    virtual ~dbus_output_t() = default;
+
+    virtual uint32_t get_id () = 0;
+    virtual std::string get_name () = 0;
+    /* nullptr if the backend does not provide it */
+    virtual const char* get_make () = 0;
+    virtual const char* get_model () = 0;
+    virtual const char* get_serial () = 0;
+
+    /* position and size in the output layout */
+    virtual dbus_geometry_t get_layout_geometry () = 0;
+    virtual double get_scale () = 0;
+    /* enum wl_output_transform */
+    virtual uint32_t get_transform () = 0;
+
+    virtual dbus_workspace_t get_workspace () = 0;
+    virtual dbus_workspace_t get_workspace_grid_size () = 0;
+    virtual void request_workspace (int x, int y) = 0;
+    /* output relative */
+    virtual dbus_point_t get_cursor_position () = 0;
+};
+
+class dbus_view_t
+{
+  public:
+    virtual ~dbus_view_t() = default;
+
+    virtual uint32_t get_id () = 0;
+    virtual std::string get_app_id () = 0;
+    virtual std::string get_gtk_shell_app_id () = 0;
+    virtual std::string get_title () = 0;
+    virtual dbus_view_role_t get_role () = 0;
+    virtual bool is_modal_dialog () = 0;
+    virtual bool is_mapped () = 0;
+    /* mapped toplevel with an output */
+    virtual bool is_toplevel () = 0;
+    virtual dbus_view_t* get_parent () = 0;
+
+    virtual bool is_minimized () = 0;
+    virtual bool is_maximized () = 0;
+    virtual bool is_fullscreen () = 0;
+    virtual bool is_activated () = 0;
+    virtual bool is_above () = 0;
+    virtual bool demands_attention () = 0;
+    virtual void clear_attention () = 0;
+
+    virtual dbus_output_t* get_output () = 0;
+    virtual dbus_geometry_t get_output_geometry () = 0;
+    /* workspaces covering more than 10% of the view */
+    virtual std::vector<dbus_workspace_t> get_workspaces () = 0;
+
+    /* 0 for native wayland views or if xwayland is disabled */
+    virtual uint32_t get_xwayland_window_id () = 0;
+    virtual std::string get_xwayland_instance () = 0;
+    virtual bool get_xwayland_size (uint32_t* width, uint32_t* height) = 0;
+    virtual void get_client_credentials (pid_t* pid, uid_t* uid, gid_t* gid) = 0;
+
+    /************************* Actions ************************/
+    virtual void minimize (bool state) = 0;
+    virtual void maximize (bool state) = 0;
+    virtual void fullscreen (bool state) = 0;
+    virtual void set_activated (bool state) = 0;
+    virtual void focus_request () = 0;
+    virtual void close () = 0;
+    virtual void set_minimize_hint (dbus_geometry_t hint) = 0;
+    virtual void toggle_above () = 0;
+    virtual void ensure_visible () = 0;
+    virtual void bring_to_front () = 0;
+    virtual void restack (dbus_view_t* related_view, bool above) = 0;
+    virtual void set_alpha (double alpha) = 0;
+    virtual void move_to_output (dbus_output_t* output) = 0;
+    virtual void move_to_workspace (int x, int y) = 0;
+};
+
+class dbus_core_t
+{
+  public:
+    virtual ~dbus_core_t() = default;
+
+    virtual std::vector<dbus_view_t*> get_all_views () = 0;
+    virtual dbus_view_t* get_cursor_focus_view () = 0;
+    /* stacking order of the middle layers, topmost first */
+    virtual std::vector<dbus_view_t*> get_stacked_views (dbus_output_t* output) = 0;
+
+    virtual std::vector<dbus_output_t*> get_outputs () = 0;
+    virtual dbus_output_t* get_active_output () = 0;
+
+    virtual std::string get_xwayland_display () = 0;
+    virtual void set_cursor (const char* name) = 0;
+    /* grab input on all outputs for wf-prop's pick mode */
+    virtual void set_input_grab (bool state) = 0;
+    virtual void scale (bool all_workspaces, std::string app_id_filter) = 0;
+
+    /* defer an action to the compositor's idle loop */
+    virtual void run_idle (std::function<void()> callback) = 0;
+};
+
+extern dbus_core_t* dbus_core;
+
+/***
+ * Implemented by the backend. A core calls dbus_core_views_changed
+ * when its views come or go without a hook telling the backend (a
+ * new core), cached list replies and the indices are then rebuilt.
+ * dbus_core_view_destroyed drops just the one view, for a view
+ * destroyed some time after its unmap.
+ ***/
+void dbus_core_views_changed ();
+void dbus_core_view_destroyed (uint32_t view_id);
+
+#endif
@@ -0,0 +1,656 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ * Copyright (C) 2019 - 2020 Damian Ivanov <damianatorrpm@gmail.com>
+ *
+ * dbus_core_wayfire.hpp -- dbus_core_t on top of wf::get_core().
+ * The wrappers are stored as custom data on the views / outputs
+ * so they live exactly as long as the object they describe.
+ ********************************************************************/
+
+#ifndef DBUS_CORE_WAYFIRE_HPP
+#define DBUS_CORE_WAYFIRE_HPP
+
+extern "C" {
+#define class class_t
+#define static
+#include <X11/Xatom.h>
+#include <wlr/xwayland.h>
+// #include <xwayland/xwm.h>
+#undef static
+#undef class
+#include <sys/socket.h>
+#include <wlr/types/wlr_idle.h>
+};
+
+#include <map>
+#include <memory>
+#include <set>
+
+#include "dbus_core.hpp"
+#include "dbus_scale_filter.hpp"
+#include "wayfire/view-transform.hpp"
+#include <wayfire/compositor-view.hpp>
+#include <wayfire/core.hpp>
+#include <wayfire/debug.hpp>
+#include <wayfire/gtk-shell.hpp>
+#include <wayfire/option-wrapper.hpp>
+#include <wayfire/output-layout.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/plugin.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/util.hpp>
+#include <wayfire/view.hpp>
+#include <wayfire/workspace-manager.hpp>
+
+wf::option_wrapper_t<bool> xwayland_enabled("core/xwayland");
+
+wf::compositor_core_t& core = wf::get_core();
+std::vector<wf::output_t*> wf_outputs = core.output_layout->get_outputs();
+std::set<wf::output_t*> connected_wf_outputs;
+std::map<wf::output_t*, std::unique_ptr<wf::plugin_grab_interface_t>>
+grab_interfaces;
+
+class wayfire_dbus_output_t : public dbus_output_t, public wf::custom_data_t
+{
+  public:
+    wf::output_t* output;
+
+    wayfire_dbus_output_t(wf::output_t* output) : output(output)
+    {}
+
+    uint32_t
+    get_id () override
+    {
+        return output->get_id();
+    }
+
+    std::string
+    get_name () override
+    {
+        return output->to_string();
+    }
+
+    const char*
+    get_make () override
+    {
+        return output->handle ? output->handle->make : nullptr;
+    }
+
+    const char*
+    get_model () override
+    {
+        return output->handle ? output->handle->model : nullptr;
+    }
+
+    const char*
+    get_serial () override
+    {
+        return output->handle ? output->handle->serial : nullptr;
+    }
+
+    dbus_geometry_t
+    get_layout_geometry () override
+    {
+        wf::geometry_t geometry = output->get_layout_geometry();
+
+        return {geometry.x, geometry.y, geometry.width, geometry.height};
+    }
+
+    double
+    get_scale () override
+    {
+        return output->handle ? output->handle->scale : 1.0;
+    }
+
+    uint32_t
+    get_transform () override
+    {
+        return output->handle ? output->handle->transform : 0;
+    }
+
+    dbus_workspace_t
+    get_workspace () override
+    {
+        wf::point_t ws = output->workspace->get_current_workspace();
+
+        return {ws.x, ws.y};
+    }
+
+    dbus_workspace_t
+    get_workspace_grid_size () override
+    {
+        wf::dimensions_t grid = output->workspace->get_workspace_grid_size();
+
+        return {grid.width, grid.height};
+    }
+
+    void
+    request_workspace (int x, int y) override
+    {
+        output->workspace->request_workspace({x, y});
+    }
+
+    dbus_point_t
+    get_cursor_position () override
+    {
+        wf::pointf_t position = output->get_cursor_position();
+
+        return {position.x, position.y};
+    }
+};
+
+static dbus_output_t*
+get_dbus_output (wf::output_t* output)
+{
+    if (!output) {
+        return nullptr;
+    }
+
+    if (!output->has_data<wayfire_dbus_output_t> ()) {
+        output->store_data(std::make_unique<wayfire_dbus_output_t> (output));
+    }
+
+    return output->get_data<wayfire_dbus_output_t> ().get();
+}
+
+class wayfire_dbus_view_t : public dbus_view_t, public wf::custom_data_t
+{
+  public:
+    wayfire_view view;
+    /* the view is half gone by the time its data is destroyed */
+    uint32_t view_id;
+
+    wayfire_dbus_view_t(wayfire_view view) : view(view),
+        view_id(view->get_id())
+    {}
+
+    /* the view is being destroyed */
+    ~wayfire_dbus_view_t()
+    {
+        dbus_core_view_destroyed(view_id);
+    }
+
+    static dbus_view_t*
+    get (wayfire_view view)
+    {
+        if (!view) {
+            return nullptr;
+        }
+
+        if (!view->has_data<wayfire_dbus_view_t> ()) {
+            view->store_data(std::make_unique<wayfire_dbus_view_t> (view));
+        }
+
+        return view->get_data<wayfire_dbus_view_t> ().get();
+    }
+
+    uint32_t
+    get_id () override
+    {
+        return view->get_id();
+    }
+
+    std::string
+    get_app_id () override
+    {
+        return view->get_app_id();
+    }
+
+    std::string
+    get_gtk_shell_app_id () override
+    {
+        return ::get_gtk_shell_app_id(view);
+    }
+
+    std::string
+    get_title () override
+    {
+        return view->get_title();
+    }
+
+    dbus_view_role_t
+    get_role () override
+    {
+        if (view->role == wf::VIEW_ROLE_TOPLEVEL) {
+            return DBUS_VIEW_ROLE_TOPLEVEL;
+        }
+        else
+        if (view->role == wf::VIEW_ROLE_DESKTOP_ENVIRONMENT)
+        {
+            return DBUS_VIEW_ROLE_DESKTOP_ENVIRONMENT;
+        }
+        else
+        if (view->role == wf::VIEW_ROLE_UNMANAGED)
+        {
+            return DBUS_VIEW_ROLE_UNMANAGED;
+        }
+
+        return DBUS_VIEW_ROLE_UNKNOWN;
+    }
+
+    bool
+    is_modal_dialog () override
+    {
+        return view->has_data("gtk-shell-modal");
+    }
+
+    bool
+    is_mapped () override
+    {
+        return view->is_mapped();
+    }
+
+    bool
+    is_toplevel () override
+    {
+        return view->is_mapped() && (view->role == wf::VIEW_ROLE_TOPLEVEL) &&
+               view->get_output();
+    }
+
+    dbus_view_t*
+    get_parent () override
+    {
+        return get(view->parent);
+    }
+
+    bool
+    is_minimized () override
+    {
+        return view->minimized;
+    }
+
+    bool
+    is_maximized () override
+    {
+        return view->tiled_edges == wf::TILED_EDGES_ALL;
+    }
+
+    bool
+    is_fullscreen () override
+    {
+        return view->fullscreen;
+    }
+
+    bool
+    is_activated () override
+    {
+        return view->activated;
+    }
+
+    bool
+    is_above () override
+    {
+        return view->has_data("wm-actions-above");
+    }
+
+    bool
+    demands_attention () override
+    {
+        return view->has_data("view-demands-attention");
+    }
+
+    void
+    clear_attention () override
+    {
+        view->erase_data("view-demands-attention");
+    }
+
+    dbus_output_t*
+    get_output () override
+    {
+        return get_dbus_output(view->get_output());
+    }
+
+    dbus_geometry_t
+    get_output_geometry () override
+    {
+        wf::geometry_t geometry = view->get_output_geometry();
+
+        return {geometry.x, geometry.y, geometry.width, geometry.height};
+    }
+
+    std::vector<dbus_workspace_t>
+    get_workspaces () override
+    {
+        std::vector<dbus_workspace_t> result;
+        double area;
+        wf::geometry_t workspace_relative_geometry;
+        wlr_box view_relative_geometry;
+        wf::geometry_t intersection;
+        wf::dimensions_t workspaces;
+        wf::output_t* output = view->get_output();
+
+        if (!output) {
+            return result;
+        }
+
+        workspaces = output->workspace->get_workspace_grid_size();
+        view_relative_geometry = view->get_bounding_box();
+
+        for (int horizontal_workspace = 0; horizontal_workspace < workspaces.width;
+             horizontal_workspace++)
+        {
+            for (int vertical_workspace = 0; vertical_workspace < workspaces.height;
+                 vertical_workspace++)
+            {
+                wf::point_t ws = {horizontal_workspace, vertical_workspace};
+                if (output->workspace->view_visible_on(view, ws)) {
+                    workspace_relative_geometry = output->render->get_ws_box(ws);
+                    intersection = wf::geometry_intersection(view_relative_geometry,
+                                                             workspace_relative_geometry);
+                    area = 1.0 * intersection.width * intersection.height;
+                    area /= 1.0 * view_relative_geometry.width *
+                        view_relative_geometry.height;
+
+                    if (area > 0.1) {
+                        result.push_back({horizontal_workspace, vertical_workspace});
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    wlr_xwayland_surface*
+    get_xwayland_surface ()
+    {
+        if (xwayland_enabled != 1) {
+            return nullptr;
+        }
+
+        wlr_surface* main_wlr_surface = view->get_main_surface()->get_wlr_surface();
+        if (!main_wlr_surface ||
+            !wlr_surface_is_xwayland_surface(main_wlr_surface)) {
+            return nullptr;
+        }
+
+        return wlr_xwayland_surface_from_wlr_surface(main_wlr_surface);
+    }
+
+    uint32_t
+    get_xwayland_window_id () override
+    {
+        wlr_xwayland_surface* xsurf = get_xwayland_surface();
+
+        return xsurf ? xsurf->window_id : 0;
+    }
+
+    std::string
+    get_xwayland_instance () override
+    {
+        wlr_xwayland_surface* xsurf = get_xwayland_surface();
+
+        return xsurf ? nonull(xsurf->instance) : "";
+    }
+
+    bool
+    get_xwayland_size (uint32_t* width, uint32_t* height) override
+    {
+        wlr_xwayland_surface* xsurf = get_xwayland_surface();
+        if (!xsurf) {
+            return false;
+        }
+
+        *width = xsurf->width;
+        *height = xsurf->height;
+
+        return true;
+    }
+
+    void
+    get_client_credentials (pid_t* pid, uid_t* uid, gid_t* gid) override
+    {
+        wl_client_get_credentials(view->get_client(), pid, uid, gid);
+    }
+
+    /************************* Actions ************************/
+    void
+    minimize (bool state) override
+    {
+        view->minimize_request(state);
+    }
+
+    void
+    maximize (bool state) override
+    {
+        view->tile_request(state ? wf::TILED_EDGES_ALL : 0);
+    }
+
+    void
+    fullscreen (bool state) override
+    {
+        view->fullscreen_request(core.get_active_output(), state);
+    }
+
+    void
+    set_activated (bool state) override
+    {
+        view->set_activated(state);
+    }
+
+    void
+    focus_request () override
+    {
+        view->focus_request();
+    }
+
+    void
+    close () override
+    {
+        view->close();
+    }
+
+    void
+    set_minimize_hint (dbus_geometry_t hint) override
+    {
+        view->set_minimize_hint({hint.x, hint.y, hint.width, hint.height});
+    }
+
+    void
+    toggle_above () override
+    {
+        wf::_view_signal signal_data;
+        signal_data.view = view;
+        view->get_output()->emit_signal("wm-actions-toggle-above", &signal_data);
+    }
+
+    void
+    ensure_visible () override
+    {
+        view->get_output()->ensure_visible(view);
+    }
+
+    void
+    bring_to_front () override
+    {
+        view->get_output()->workspace->bring_to_front(view);
+    }
+
+    void
+    restack (dbus_view_t* related_view, bool above) override
+    {
+        wf::output_t* output = view->get_output();
+        wayfire_view related = static_cast<wayfire_dbus_view_t*> (related_view)->view;
+
+        if (!output) {
+            return;
+        }
+
+        if (above) {
+            output->workspace->restack_above(view, related);
+        }
+        else
+        {
+            output->workspace->restack_below(view, related);
+        }
+    }
+
+    void
+    set_alpha (double alpha) override
+    {
+        if (alpha == 1.0) {
+            if (view->get_transformer("dbus-shade")) {
+                view->pop_transformer("dbus-shade");
+            }
+
+            return;
+        }
+
+        wf::view_2D* transformer;
+        if (!view->get_transformer("dbus-shade")) {
+            view->add_transformer(std::make_unique<wf::view_2D> (view),
+                                  "dbus-shade");
+        }
+
+        transformer = dynamic_cast<wf::view_2D*> (
+            view->get_transformer("dbus-shade").get());
+
+        if (transformer->alpha != (float)alpha) {
+            transformer->alpha = (float)alpha;
+            // view->damage();
+        }
+    }
+
+    void
+    move_to_output (dbus_output_t* output) override
+    {
+        core.move_view_to_output(
+            view, static_cast<wayfire_dbus_output_t*> (output)->output, TRUE);
+    }
+
+    void
+    move_to_workspace (int x, int y) override
+    {
+        view->get_output()->workspace->move_to_workspace(view, {x, y});
+    }
+};
+
+static dbus_view_t*
+get_dbus_view (wayfire_view view)
+{
+    return wayfire_dbus_view_t::get(view);
+}
+
+class wayfire_dbus_core_t : public dbus_core_t
+{
+  public:
+    std::vector<dbus_view_t*>
+    get_all_views () override
+    {
+        std::vector<dbus_view_t*> views;
+
+        for (wayfire_view view : core.get_all_views())
+        {
+            views.push_back(get_dbus_view(view));
+        }
+
+        return views;
+    }
+
+    dbus_view_t*
+    get_cursor_focus_view () override
+    {
+        return get_dbus_view(core.get_cursor_focus_view());
+    }
+
+    std::vector<dbus_view_t*>
+    get_stacked_views (dbus_output_t* output) override
+    {
+        std::vector<dbus_view_t*> views;
+        wf::output_t* wf_output;
+
+        wf_output = static_cast<wayfire_dbus_output_t*> (output)->output;
+        for (wayfire_view view :
+             wf_output->workspace->get_views_in_layer(wf::MIDDLE_LAYERS))
+        {
+            views.push_back(get_dbus_view(view));
+        }
+
+        return views;
+    }
+
+    std::vector<dbus_output_t*>
+    get_outputs () override
+    {
+        std::vector<dbus_output_t*> outputs;
+
+        for (wf::output_t* output : wf_outputs)
+        {
+            outputs.push_back(get_dbus_output(output));
+        }
+
+        return outputs;
+    }
+
+    dbus_output_t*
+    get_active_output () override
+    {
+        return get_dbus_output(core.get_active_output());
+    }
+
+    std::string
+    get_xwayland_display () override
+    {
+        return core.get_xwayland_display();
+    }
+
+    void
+    set_cursor (const char* name) override
+    {
+        core.set_cursor(name);
+    }
+
+    void
+    set_input_grab (bool state) override
+    {
+        for (wf::output_t* output : wf_outputs)
+        {
+            if (state) {
+                if (!output->activate_plugin(grab_interfaces[output])) {
+                    continue;
+                }
+
+                grab_interfaces[output]->grab();
+            }
+            else
+            {
+                output->deactivate_plugin(grab_interfaces[output]);
+                grab_interfaces[output]->ungrab();
+            }
+        }
+    }
+
+    void
+    scale (bool all_workspaces, std::string app_id_filter) override
+    {
+        wf::output_t* output = core.get_active_output();
+        auto filter = dbus_scale_filter::get(output);
+        filter->set_filter(std::move(app_id_filter));
+
+        if (output->is_plugin_active("scale")) {
+            output->emit_signal("scale-update", nullptr);
+        }
+        else
+        {
+            wf::activator_data_t adata;
+            adata.source = wf::activator_source_t::PLUGIN;
+            output->call_plugin(
+                all_workspaces ? "scale/toggle_all" : "scale/toggle", adata);
+        }
+    }
+
+    void
+    run_idle (std::function<void()> callback) override
+    {
+        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
+        idle_call->run_once([callback, idle_call] ()
+        {
+            callback();
+            delete idle_call;
+        });
+    }
+};
+
+#endif
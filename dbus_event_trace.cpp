@@ -0,0 +1,370 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_event_trace.cpp -- writer and reader of the event traces.
+ *
+ * The file starts with the magic "WFEVTR01", followed by one
+ * record per event, integers as LEB128 varints, signed ones zigzag
+ * encoded, strings as length + bytes:
+ *   type (1 byte), delta_ns, id, args[4]
+ *   view events:   role, output_id, app_id, title, geometry (4),
+ *                  flags, xwayland_window_id, pid
+ *   output events: name, workspace (2), grid (2)
+ * Tablet events carry an empty view state.
+ *
+ * The hook arguments in args:
+ *   POINTER_BUTTON       x, y, button, released (id: view under cursor)
+ *   FULLSCREEN, MAXIMIZED, MINIMIZED, KEEP_ABOVE  state
+ *   VIEW_TILED           edges
+ *   VIEW_OUTPUT_MOVE*    old_output, new_output
+ *   OUTPUT_WORKSPACE_*   x, y
+ *   VIEW_PARENT_CHANGED  parent id (0 for none)
+ ********************************************************************/
+
+#include <chrono>
+#include <cstring>
+
+#include "dbus_event_trace.hpp"
+
+#define EVENT_TRACE_MAGIC "WFEVTR01"
+
+FILE* dbus_event_trace_file = nullptr;
+static uint64_t trace_start_ns;
+static uint64_t trace_last_ns;
+
+static uint64_t
+now_ns ()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void
+put_varint (uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        fputc((int)(value & 0x7f) | 0x80, dbus_event_trace_file);
+        value >>= 7;
+    }
+
+    fputc((int)value, dbus_event_trace_file);
+}
+
+static void
+put_signed (int64_t value)
+{
+    put_varint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void
+put_string (const std::string& value)
+{
+    put_varint(value.size());
+    fwrite(value.data(), 1, value.size(), dbus_event_trace_file);
+}
+
+static bool
+get_varint (FILE* file, uint64_t* value)
+{
+    int shift = 0;
+    int c;
+
+    *value = 0;
+    while ((c = fgetc(file)) != EOF)
+    {
+        *value |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            return true;
+        }
+
+        shift += 7;
+        if (shift > 63) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+static bool
+get_u32 (FILE* file, uint32_t* value)
+{
+    uint64_t tmp;
+
+    if (!get_varint(file, &tmp)) {
+        return false;
+    }
+
+    *value = (uint32_t)tmp;
+
+    return true;
+}
+
+static bool
+get_signed (FILE* file, int64_t* value)
+{
+    uint64_t tmp;
+
+    if (!get_varint(file, &tmp)) {
+        return false;
+    }
+
+    *value = (int64_t)(tmp >> 1) ^ -(int64_t)(tmp & 1);
+
+    return true;
+}
+
+static bool
+get_int (FILE* file, int* value)
+{
+    int64_t tmp;
+
+    if (!get_signed(file, &tmp)) {
+        return false;
+    }
+
+    *value = (int)tmp;
+
+    return true;
+}
+
+static bool
+get_string (FILE* file, std::string* value)
+{
+    uint64_t size;
+
+    if (!get_varint(file, &size) || (size > 65536)) {
+        return false;
+    }
+
+    value->resize(size);
+
+    return fread(&(*value)[0], 1, size, file) == size;
+}
+
+static bool
+is_view_event (dbus_event_type_t type)
+{
+    return (type == DBUS_EVENT_VIEW_SNAPSHOT) ||
+           (type == DBUS_EVENT_POINTER_BUTTON) ||
+           (type == DBUS_EVENT_TABLET_BUTTON) ||
+           ((type >= DBUS_EVENT_VIEW_ADDED) &&
+            (type <= DBUS_EVENT_VIEW_KEEP_ABOVE)) ||
+           (type == DBUS_EVENT_VIEW_PARENT_CHANGED);
+}
+
+static bool
+is_output_event (dbus_event_type_t type)
+{
+    return (type == DBUS_EVENT_OUTPUT_SNAPSHOT) ||
+           ((type >= DBUS_EVENT_OUTPUT_CONFIGURATION_CHANGED) &&
+            (type <= DBUS_EVENT_OUTPUT_REMOVED));
+}
+
+static void
+put_header (dbus_event_type_t type, uint32_t id, int64_t arg0, int64_t arg1,
+            int64_t arg2, int64_t arg3)
+{
+    uint64_t now = now_ns() - trace_start_ns;
+
+    fputc(type, dbus_event_trace_file);
+    put_varint(now - trace_last_ns);
+    trace_last_ns = now;
+    put_varint(id);
+    put_signed(arg0);
+    put_signed(arg1);
+    put_signed(arg2);
+    put_signed(arg3);
+}
+
+void
+dbus_event_trace_write_view (dbus_event_type_t type, dbus_view_t* view,
+                             int64_t arg0, int64_t arg1, int64_t arg2,
+                             int64_t arg3)
+{
+    dbus_output_t* output;
+    dbus_geometry_t geometry = {0, 0, 0, 0};
+    uint32_t flags = 0;
+    pid_t pid = 0;
+    uid_t uid;
+    gid_t gid;
+
+    if (!dbus_event_trace_file) {
+        return;
+    }
+
+    put_header(type, view ? view->get_id() : 0, arg0, arg1, arg2, arg3);
+    if (!view) {
+        /* an empty state, the replay skips view events without a view */
+        put_varint(0);
+        put_varint(0);
+        put_string("");
+        put_string("");
+        for (int i = 0; i < 4; i++)
+        {
+            put_signed(0);
+        }
+
+        put_varint(0);
+        put_varint(0);
+        put_varint(0);
+
+        return;
+    }
+
+    output = view->get_output();
+    if (output) {
+        geometry = view->get_output_geometry();
+    }
+
+    view->get_client_credentials(&pid, &uid, &gid);
+    flags |= view->is_mapped() ? DBUS_EVENT_MAPPED : 0;
+    flags |= view->is_minimized() ? DBUS_EVENT_MINIMIZED : 0;
+    flags |= view->is_maximized() ? DBUS_EVENT_MAXIMIZED : 0;
+    flags |= view->is_fullscreen() ? DBUS_EVENT_FULLSCREEN : 0;
+    flags |= view->is_activated() ? DBUS_EVENT_ACTIVATED : 0;
+    flags |= view->is_above() ? DBUS_EVENT_ABOVE : 0;
+    flags |= view->demands_attention() ? DBUS_EVENT_ATTENTION : 0;
+
+    put_varint(view->get_role());
+    put_varint(output ? output->get_id() : 0);
+    put_string(view->get_app_id());
+    put_string(view->get_title());
+    put_signed(geometry.x);
+    put_signed(geometry.y);
+    put_signed(geometry.width);
+    put_signed(geometry.height);
+    put_varint(flags);
+    put_varint(view->get_xwayland_window_id());
+    put_varint(pid);
+}
+
+void
+dbus_event_trace_write_output (dbus_event_type_t type, dbus_output_t* output,
+                               int64_t arg0, int64_t arg1)
+{
+    dbus_workspace_t workspace = {0, 0};
+    dbus_workspace_t grid = {0, 0};
+
+    if (!dbus_event_trace_file) {
+        return;
+    }
+
+    put_header(type, output ? output->get_id() : 0, arg0, arg1, 0, 0);
+    if (output) {
+        workspace = output->get_workspace();
+        grid = output->get_workspace_grid_size();
+    }
+
+    put_string(output ? output->get_name() : "");
+    put_signed(workspace.x);
+    put_signed(workspace.y);
+    put_signed(grid.x);
+    put_signed(grid.y);
+}
+
+bool
+dbus_event_trace_open (const char* path)
+{
+    dbus_event_trace_close();
+    dbus_event_trace_file = fopen(path, "wb");
+    if (!dbus_event_trace_file) {
+        return false;
+    }
+
+    setvbuf(dbus_event_trace_file, nullptr, _IOFBF, 1 << 16);
+    fwrite(EVENT_TRACE_MAGIC, 1, strlen(EVENT_TRACE_MAGIC),
+           dbus_event_trace_file);
+    trace_start_ns = now_ns();
+    trace_last_ns  = 0;
+
+    for (dbus_output_t* output : dbus_core->get_outputs())
+    {
+        dbus_event_trace_write_output(DBUS_EVENT_OUTPUT_SNAPSHOT, output, 0, 0);
+    }
+
+    for (dbus_view_t* view : dbus_core->get_all_views())
+    {
+        dbus_event_trace_write_view(DBUS_EVENT_VIEW_SNAPSHOT, view, 0, 0, 0, 0);
+    }
+
+    return true;
+}
+
+void
+dbus_event_trace_close ()
+{
+    if (dbus_event_trace_file) {
+        fclose(dbus_event_trace_file);
+        dbus_event_trace_file = nullptr;
+    }
+}
+
+FILE*
+dbus_event_trace_open_read (const char* path)
+{
+    char magic [sizeof(EVENT_TRACE_MAGIC) - 1];
+    FILE* file = fopen(path, "rb");
+
+    if (!file) {
+        return nullptr;
+    }
+
+    if ((fread(magic, 1, sizeof(magic), file) != sizeof(magic)) ||
+        (memcmp(magic, EVENT_TRACE_MAGIC, sizeof(magic)) != 0)) {
+        fclose(file);
+
+        return nullptr;
+    }
+
+    return file;
+}
+
+bool
+dbus_event_trace_read (FILE* file, dbus_event_t* event)
+{
+    uint64_t delta;
+    int type = fgetc(file);
+
+    if ((type == EOF) || (type >= DBUS_EVENT_TYPE_COUNT)) {
+        return false;
+    }
+
+    event->type = (dbus_event_type_t)type;
+    if (!get_varint(file, &delta) || !get_u32(file, &event->id)) {
+        return false;
+    }
+
+    event->time_ns += delta;
+    for (int i = 0; i < 4; i++)
+    {
+        if (!get_signed(file, &event->args[i])) {
+            return false;
+        }
+    }
+
+    if (is_view_event(event->type)) {
+        return get_u32(file, &event->role) &&
+               get_u32(file, &event->output_id) &&
+               get_string(file, &event->app_id) &&
+               get_string(file, &event->title) &&
+               get_int(file, &event->geometry.x) &&
+               get_int(file, &event->geometry.y) &&
+               get_int(file, &event->geometry.width) &&
+               get_int(file, &event->geometry.height) &&
+               get_u32(file, &event->flags) &&
+               get_u32(file, &event->xwayland_window_id) &&
+               get_u32(file, &event->pid);
+    }
+
+    if (is_output_event(event->type)) {
+        return get_string(file, &event->output_name) &&
+               get_int(file, &event->workspace.x) &&
+               get_int(file, &event->workspace.y) &&
+               get_int(file, &event->grid.x) &&
+               get_int(file, &event->grid.y);
+    }
+
+    return true;
+}
@@ -0,0 +1,144 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_event_trace.hpp -- records the compositor events the backend's
+ * hooks receive, so real sessions can be replayed into the hooks
+ * against the synthetic core (bench-event-replay).
+ *
+ * The plugin records when WAYFIRE_DBUS_EVENT_TRACE names a file.
+ * The trace starts with a snapshot of all outputs and views, then
+ * has one record per hook call with the hook's arguments and the
+ * state of its view or output at that time, which is everything
+ * the hook reads from the core.
+ ********************************************************************/
+
+#ifndef DBUS_EVENT_TRACE_HPP
+#define DBUS_EVENT_TRACE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "dbus_core.hpp"
+
+enum dbus_event_type_t : uint8_t
+{
+    DBUS_EVENT_OUTPUT_SNAPSHOT = 0,
+    DBUS_EVENT_VIEW_SNAPSHOT,
+    DBUS_EVENT_POINTER_BUTTON,
+    DBUS_EVENT_TABLET_BUTTON,
+    DBUS_EVENT_VIEW_ADDED,
+    DBUS_EVENT_VIEW_TIMEOUT,
+    DBUS_EVENT_VIEW_CLOSED,
+    DBUS_EVENT_VIEW_APP_ID_CHANGED,
+    DBUS_EVENT_VIEW_TITLE_CHANGED,
+    DBUS_EVENT_VIEW_FULLSCREEN_CHANGED,
+    DBUS_EVENT_VIEW_GEOMETRY_CHANGED,
+    DBUS_EVENT_VIEW_TILED,
+    DBUS_EVENT_VIEW_OUTPUT_MOVED,
+    DBUS_EVENT_VIEW_OUTPUT_MOVE_REQUESTED,
+    DBUS_EVENT_VIEW_ROLE_CHANGED,
+    DBUS_EVENT_VIEW_WORKSPACES_CHANGED,
+    DBUS_EVENT_VIEW_MAXIMIZED,
+    DBUS_EVENT_VIEW_MINIMIZED,
+    DBUS_EVENT_VIEW_FOCUS_CHANGED,
+    DBUS_EVENT_VIEW_HINTS_CHANGED,
+    DBUS_EVENT_VIEW_MOVING,
+    DBUS_EVENT_VIEW_RESIZING,
+    DBUS_EVENT_VIEW_KEEP_ABOVE,
+    DBUS_EVENT_OUTPUT_CONFIGURATION_CHANGED,
+    DBUS_EVENT_OUTPUT_WORKSPACE_CHANGED,
+    DBUS_EVENT_OUTPUT_ADDED,
+    DBUS_EVENT_OUTPUT_REMOVED,
+    /* added later, kept last so older traces still read */
+    DBUS_EVENT_VIEW_PARENT_CHANGED,
+    DBUS_EVENT_TYPE_COUNT,
+};
+
+/* view state flags */
+#define DBUS_EVENT_MAPPED     (1 << 0)
+#define DBUS_EVENT_MINIMIZED  (1 << 1)
+#define DBUS_EVENT_MAXIMIZED  (1 << 2)
+#define DBUS_EVENT_FULLSCREEN (1 << 3)
+#define DBUS_EVENT_ACTIVATED  (1 << 4)
+#define DBUS_EVENT_ABOVE      (1 << 5)
+#define DBUS_EVENT_ATTENTION  (1 << 6)
+
+struct dbus_event_t
+{
+    dbus_event_type_t type;
+    /* since the start of the trace */
+    uint64_t time_ns;
+    /* the view or output, 0 if there is none */
+    uint32_t id;
+    /* the hook's own arguments, see dbus_event_trace.cpp */
+    int64_t args[4];
+
+    /* view events */
+    uint32_t role;
+    uint32_t output_id;
+    std::string app_id;
+    std::string title;
+    dbus_geometry_t geometry;
+    uint32_t flags;
+    uint32_t xwayland_window_id;
+    uint32_t pid;
+
+    /* output events */
+    std::string output_name;
+    dbus_workspace_t workspace;
+    dbus_workspace_t grid;
+};
+
+/* the open trace, nullptr while not recording */
+extern FILE* dbus_event_trace_file;
+
+/***
+ * Starts recording into path with a snapshot of the core's outputs
+ * and views. false if the file can't be written.
+ ***/
+bool dbus_event_trace_open (const char* path);
+void dbus_event_trace_close ();
+
+void dbus_event_trace_write_view (dbus_event_type_t type, dbus_view_t* view,
+                                  int64_t arg0, int64_t arg1, int64_t arg2,
+                                  int64_t arg3);
+void dbus_event_trace_write_output (dbus_event_type_t type,
+                                    dbus_output_t* output, int64_t arg0,
+                                    int64_t arg1);
+
+/***
+ * For the hooks, a pointer check while not recording.
+ ***/
+static inline void
+dbus_event_record_view (dbus_event_type_t type, dbus_view_t* view,
+                        int64_t arg0 = 0, int64_t arg1 = 0, int64_t arg2 = 0,
+                        int64_t arg3 = 0)
+{
+    if (dbus_event_trace_file) {
+        dbus_event_trace_write_view(type, view, arg0, arg1, arg2, arg3);
+    }
+}
+
+static inline void
+dbus_event_record_output (dbus_event_type_t type, dbus_output_t* output,
+                          int64_t arg0 = 0, int64_t arg1 = 0)
+{
+    if (dbus_event_trace_file) {
+        dbus_event_trace_write_output(type, output, arg0, arg1);
+    }
+}
+
+/***
+ * Opens a trace for reading, nullptr if it is not one.
+ ***/
+FILE* dbus_event_trace_open_read (const char* path);
+
+/***
+ * The next event, false at the end of the trace or on a damaged
+ * record. Times are accumulated in event->time_ns, pass the same
+ * event every time, zeroed at first.
+ ***/
+bool dbus_event_trace_read (FILE* file, dbus_event_t* event);
+
+#endif
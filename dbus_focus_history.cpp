@@ -0,0 +1,177 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_focus_history.cpp -- the history is a doubly linked list
+ * threaded through the index: each view id maps to the ids before
+ * and after it, so moving a view to the front or dropping it only
+ * touches its neighbours.
+ ********************************************************************/
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "dbus_focus_history.hpp"
+
+/* view ids, 0 at the ends of the list */
+struct focus_link_t
+{
+    uint32_t newer;
+    uint32_t older;
+};
+
+static std::unordered_map<uint32_t, focus_link_t> links;
+static uint32_t newest = 0;
+static uint32_t oldest = 0;
+static bool history_valid = false;
+
+static void
+history_unlink (std::unordered_map<uint32_t, focus_link_t>::iterator link)
+{
+    uint32_t newer = link->second.newer;
+    uint32_t older = link->second.older;
+
+    if (newer) {
+        links[newer].older = older;
+    }
+    else
+    {
+        newest = older;
+    }
+
+    if (older) {
+        links[older].newer = newer;
+    }
+    else
+    {
+        oldest = newer;
+    }
+}
+
+static void
+history_append (uint32_t view_id)
+{
+    links[view_id] = {oldest, 0};
+    if (oldest) {
+        links[oldest].older = view_id;
+    }
+    else
+    {
+        newest = view_id;
+    }
+
+    oldest = view_id;
+}
+
+static bool
+is_listed (dbus_view_t* view)
+{
+    return view->is_mapped() && (view->get_role() == DBUS_VIEW_ROLE_TOPLEVEL);
+}
+
+static void
+history_revalidate ()
+{
+    std::unordered_set<uint32_t> listed;
+    std::unordered_map<uint32_t, focus_link_t>::iterator link;
+    uint32_t view_id;
+
+    for (dbus_view_t* view : dbus_core->get_all_views())
+    {
+        if (is_listed(view)) {
+            listed.insert(view->get_id());
+        }
+    }
+
+    for (view_id = newest; view_id != 0;)
+    {
+        link    = links.find(view_id);
+        view_id = link->second.older;
+        if (listed.erase(link->first) == 0) {
+            history_unlink(link);
+            links.erase(link);
+        }
+    }
+
+    for (dbus_output_t* output : dbus_core->get_outputs())
+    {
+        for (dbus_view_t* view : dbus_core->get_stacked_views(output))
+        {
+            if (listed.erase(view->get_id())) {
+                history_append(view->get_id());
+            }
+        }
+    }
+
+    /* not in the middle layers */
+    for (uint32_t id : listed)
+    {
+        history_append(id);
+    }
+
+    history_valid = true;
+}
+
+void
+dbus_focus_history_push (uint32_t view_id)
+{
+    std::unordered_map<uint32_t, focus_link_t>::iterator link;
+
+    if (view_id == newest) {
+        return;
+    }
+
+    link = links.find(view_id);
+    if (link != links.end()) {
+        history_unlink(link);
+    }
+
+    links[view_id] = {0, newest};
+    if (newest) {
+        links[newest].newer = view_id;
+    }
+    else
+    {
+        oldest = view_id;
+    }
+
+    newest = view_id;
+}
+
+void
+dbus_focus_history_remove (uint32_t view_id)
+{
+    std::unordered_map<uint32_t, focus_link_t>::iterator link;
+
+    link = links.find(view_id);
+    if (link == links.end()) {
+        return;
+    }
+
+    history_unlink(link);
+    links.erase(link);
+}
+
+void
+dbus_focus_history_invalidate ()
+{
+    history_valid = false;
+}
+
+void
+dbus_focus_history_get (uint32_t limit, std::vector<uint32_t>* ids)
+{
+    uint32_t view_id;
+
+    if (!history_valid && dbus_core) {
+        history_revalidate();
+    }
+
+    for (view_id = newest; view_id != 0; view_id = links[view_id].older)
+    {
+        if ((limit != 0) && (ids->size() >= limit)) {
+            break;
+        }
+
+        ids->push_back(view_id);
+    }
+}
@@ -0,0 +1,40 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_focus_history.hpp -- the toplevels in most recently focused
+ * order, for query_focus_history. Kept from the focus and unmap
+ * hooks, so a switcher started late still gets the session's order.
+ ********************************************************************/
+
+#ifndef DBUS_FOCUS_HISTORY_HPP
+#define DBUS_FOCUS_HISTORY_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+/***
+ * view_id becomes the most recent, O(1).
+ ***/
+void dbus_focus_history_push (uint32_t view_id);
+
+/***
+ * An unmapped view leaves the history, O(1).
+ ***/
+void dbus_focus_history_remove (uint32_t view_id);
+
+/***
+ * The history is checked against dbus_core on the next query:
+ * views that are gone leave it, toplevels it doesn't know yet are
+ * added after the others in stacking order, e.g. when the plugin
+ * is loaded into a running session.
+ ***/
+void dbus_focus_history_invalidate ();
+
+/***
+ * Most recent first, at most limit ids (0 for all).
+ ***/
+void dbus_focus_history_get (uint32_t limit, std::vector<uint32_t>* ids);
+
+#endif
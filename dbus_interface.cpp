@@ -39,8 +39,12 @@ extern "C" {
 
 #include <wayfire/signal-definitions.hpp>
 
-#include "dbus_interface_backend.cpp"
-gboolean geometry_signal = FALSE;
+#include "dbus_core_wayfire.hpp"
+#include "dbus_event_trace.hpp"
+#include "dbus_interface_backend.hpp"
+
+GSettings* settings;
+static wayfire_dbus_core_t wayfire_dbus_core;
 
 static void
 settings_changed (GSettings* settings, const gchar* key,
@@ -66,6 +70,7 @@ class dbus_interface_t
         LOG(wf::log::LOG_LEVEL_DEBUG, "Loading DBus Plugin");
 #endif
 
+        dbus_core = &wayfire_dbus_core;
         settings = g_settings_new("org.wayland.compositor.dbus");
         for (wf::output_t* output : wf_outputs)
         {
@@ -75,7 +80,8 @@ class dbus_interface_t
             grab_interfaces[output]->capabilities = wf::CAPABILITY_GRAB_INPUT;
             output->connect_signal("view-mapped", &output_view_added);
 
-            output->connect_signal("wm-actions-above-changed", &on_view_keep_above);
+            output->connect_signal("wm-actions-above-changed",
+                                   &view_keep_above_changed);
 
             output->connect_signal("output-configuration-changed",
                                    &output_configuration_changed);
@@ -120,6 +126,8 @@ class dbus_interface_t
 
             view->connect_signal("ping-timeout", &view_timeout);
 
+            view->connect_signal("parent-changed", &view_parent_changed);
+
             // view->connect_signal("subsurface-added", &subsurface_added);
         }
 
@@ -147,6 +155,12 @@ class dbus_interface_t
         g_signal_connect(settings, "changed", G_CALLBACK(settings_changed), NULL);
         geometry_signal = g_settings_get_boolean(settings, "geometry-signal");
 
+        /* for bench-event-replay */
+        const char* event_trace_path = getenv("WAYFIRE_DBUS_EVENT_TRACE");
+        if (event_trace_path && !dbus_event_trace_open(event_trace_path)) {
+            LOGE("Cannot write the event trace ", event_trace_path);
+        }
+
         acquire_bus();
         gchar *startup_notify_cmd = NULL;
         startup_notify_cmd = g_settings_get_string(settings, "startup-notify");
@@ -170,8 +184,10 @@ class dbus_interface_t
         LOG(wf::log::LOG_LEVEL_DEBUG, "Unloading DBus Plugin");
 #endif
 
-        g_bus_unown_name(owner_id);
-        g_dbus_node_info_unref(introspection_data);
+        dbus_event_trace_close();
+        release_bus();
+        /* views destroyed from now on are not reported to the backend */
+        dbus_core = nullptr;
         g_object_unref(settings);
         dbus_scale_filter::unload();
     }
@@ -182,51 +198,34 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t pointer_button_signal{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "pointer_button_signal");
-#endif
             wf::pointf_t cursor_position;
-            GVariant* signal_data;
             wf::input_event_signal<wlr_event_pointer_button>* wf_ev;
             wlr_event_pointer_button* wlr_signal;
-            wlr_button_state button_state;
             bool button_released;
-            uint32_t button;
+            wayfire_view view;
 
             cursor_position = core.get_cursor_position();
             wf_ev =
                 static_cast<wf::input_event_signal<wlr_event_pointer_button>*> (data);
             wlr_signal = static_cast<wlr_event_pointer_button*> (wf_ev->event);
-            button_state = wlr_signal->state;
-            button = wlr_signal->button;
-            button_released = (button_state == WLR_BUTTON_RELEASED);
+            button_released = (wlr_signal->state == WLR_BUTTON_RELEASED);
 
             if (find_view_under_action && button_released) {
-                GVariant* _signal_data;
-                wayfire_view view;
                 view = core.get_view_at(cursor_position);
-                _signal_data = g_variant_new("(u)", view ? view->get_id() : 0);
-                g_variant_ref(_signal_data);
-                bus_emit_signal("view_pressed", _signal_data);
             }
 
-            signal_data = g_variant_new("(ddub)", cursor_position.x, cursor_position.y,
-                                        button, button_released);
-            g_variant_ref(signal_data);
-            bus_emit_signal("pointer_clicked", signal_data);
+            on_pointer_button({cursor_position.x, cursor_position.y},
+                              wlr_signal->button, button_released,
+                              get_dbus_view(view));
         }
     };
 
     /***
      * A tablet button is interacted with
-     * TODO: do more for touch events
      ***/
     wf::signal_connection_t tablet_button_signal{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "tablet_button_signal");
-#endif
-            bus_emit_signal("tablet_touched", nullptr);
+            on_tablet_button();
         }
     };
 
@@ -235,32 +234,21 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t output_view_added{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_added");
-#endif
-
-            GVariant* signal_data;
             wayfire_view view;
 
             view = get_signaled_view(data);
+            on_view_added(get_dbus_view(view));
             if (!view) {
-#ifdef DBUS_PLUGIN_DEBUG
-                LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_added no view");
-#endif
-
                 return;
             }
 
-            signal_data = g_variant_new("(u)", view->get_id());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_added", signal_data);
-
             view->connect_signal("app-id-changed", &view_app_id_changed);
             view->connect_signal("title-changed", &view_title_changed);
             view->connect_signal("geometry-changed", &view_geometry_changed);
             view->connect_signal("unmapped", &view_closed);
             view->connect_signal("tiled", &view_tiled);
             view->connect_signal("ping-timeout", &view_timeout);
+            view->connect_signal("parent-changed", &view_parent_changed);
             // view->connect_signal("subsurface-added", &subsurface_added);
         }
     };
@@ -274,21 +262,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_timeout{[=] (wf::signal_data_t* data)
         {
-            GVariant* signal_data;
-            wayfire_view view;
-            view = get_signaled_view(data);
-
-            if (!view) {
-                LOGE("view_timeout no view");
-
-                return;
-            }
-
-            LOGE("view_timeout ", view->get_id());
-
-            signal_data = g_variant_new("(u)", view->get_id());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_timeout", signal_data);
+            on_view_timeout(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -297,26 +271,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_closed{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_closed");
-#endif
-
-            GVariant* signal_data;
-            wayfire_view view;
-
-            view = get_signaled_view(data);
-
-            if (!view) {
-#ifdef DBUS_PLUGIN_DEBUG
-                LOG(wf::log::LOG_LEVEL_DEBUG, "view_closed no view");
-#endif
-
-                return;
-            }
-
-            signal_data = g_variant_new("(u)", view->get_id());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_closed", signal_data);
+            on_view_closed(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -325,27 +280,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_app_id_changed{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_app_id_changed");
-#endif
-
-            GVariant* signal_data;
-            wayfire_view view;
-
-            view = get_signaled_view(data);
-            if (!view) {
-#ifdef DBUS_PLUGIN_DEBUG
-
-                LOG(wf::log::LOG_LEVEL_DEBUG, "view_app_id_changed no view");
-#endif
-
-                return;
-            }
-
-            signal_data =
-                g_variant_new("(us)", view->get_id(), view->get_app_id().c_str());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_app_id_changed", signal_data);
+            on_view_app_id_changed(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -354,22 +289,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_title_changed{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_title_changed");
-#endif
-
-            GVariant* signal_data;
-            wayfire_view view;
-
-            view = get_signaled_view(data);
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            signal_data =
-                g_variant_new("(us)", view->get_id(), view->get_title().c_str());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_title_changed", signal_data);
+            on_view_title_changed(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -378,19 +298,10 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_fullscreen_changed{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_fullscreened");
-#endif
-
             wf::view_fullscreen_signal* signal;
-            GVariant* signal_data;
-            wayfire_view view;
 
             signal = static_cast<wf::view_fullscreen_signal*> (data);
-            view = signal->view;
-            signal_data = g_variant_new("(ub)", view->get_id(), signal->state);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_fullscreen_changed", signal_data);
+            on_view_fullscreen_changed(get_dbus_view(signal->view), signal->state);
         }
     };
 
@@ -399,25 +310,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_geometry_changed{[=] (wf::signal_data_t* data)
         {
-            if (!geometry_signal) {
-                return;
-            }
-
-#ifdef DBUS_PLUGIN_DEBUG
-
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_geometry_changed");
-#endif
-
-            GVariant* signal_data;
-            wayfire_view view;
-            wf::geometry_t geometry;
-
-            view = get_signaled_view(data);
-            geometry = view->get_output_geometry();
-            signal_data = g_variant_new("(uiiii)", view->get_id(), geometry.x,
-                                        geometry.y, geometry.width, geometry.height);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_geometry_changed", signal_data);
+            on_view_geometry_changed(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -426,24 +319,10 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_tiled{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_tiled");
-#endif
-
-            GVariant* signal_data;
             wf::view_tiled_signal* signal;
-            wayfire_view view;
 
             signal = static_cast<wf::view_tiled_signal*> (data);
-            view = signal->view;
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            signal_data = g_variant_new("(uu)", view->get_id(), signal->new_edges);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_tiling_changed", signal_data);
+            on_view_tiled(get_dbus_view(signal->view), signal->new_edges);
         }
     };
 
@@ -452,30 +331,12 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_output_moved{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_output_moved");
-#endif
-
             wf::view_moved_to_output_signal* signal;
-            GVariant* signal_data;
-            wayfire_view view;
-            wf::output_t* old_output;
-            wf::output_t* new_output;
 
             signal = static_cast<wf::view_moved_to_output_signal*> (data);
-            view = signal->view;
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            old_output = signal->old_output;
-            new_output = signal->new_output;
-
-            signal_data = g_variant_new("(uuu)", view->get_id(), old_output->get_id(),
-                                        new_output->get_id());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_output_moved", signal_data);
+            on_view_output_moved(get_dbus_view(signal->view),
+                                 signal->old_output->get_id(),
+                                 signal->new_output->get_id());
         }
     };
 
@@ -485,28 +346,16 @@ class dbus_interface_t
     wf::signal_connection_t view_output_move_requested{
         [=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_output_move_requested");
-#endif
-
-            GVariant* signal_data;
             wf::view_pre_moved_to_output_signal* signal;
-            wf::output_t* old_output;
-            wf::output_t* new_output;
-            wayfire_view view;
 
             signal = static_cast<wf::view_pre_moved_to_output_signal*> (data);
-            view = signal->view;
-
-            if (view) {
-                old_output = signal->old_output;
-                new_output = signal->new_output;
-                signal_data =
-                    g_variant_new("(uuu)", view->get_id(), old_output->get_id(),
-                                  new_output->get_id());
-                g_variant_ref(signal_data);
-                bus_emit_signal("view_output_move_requested", signal_data);
+            if (!signal->view) {
+                return;
             }
+
+            on_view_output_move_requested(get_dbus_view(signal->view),
+                                          signal->old_output->get_id(),
+                                          signal->new_output->get_id());
         }
     };
 
@@ -515,42 +364,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t role_changed{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "role_changed");
-#endif
-
-            GVariant* signal_data;
-            wayfire_view view;
-
-            view = get_signaled_view(data);
-
-            if (!view) {
-#ifdef DBUS_PLUGIN_DEBUG
-                LOG(wf::log::LOG_LEVEL_DEBUG, "role_changed no view");
-#endif
-
-                return;
-            }
-
-            uint role = 0;
-
-            if (view->role == wf::VIEW_ROLE_TOPLEVEL) {
-                role = 1;
-            }
-            else
-            if (view->role == wf::VIEW_ROLE_DESKTOP_ENVIRONMENT)
-            {
-                role = 2;
-            }
-            else
-            if (view->role == wf::VIEW_ROLE_UNMANAGED)
-            {
-                role = 3;
-            }
-
-            signal_data = g_variant_new("(uu)", view->get_id(), role);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_role_changed", signal_data);
+            on_view_role_changed(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -559,25 +373,10 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t view_workspaces_changed{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_workspaces_changed");
-#endif
-
-            GVariant* signal_data;
             wf::view_change_workspace_signal* signal;
-            wayfire_view view;
 
             signal = static_cast<wf::view_change_workspace_signal*> (data);
-            view = signal->view;
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            signal_data = g_variant_new("(u)", view->get_id());
-
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_workspaces_changed", signal_data);
+            on_view_workspaces_changed(get_dbus_view(signal->view));
         }
     };
 
@@ -586,26 +385,11 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t output_view_maximized{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_maximized");
-#endif
-
             wf::view_tiled_signal* signal;
-            GVariant* signal_data;
-            wayfire_view view;
-            bool maximized;
 
             signal = static_cast<wf::view_tiled_signal*> (data);
-            view = signal->view;
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            maximized = (signal->new_edges == wf::TILED_EDGES_ALL);
-            signal_data = g_variant_new("(ub)", view->get_id(), maximized);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_maximized_changed", signal_data);
+            on_view_maximized(get_dbus_view(signal->view),
+                              signal->new_edges == wf::TILED_EDGES_ALL);
         }
     };
 
@@ -614,26 +398,10 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t output_view_minimized{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_minimized");
-#endif
-
-            GVariant* signal_data;
             wf::view_minimize_request_signal* signal;
-            wayfire_view view;
-            bool minimized;
 
             signal = static_cast<wf::view_minimize_request_signal*> (data);
-            view = signal->view;
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            minimized = signal->state;
-            signal_data = g_variant_new("(ub)", view->get_id(), minimized);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_minimized_changed", signal_data);
+            on_view_minimized(get_dbus_view(signal->view), signal->state);
         }
     };
 
@@ -643,50 +411,10 @@ class dbus_interface_t
     wf::signal_connection_t output_view_focus_changed{
         [=] (wf::signal_data_t* data)
         {
-            GVariant* signal_data;
             wf::focus_view_signal* signal;
-            wayfire_view view;
-            uint view_id;
 
             signal = static_cast<wf::focus_view_signal*> (data);
-            view = signal->view;
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            view_id = view->get_id();
-
-            if (view_id == focused_view_id) {
-#ifdef DBUS_PLUGIN_DEBUG
-                LOG(wf::log::LOG_LEVEL_DEBUG,
-                    "output_view_focus_changed old focus view");
-#endif
-
-                return;
-            }
-
-            if (view->role != wf::VIEW_ROLE_TOPLEVEL) {
-#ifdef DBUS_PLUGIN_DEBUG
-                LOG(wf::log::LOG_LEVEL_DEBUG,
-                    "output_view_focus_changed not a toplevel ");
-#endif
-
-                return;
-            }
-
-            if (!view->activated) {
-                return;
-            }
-
-            if (view->has_data("view-demands-attention")) {
-                view->erase_data("view-demands-attention");
-            }
-
-            focused_view_id = view_id;
-            signal_data = g_variant_new("(u)", view_id);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_focus_changed", signal_data);
+            on_view_focus_changed(get_dbus_view(signal->view));
         }
     };
 
@@ -702,11 +430,8 @@ class dbus_interface_t
 #ifdef DBUS_PLUGIN_DEBUG
             LOG(wf::log::LOG_LEVEL_DEBUG, "view_focus_request_signal");
 #endif
-            bool reconfigure = true;
             wf::view_focus_request_signal* signal;
             wayfire_view view;
-            wf::output_t* active_output;
-            wf::output_t* view_output;
 
             signal = static_cast<wf::view_focus_request_signal*> (data);
             if (signal->carried_out) {
@@ -719,12 +444,10 @@ class dbus_interface_t
 
             view = signal->view;
 
-            if (!check_view_toplevel) {
+            if (!view) {
                 return;
             }
 
-            active_output = core.get_active_output();
-            view_output = view->get_output();
             // it is possible to also change the view''s
             // output e.g for single window applications
             // but other applications call sef_request_focus
@@ -751,34 +474,9 @@ class dbus_interface_t
     wf::signal_connection_t view_hints_changed{[=] (wf::signal_data_t* data)
         {
             wf::view_hints_changed_signal* signal;
-            GVariant* signal_data;
-            bool view_wants_attention = false;
-            wayfire_view view;
 
             signal = static_cast<wf::view_hints_changed_signal*> (data);
-            view = signal->view;
-
-            if (!check_view_toplevel) {
-#ifdef DBUS_PLUGIN_DEBUG
-
-                LOG(wf::log::LOG_LEVEL_DEBUG, "view_hints_changed no view");
-#endif
-
-                return;
-            }
-
-#ifdef DBUS_PLUGIN_DEBUG
-
-            LOG(wf::log::LOG_LEVEL_DEBUG, "view_hints_changed",
-                view->has_data("view-demands-attention"));
-#endif
-            if (view->has_data("view-demands-attention")) {
-                view_wants_attention = true;
-            }
-
-            signal_data = g_variant_new("(ub)", view->get_id(), view_wants_attention);
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_attention_changed", signal_data);
+            on_view_hints_changed(get_dbus_view(signal->view));
         }
     };
 
@@ -789,22 +487,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t output_view_moving{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_moving");
-#endif
-
-            GVariant* signal_data;
-            wayfire_view view;
-
-            view = get_signaled_view(data);
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            signal_data = g_variant_new("(u)", view->get_id());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_moving_changed", signal_data);
+            on_view_moving(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -815,22 +498,7 @@ class dbus_interface_t
      ***/
     wf::signal_connection_t output_view_resizing{[=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_resizing");
-#endif
-
-            GVariant* signal_data;
-            wayfire_view view;
-
-            view = get_signaled_view(data);
-
-            if (!check_view_toplevel) {
-                return;
-            }
-
-            signal_data = g_variant_new("(u)", view->get_id());
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_resizing_changed", signal_data);
+            on_view_resizing(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -838,21 +506,19 @@ class dbus_interface_t
      * The wm-actions plugin changed the above_layer
      * state of a view.
      ***/
-    wf::signal_connection_t on_view_keep_above{[=] (wf::signal_data_t* data)
+    wf::signal_connection_t view_keep_above_changed{[=] (wf::signal_data_t* data)
         {
-            GVariant* signal_data;
-            wayfire_view view;
-
-            view = wf::get_signaled_view(data);
-
-            if (!check_view_toplevel) {
-                return;
-            }
+            on_view_keep_above(get_dbus_view(wf::get_signaled_view(data)));
+        }
+    };
 
-            signal_data = g_variant_new("(ub)", view->get_id(),
-                                        view->has_data("wm-actions-above"));
-            g_variant_ref(signal_data);
-            bus_emit_signal("view_keep_above_changed", signal_data);
+    /***
+     * The view's parent has changed, it became a dialog
+     * of another view or stopped being one.
+     ***/
+    wf::signal_connection_t view_parent_changed{[=] (wf::signal_data_t* data)
+        {
+            on_view_parent_changed(get_dbus_view(get_signaled_view(data)));
         }
     };
 
@@ -892,11 +558,8 @@ class dbus_interface_t
     wf::signal_connection_t output_configuration_changed{
         [=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_configuration_changed");
-#endif
-
-            bus_emit_signal("output_configuration_changed", nullptr);
+            on_output_configuration_changed(
+                get_dbus_output(get_signaled_output(data)));
         }
     };
 
@@ -906,26 +569,12 @@ class dbus_interface_t
     wf::signal_connection_t output_workspace_changed{
         [=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_workspace_changed");
-#endif
-
             wf::workspace_changed_signal* signal;
-            GVariant* signal_data;
-            wf::output_t* output;
-            int newHorizontalWorkspace;
-            int newVerticalWorkspace;
 
             signal = static_cast<wf::workspace_changed_signal*> (data);
-            newHorizontalWorkspace = signal->new_viewport.x;
-            newVerticalWorkspace = signal->new_viewport.y;
-            output = signal->output;
-            signal_data =
-                g_variant_new("(uii)", output->get_id(), newHorizontalWorkspace,
-                              newVerticalWorkspace);
-
-            g_variant_ref(signal_data);
-            bus_emit_signal("output_workspace_changed", signal_data);
+            on_output_workspace_changed(get_dbus_output(signal->output),
+                                        signal->new_viewport.x,
+                                        signal->new_viewport.y);
         }
     };
 
@@ -935,11 +584,7 @@ class dbus_interface_t
     wf::signal_connection_t output_layout_output_added{
         [=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_layout_output_added");
-#endif
             wf::output_t* output;
-            GVariant* signal_data;
 
             output = get_signaled_output(data);
             auto search = connected_wf_outputs.find(output);
@@ -953,7 +598,8 @@ class dbus_interface_t
             grab_interfaces[output]->name = "dbus";
             grab_interfaces[output]->capabilities = wf::CAPABILITY_GRAB_INPUT;
 
-            output->connect_signal("wm-actions-above-changed", &on_view_keep_above);
+            output->connect_signal("wm-actions-above-changed",
+                                   &view_keep_above_changed);
 
             output->connect_signal("view-fullscreen-request",
                                    &view_fullscreen_changed);
@@ -985,9 +631,7 @@ class dbus_interface_t
             wf_outputs = core.output_layout->get_outputs();
             connected_wf_outputs.insert(output);
 
-            signal_data = g_variant_new("(u)", output->get_id());
-            g_variant_ref(signal_data);
-            bus_emit_signal("output_added", signal_data);
+            on_output_added(get_dbus_output(output));
         }
     };
 
@@ -997,10 +641,6 @@ class dbus_interface_t
     wf::signal_connection_t output_layout_output_removed{
         [=] (wf::signal_data_t* data)
         {
-#ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "output_layout_output_removed");
-#endif
-            GVariant* signal_data;
             wf::output_t* output;
 
             output = get_signaled_output(data);
@@ -1010,9 +650,7 @@ class dbus_interface_t
                 wf_outputs = core.output_layout->get_outputs();
                 connected_wf_outputs.erase(output);
 
-                signal_data = g_variant_new("(u)", output->get_id());
-                g_variant_ref(signal_data);
-                bus_emit_signal("output_removed", signal_data);
+                on_output_removed(get_dbus_output(output));
             }
 
             grab_interfaces.erase(output);
@@ -5,94 +5,243 @@
 #define DBUS_PLUGIN_DEBUG TRUE
 #define DBUS_PLUGIN_WARN TRUE
 
-extern "C" {
-#define class class_t
-#define static
-#include <X11/Xatom.h>
-#include <wlr/xwayland.h>
-#include <xcb/res.h>
-#include <xcb/xcb.h>
-// #include <xwayland/xwm.h>
-#undef static
-#undef class
-#include <sys/socket.h>
-#include <wlr/types/wlr_idle.h>
-};
-
 #include <gio/gio.h>
-#include <ctime>
-#include <iostream>
-#include <list>
-#include <set>
-
-#include <unistd.h>
-
-#include "dbus_scale_filter.hpp"
-#include "wayfire/view-transform.hpp"
-#include <wayfire/compositor-view.hpp>
-#include <wayfire/core.hpp>
-#include <wayfire/debug.hpp>
-#include <wayfire/gtk-shell.hpp>
-#include <wayfire/option-wrapper.hpp>
-#include <wayfire/output-layout.hpp>
-#include <wayfire/output.hpp>
-#include <wayfire/plugin.hpp>
-#include <wayfire/render-manager.hpp>
-#include <wayfire/signal-definitions.hpp>
-#include <wayfire/util.hpp>
-#include <wayfire/util/duration.hpp>
-#include <wayfire/util/log.hpp>
-#include <wayfire/view.hpp>
-#include <wayfire/workspace-manager.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-wf::option_wrapper_t<bool> xwayland_enabled("core/xwayland");
+#include <wayfire/util/log.hpp>
 
-wf::compositor_core_t& core = wf::get_core();
-std::vector<wf::output_t*> wf_outputs = core.output_layout->get_outputs();
-std::set<wf::output_t*> connected_wf_outputs;
-GSettings* settings;
-std::map<wf::output_t*, std::unique_ptr<wf::plugin_grab_interface_t>>
-grab_interfaces;
+#include "dbus_interface_backend.hpp"
+#include "dbus_app_groups.hpp"
+#include "dbus_event_trace.hpp"
+#include "dbus_focus_history.hpp"
+#include "dbus_output_registry.hpp"
+#include "dbus_query_pool.hpp"
+#include "dbus_signals.hpp"
+#include "dbus_view_index.hpp"
+#include "dbus_view_search.hpp"
+#include "dbus_view_store.hpp"
+#include "dbus_workspace_summary.hpp"
+#include "dbus_xcb_query.hpp"
+
+dbus_core_t* dbus_core = nullptr;
 
 uint focused_view_id;
 bool find_view_under_action = false;
+gboolean geometry_signal = FALSE;
 GDBusNodeInfo* introspection_data = nullptr;
 GDBusConnection* dbus_connection;
-uint owner_id;
+void (*method_reply_sink)(GVariant* reply) = nullptr;
+void (*signal_sink)(const gchar* signal_name, GVariant* signal_data) = nullptr;
+static uint owner_id;
+
+/***
+ * The list replies only change when views are mapped, unmapped or
+ * change their role and when outputs come or go, until then the
+ * built reply is handed out again. list_generation is bumped by
+ * those hooks, by dbus_core_views_changed and dbus_core_view_destroyed.
+ ***/
+struct list_reply_cache_t
+{
+    uint64_t generation = 0;
+    GVariant* reply     = nullptr;
+};
 
-static gboolean
-check_view_toplevel (wayfire_view view)
+static uint64_t list_generation = 1;
+static list_reply_cache_t view_ids_reply;
+static list_reply_cache_t taskman_ids_reply;
+static list_reply_cache_t output_ids_reply;
+
+/***
+ * App ids and titles as GVariant strings, interned by content so
+ * views with the same value share one. A view's strings are kept
+ * until its app-id / title hooks fire or it is unmapped, queries
+ * and signals hand out references to the same immutable string.
+ ***/
+enum view_string_t
 {
-    if (!view) {
-        return FALSE;
+    VIEW_STRING_APP_ID = 0,
+    VIEW_STRING_TITLE,
+    VIEW_STRING_COUNT,
+};
+
+struct interned_string_t
+{
+    GVariant* value = nullptr;
+    uint users = 0;
+};
+
+typedef std::unordered_map<std::string, interned_string_t> interned_strings_t;
+/***
+ * The view keeps the table entry it holds, not the GVariant: the
+ * table is keyed by the std::string the compositor reported, which a
+ * title with an embedded NUL doesn't read back from the variant.
+ ***/
+typedef interned_strings_t::value_type interned_entry_t;
+
+struct view_strings_t
+{
+    interned_entry_t* entries[VIEW_STRING_COUNT] = {nullptr, nullptr};
+};
+
+static interned_strings_t interned_strings;
+static std::unordered_map<uint32_t, view_strings_t> view_strings;
+
+static interned_entry_t*
+string_intern (const std::string& value)
+{
+    interned_entry_t& interned = *interned_strings.emplace(
+        value, interned_string_t()).first;
+
+    if (!interned.second.value) {
+        interned.second.value =
+            g_variant_ref_sink(g_variant_new_string(value.c_str()));
+    }
+
+    interned.second.users++;
+
+    return &interned;
+}
+
+static void
+string_release (interned_entry_t* interned)
+{
+    if (!interned || (--interned->second.users != 0)) {
+        return;
     }
 
+    g_variant_unref(interned->second.value);
+    /* the view's own key, the lookup can't miss */
+    interned_strings.erase(interned_strings.find(interned->first));
+}
+
+/***
+ * The view's string, borrowed. Only mapped views are cached,
+ * view_strings_forget runs when they are unmapped.
+ ***/
+static GVariant*
+view_string (dbus_view_t* view, view_string_t which)
+{
+    interned_entry_t** entry;
+
     if (!view->is_mapped()) {
-        return FALSE;
+        return g_variant_new_string((which == VIEW_STRING_APP_ID) ?
+                                    view->get_app_id().c_str() :
+                                    view->get_title().c_str());
     }
 
-    if (view->role != wf::VIEW_ROLE_TOPLEVEL) {
-        return FALSE;
+    entry = &view_strings[view->get_id()].entries[which];
+    if (!*entry) {
+        *entry = string_intern((which == VIEW_STRING_APP_ID) ?
+                               view->get_app_id() : view->get_title());
+    }
+
+    return (*entry)->second.value;
+}
+
+static void
+view_string_forget (uint32_t view_id, view_string_t which)
+{
+    std::unordered_map<uint32_t, view_strings_t>::iterator strings;
+
+    strings = view_strings.find(view_id);
+    if (strings != view_strings.end()) {
+        string_release(strings->second.entries[which]);
+        strings->second.entries[which] = nullptr;
+    }
+}
+
+static void
+view_strings_forget (uint32_t view_id)
+{
+    view_string_forget(view_id, VIEW_STRING_APP_ID);
+    view_string_forget(view_id, VIEW_STRING_TITLE);
+    view_strings.erase(view_id);
+}
+
+static void
+view_strings_clear ()
+{
+    for (std::pair<const uint32_t, view_strings_t>& strings : view_strings)
+    {
+        for (interned_entry_t* interned : strings.second.entries)
+        {
+            string_release(interned);
+        }
+    }
+
+    view_strings.clear();
+}
+
+void
+dbus_core_views_changed ()
+{
+    list_generation++;
+    /* ids may be reused by views the hooks haven't seen */
+    view_strings_clear();
+    dbus_view_store_invalidate();
+    dbus_view_index_invalidate();
+    dbus_view_search_invalidate();
+    dbus_focus_history_invalidate();
+    dbus_app_groups_invalidate();
+    dbus_output_registry_invalidate();
+    dbus_workspace_summary_invalidate();
+}
+
+static bool
+list_reply_valid (list_reply_cache_t* cache)
+{
+    return cache->reply && (cache->generation == list_generation);
+}
+
+static GVariant*
+list_reply_store (list_reply_cache_t* cache, GVariant* reply)
+{
+    if (cache->reply) {
+        g_variant_unref(cache->reply);
+    }
+
+    cache->reply = g_variant_ref_sink(reply);
+    cache->generation = list_generation;
+
+    return cache->reply;
+}
+
+static void
+list_reply_clear (list_reply_cache_t* cache)
+{
+    if (cache->reply) {
+        g_variant_unref(cache->reply);
+        cache->reply = nullptr;
     }
+}
 
-    if (!view->get_output()) {
+static gboolean
+check_view_toplevel (dbus_view_t* view)
+{
+    if (!view) {
         return FALSE;
     }
 
-    return TRUE;
+    return view->is_toplevel();
 }
 
-static wayfire_view
+static dbus_view_t*
 get_view_from_view_id (uint view_id)
 {
-    std::vector<wayfire_view> view_vector;
-    wayfire_view view;
+    std::vector<dbus_view_t*> view_vector;
+    dbus_view_t* view = nullptr;
 
-    view_vector = core.get_all_views();
+    view_vector = dbus_core->get_all_views();
 
     // there is no view_id 0 use it as get_active_view(hint)
     if (view_id == 0) {
-        view = core.get_cursor_focus_view();
+        view = dbus_core->get_cursor_focus_view();
         if (check_view_toplevel(view)) {
             return view;
         }
@@ -100,7 +249,7 @@ get_view_from_view_id (uint view_id)
 
     for (auto it = view_vector.begin(); it != view_vector.end(); ++it)
     {
-        wayfire_view v = *it;
+        dbus_view_t* v = *it;
         if (check_view_toplevel(v)) {
             if (v->get_id() == view_id) {
                 return v;
@@ -111,17 +260,38 @@ get_view_from_view_id (uint view_id)
     return view;
 }
 
-static wf::output_t*
-get_output_from_output_id (uint output_id)
+/***
+ * view_id, or for 0 that of the view get_view_from_view_id takes
+ * it for (0 if there is none), for the lookups that skip it.
+ ***/
+static uint32_t
+focus_view_id (uint32_t view_id)
 {
-    for (wf::output_t* wf_output : wf_outputs)
-    {
-        if (wf_output->get_id() == output_id) {
-            return wf_output;
-        }
+    dbus_view_t* view;
+
+    if (view_id != 0) {
+        return view_id;
     }
 
-    return nullptr;
+    view = get_view_from_view_id(0);
+
+    return view ? view->get_id() : 0;
+}
+
+static dbus_output_t*
+get_output_from_output_id (uint output_id)
+{
+    dbus_output_record_t* record = dbus_output_registry_find(output_id);
+
+    return record ? record->output : nullptr;
+}
+
+/* "nullptr" for an unknown output or a value it doesn't have */
+static GVariant*
+output_string_reply (const std::string* value)
+{
+    return g_variant_new("(s)", (value && !value->empty()) ?
+                         value->c_str() : "nullptr");
 }
 
 static void
@@ -131,75 +301,488 @@ restack_view (uint view_id, uint related_view_id, gboolean above)
         return;
     }
 
-    wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-    idle_call->run_once([=] ()
+    dbus_core->run_idle([=] ()
     {
-        wayfire_view view = get_view_from_view_id(view_id);
-        wayfire_view related_view = get_view_from_view_id(related_view_id);
+        dbus_view_t* view = get_view_from_view_id(view_id);
+        dbus_view_t* related_view = get_view_from_view_id(related_view_id);
 
         if (!check_view_toplevel(view) || !check_view_toplevel(related_view)) {
-            delete idle_call;
-
             return;
         }
 
-        wf::output_t* output = view->get_output();
-        if (!output) {
-            delete idle_call;
+        view->restack(related_view, above);
+    });
+}
 
-            return;
+/***
+ * Completes a method call. In-process callers (the benchmarks)
+ * pass no invocation, their replies go to method_reply_sink.
+ ***/
+static void
+method_return (GDBusMethodInvocation* invocation, GVariant* value)
+{
+    if (invocation) {
+        g_dbus_method_invocation_return_value(invocation, value);
+
+        return;
+    }
+
+    if (value != nullptr) {
+        g_variant_ref_sink(value);
+    }
+
+    if (method_reply_sink) {
+        method_reply_sink(value);
+    }
+
+    if (value != nullptr) {
+        g_variant_unref(value);
+    }
+}
+
+/***
+ * A (au) reply, copied in one go instead of
+ * adding the ids to a builder one by one.
+ ***/
+static GVariant*
+id_array_reply (const std::vector<uint32_t>& ids)
+{
+    GVariant* array = g_variant_new_fixed_array(G_VARIANT_TYPE_UINT32,
+                                                ids.data(), ids.size(),
+                                                sizeof(uint32_t));
+
+    return g_variant_new_tuple(&array, 1);
+}
+
+/***
+ * Queries that block on XWayland are answered from the worker
+ * pool, in-process callers (no invocation) get the reply right away.
+ ***/
+static void
+method_return_blocking (GDBusMethodInvocation* invocation,
+                        dbus_query_work_t work)
+{
+    if (!invocation) {
+        method_return(nullptr, work());
+
+        return;
+    }
+
+    dbus_query_pool_push(invocation, std::move(work), DBUS_QUERY_TIMEOUT_MS);
+}
+
+/***
+ * The blocking parts of the XWayland queries, they run on a worker
+ * and only get what the handler read from dbus_core.
+ ***/
+static GVariant*
+xwayland_atom_cardinal (const std::string& xdisplay, uint32_t window_id,
+                        const std::string& atom_name)
+{
+    uint32_t atom_value_cardinal = 0;
+    xcb_connection_t* conn;
+    xcb_atom_t atom;
+
+    conn = dbus_xcb_connect(xdisplay, DBUS_XCB_TIMEOUT_MS);
+    if (!conn) {
+        return g_variant_new("(u)", atom_value_cardinal);
+    }
+
+    atom = dbus_xcb_intern_atom(conn, atom_name.c_str());
+    if (atom == XCB_ATOM_NONE) {
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG, "reply for querying the atom is empty.");
+#endif
+        dbus_xcb_disconnect(conn);
+
+        return g_variant_new("(u)", atom_value_cardinal);
+    }
+
+    if (dbus_xcb_get_cardinal(conn, window_id, atom, &atom_value_cardinal)) {
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG, "value to uint.", atom_value_cardinal);
+#endif
+    }
+
+#ifdef DBUS_PLUGIN_DEBUG
+    else
+    {
+        LOG(wf::log::LOG_LEVEL_DEBUG, "requested value is not a cardinal");
+    }
+#endif
+
+    dbus_xcb_disconnect(conn);
+
+    return g_variant_new("(u)", atom_value_cardinal);
+}
+
+static GVariant*
+xwayland_atom_string (const std::string& xdisplay, uint32_t window_id,
+                      const std::string& atom_name)
+{
+    xcb_connection_t* conn;
+    xcb_atom_t atom;
+    std::string value;
+    bool is_cardinal;
+
+    conn = dbus_xcb_connect(xdisplay, DBUS_XCB_TIMEOUT_MS);
+    if (!conn) {
+        return g_variant_new("(s)", "Cannot connect to xwayland.");
+    }
+
+    atom = dbus_xcb_intern_atom(conn, atom_name.c_str());
+    if (atom == XCB_ATOM_NONE) {
+        dbus_xcb_disconnect(conn);
+
+        return g_variant_new("(s)", "reply for querying the atom is empty.");
+    }
+
+    if (!dbus_xcb_get_string(conn, window_id, atom, &value, &is_cardinal)) {
+        dbus_xcb_disconnect(conn);
+
+        return g_variant_new("(s)", "No atom value received.");
+    }
+
+    dbus_xcb_disconnect(conn);
+
+    if (is_cardinal) {
+        return g_variant_new("(s)", "XCB_ATOM_CARDINAL type requested.");
+    }
+
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG, "value to char.", value);
+#endif
+
+    return g_variant_new("(s)", value.c_str());
+}
+
+/***
+ * The X client's pid, or the wayland client's credentials (those
+ * of Xwayland) the handler read if the server doesn't know it.
+ ***/
+static GVariant*
+xwayland_credentials (const std::string& xdisplay, uint32_t window_id,
+                      pid_t pid, uid_t uid, gid_t gid)
+{
+    xcb_connection_t* conn;
+    pid_t client_pid = 0;
+
+    conn = dbus_xcb_connect(xdisplay, DBUS_XCB_TIMEOUT_MS);
+    if (conn) {
+        client_pid = dbus_xcb_get_client_pid(conn, window_id);
+        dbus_xcb_disconnect(conn);
+    }
+
+    if (client_pid != 0) {
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG,
+            "returning xwayland window credentials.");
+#endif
+
+        return g_variant_new("(iuu)", client_pid, 0, 0);
+    }
+
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG,
+        "could not get pid from xserver, returning standard credentials.");
+#endif
+
+    return g_variant_new("(iuu)", pid, uid, gid);
+}
+
+/***
+ * ids are the views filed under pid, views the XWayland views whose
+ * pid isn't known yet, filed under Xwayland's pid. Their pids are
+ * reported back to the index, if the server can't be reached they
+ * stay pending for the next lookup.
+ ***/
+static GVariant*
+xwayland_views_by_pid (const std::string& xdisplay, pid_t pid,
+                       std::vector<uint32_t> ids,
+                       const std::vector<std::pair<uint32_t, uint32_t>>& views)
+{
+    std::vector<uint32_t>::iterator listed;
+    xcb_connection_t* conn;
+    pid_t client_pid;
+
+    conn = dbus_xcb_connect(xdisplay, DBUS_XCB_TIMEOUT_MS);
+    if (!conn) {
+        return id_array_reply(ids);
+    }
+
+    for (const std::pair<uint32_t, uint32_t>& view : views)
+    {
+        client_pid = dbus_xcb_get_client_pid(conn, view.second);
+        /* timed out, the rest stay pending */
+        if (xcb_connection_has_error(conn)) {
+            break;
+        }
+
+        dbus_view_index_set_pid(view.first, client_pid);
+        if (client_pid == 0) {
+            continue;
+        }
+
+        listed = std::find(ids.begin(), ids.end(), view.first);
+        if ((client_pid == pid) && (listed == ids.end())) {
+            ids.push_back(view.first);
         }
+        else
+        if ((client_pid != pid) && (listed != ids.end()))
+        {
+            ids.erase(listed);
+        }
+    }
+
+    dbus_xcb_disconnect(conn);
+
+    return id_array_reply(ids);
+}
+
+/***
+ * Reports the X client's pid of each of views to the index, or that
+ * the server couldn't be reached or timed out. Runs as a task.
+ ***/
+static void
+xwayland_report_pids (const std::string& xdisplay,
+                      const std::vector<std::pair<uint32_t, uint32_t>>& views)
+{
+    xcb_connection_t* conn;
+    pid_t client_pid;
 
-        if (above) {
-            view->get_output()->workspace->restack_above(view, related_view);
+    conn = dbus_xcb_connect(xdisplay, DBUS_XCB_TIMEOUT_MS);
+    for (const std::pair<uint32_t, uint32_t>& view : views)
+    {
+        client_pid = conn ? dbus_xcb_get_client_pid(conn, view.second) : 0;
+        if (conn && !xcb_connection_has_error(conn)) {
+            dbus_view_index_set_pid(view.first, client_pid);
         }
         else
         {
-            view->get_output()->workspace->restack_below(view, related_view);
+            dbus_view_index_pid_failed(view.first);
         }
+    }
+
+    if (conn) {
+        dbus_xcb_disconnect(conn);
+    }
+}
+
+/***
+ * The XWayland views are asked about as they are mapped, so a lookup
+ * by pid rarely has anything left to wait for. One batch at a time,
+ * the views mapped meanwhile go with the next one (or the lookup).
+ ***/
+static void
+xwayland_pids_resolve ()
+{
+    std::vector<std::pair<uint32_t, uint32_t>> views;
+    std::string xdisplay;
+
+    if (!dbus_query_pool_task_idle()) {
+        return;
+    }
+
+    dbus_view_index_claim_pending(&views);
+    if (views.empty()) {
+        return;
+    }
 
-        delete idle_call;
+    xdisplay = dbus_core->get_xwayland_display();
+    dbus_query_pool_run([=] ()
+    {
+        xwayland_report_pids(xdisplay, views);
     });
 }
 
-/*
- * It is a deliberate design choice to have
- * methods / signals instead of properties
- *
- * Not all clients fully support
- * automatic property change notifcations!
- */
-const gchar introspection_xml [] =
-    "<node>"
-    "  <interface name='org.wayland.compositor'>"
-    // "<property type='au' name='view_vector_ids' access='read'/>"
-    // kept as example
-    /************************* Methods ************************/
-    // Draft methods
-    // "    <method name='inhibit_output_start'/>"
-    // "    <method name='inhibit_output_stop'/>"
+/***
+ * An application group's minimized state as query_app_groups and
+ * app_group_changed report it, a group that is gone has no views.
+ ***/
+static bool
+app_group_minimized (const dbus_app_group_t& group)
+{
+    return (group.views > 0) && (group.minimized == group.views);
+}
 
-    // "    <method name='trigger_show_desktop'/>"
-    // "    <method name='trigger_show_overview'/>"
+static void
+emit_app_groups_changed (const std::vector<std::string>& changed)
+{
+    const dbus_app_groups_t& groups = dbus_app_groups_get();
+    dbus_app_groups_t::const_iterator group;
 
-    "    <method name='query_cursor_position'>"
-    "      <arg type='d' name='x_pos' direction='out'/>"
-    "      <arg type='d' name='y_pos' direction='out'/>"
-    "    </method>"
-    "    <method name='enable_property_mode'>"
-    "      <arg type='b' name='enable' direction='in'/>"
-    "    </method>"
+    dbus_app_group_t state;
 
-    /************************* Output Methods ************************/
-    "    <method name='query_output_ids'>"
-    "      <arg direction='out' type='au' />"
-    "    </method>"
-    "    <method name='query_active_output'>"
-    "      <arg type='u' name='output_id' direction='out'/>"
-    "    </method>"
-    "    <method name='query_output_name'>"
-    "      <arg type='u' name='output_id' direction='in'/>"
-    "      <arg type='s' name='name' direction='out'/>"
+    for (const std::string& app_id : changed)
+    {
+        group = groups.find(app_id);
+        state = (group != groups.end()) ? group->second : dbus_app_group_t();
+        emit_app_group_changed({g_variant_new_string(app_id.c_str()),
+                                state.views, state.urgent > 0,
+                                app_group_minimized(state)});
+    }
+}
+
+/***
+ * The hooks' side of the application groups, each signals
+ * the groups that changed.
+ ***/
+static void
+app_groups_update (dbus_view_t* view)
+{
+    std::vector<std::string> changed;
+
+    dbus_app_groups_update(view, &changed);
+    emit_app_groups_changed(changed);
+}
+
+static void
+app_groups_update_minimized (dbus_view_t* view, bool minimized)
+{
+    std::vector<std::string> changed;
+
+    dbus_app_groups_update_minimized(view, minimized, &changed);
+    emit_app_groups_changed(changed);
+}
+
+static void
+app_groups_remove (uint32_t view_id)
+{
+    std::vector<std::string> changed;
+
+    dbus_app_groups_remove(view_id, &changed);
+    emit_app_groups_changed(changed);
+}
+
+static void
+emit_workspace_summaries_changed (const std::vector<uint32_t>& changed)
+{
+    dbus_workspace_masks_t masks;
+
+    for (uint32_t output_id : changed)
+    {
+        masks = dbus_workspace_summary_masks(output_id);
+        emit_workspace_summary_changed({output_id, masks.occupied,
+                                        masks.urgent, masks.focused,
+                                        masks.fullscreen});
+    }
+}
+
+/***
+ * The hooks' side of the workspace summaries, each signals
+ * the outputs whose bits flipped.
+ ***/
+static void
+workspace_summary_update (dbus_view_t* view)
+{
+    std::vector<uint32_t> changed;
+
+    dbus_workspace_summary_update(view, &changed);
+    emit_workspace_summaries_changed(changed);
+}
+
+static void
+workspace_summary_update_geometry (dbus_view_t* view)
+{
+    std::vector<uint32_t> changed;
+
+    dbus_workspace_summary_update_geometry(view, &changed);
+    emit_workspace_summaries_changed(changed);
+}
+
+static void
+workspace_summary_update_minimized (dbus_view_t* view, bool minimized)
+{
+    std::vector<uint32_t> changed;
+
+    dbus_workspace_summary_update_minimized(view, minimized, &changed);
+    emit_workspace_summaries_changed(changed);
+}
+
+static void
+workspace_summary_update_fullscreen (dbus_view_t* view, bool fullscreen)
+{
+    std::vector<uint32_t> changed;
+
+    dbus_workspace_summary_update_fullscreen(view, fullscreen, &changed);
+    emit_workspace_summaries_changed(changed);
+}
+
+static void
+workspace_summary_remove (uint32_t view_id)
+{
+    std::vector<uint32_t> changed;
+
+    dbus_workspace_summary_remove(view_id, &changed);
+    emit_workspace_summaries_changed(changed);
+}
+
+static void
+workspace_summary_focus (dbus_view_t* view)
+{
+    std::vector<uint32_t> changed;
+
+    dbus_workspace_summary_focus(view, &changed);
+    emit_workspace_summaries_changed(changed);
+}
+
+void
+dbus_core_view_destroyed (uint32_t view_id)
+{
+    /* the plugin is unloaded, the indices may be gone with it */
+    if (!dbus_core) {
+        return;
+    }
+
+    /* all of these are no-ops if the view was closed first */
+    list_generation++;
+    view_strings_forget(view_id);
+    dbus_view_store_remove(view_id);
+    dbus_view_index_remove(view_id);
+    dbus_view_search_remove(view_id);
+    dbus_focus_history_remove(view_id);
+    app_groups_remove(view_id);
+    workspace_summary_remove(view_id);
+}
+
+/*
+ * It is a deliberate design choice to have
+ * methods / signals instead of properties
+ *
+ * Not all clients fully support
+ * automatic property change notifcations!
+ */
+const gchar introspection_xml [] =
+    "<node>"
+    "  <interface name='org.wayland.compositor'>"
+    // "<property type='au' name='view_vector_ids' access='read'/>"
+    // kept as example
+    /************************* Methods ************************/
+    // Draft methods
+    // "    <method name='inhibit_output_start'/>"
+    // "    <method name='inhibit_output_stop'/>"
+
+    // "    <method name='trigger_show_desktop'/>"
+    // "    <method name='trigger_show_overview'/>"
+
+    "    <method name='query_cursor_position'>"
+    "      <arg type='d' name='x_pos' direction='out'/>"
+    "      <arg type='d' name='y_pos' direction='out'/>"
+    "    </method>"
+    "    <method name='enable_property_mode'>"
+    "      <arg type='b' name='enable' direction='in'/>"
+    "    </method>"
+
+    /************************* Output Methods ************************/
+    "    <method name='query_output_ids'>"
+    "      <arg direction='out' type='au' />"
+    "    </method>"
+    "    <method name='query_active_output'>"
+    "      <arg type='u' name='output_id' direction='out'/>"
+    "    </method>"
+    "    <method name='query_output_name'>"
+    "      <arg type='u' name='output_id' direction='in'/>"
+    "      <arg type='s' name='name' direction='out'/>"
     "    </method>"
     "    <method name='query_output_manufacturer'>"
     "      <arg type='u' name='output_id' direction='in'/>"
@@ -218,9 +801,26 @@ const gchar introspection_xml [] =
     "      <arg type='u' name='xHorizontal' direction='out'/>"
     "      <arg type='u' name='yVertical' direction='out'/>"
     "    </method>"
+    /***
+     * Every output by id: name, make, model and serial (s, if
+     * known), x, y, width and height in the layout (i), scale (d),
+     * transform (u, wl_output_transform), grid_width, grid_height,
+     * workspace_x and workspace_y (i).
+     ***/
+    "    <method name='query_outputs'>"
+    "      <arg type='a{ua{sv}}' name='outputs' direction='out'/>"
+    "    </method>"
     "    <method name='query_xwayland_display'>"
     "      <arg type='s' name='xdisplay' direction='out'/>"
     "    </method>"
+    /***
+     * The worker pool the XWayland queries run on: threads,
+     * pending (u), started, completed, timed_out (t) and the time
+     * spent queued, queue_time_total_us and queue_time_max_us (t).
+     ***/
+    "    <method name='query_worker_stats'>"
+    "      <arg type='a{sv}' name='stats' direction='out'/>"
+    "    </method>"
     /************************* View Methods ************************/
     "    <method name='query_view_vector_ids'>"
     "      <arg direction='out' type='au' />"
@@ -228,6 +828,61 @@ const gchar introspection_xml [] =
     "    <method name='query_view_vector_taskman_ids'>"
     "      <arg direction='out' type='au' />"
     "    </method>"
+    /***
+     * Views with (flags & flags_mask) == flags_value on output_id
+     * (0 for any) and workspace (x, y) (x < 0 for any). Flags:
+     * mapped 1, toplevel 2, minimized 4, maximized 8, fullscreen 16,
+     * activated 32, above 64, attention 128.
+     ***/
+    "    <method name='query_views_filtered'>"
+    "      <arg type='u' name='flags_mask' direction='in'/>"
+    "      <arg type='u' name='flags_value' direction='in'/>"
+    "      <arg type='u' name='output_id' direction='in'/>"
+    "      <arg type='i' name='workspace_horizontal' direction='in'/>"
+    "      <arg type='i' name='workspace_vertical' direction='in'/>"
+    "      <arg direction='out' type='au' />"
+    "    </method>"
+    /***
+     * Mapped views by their client's pid (the X client's for
+     * XWayland views, as query_view_credentials), by XWayland
+     * window id (0 if there is none) and by app id.
+     ***/
+    "    <method name='query_views_by_pid'>"
+    "      <arg type='i' name='pid' direction='in'/>"
+    "      <arg direction='out' type='au' />"
+    "    </method>"
+    "    <method name='query_view_by_xid'>"
+    "      <arg type='u' name='xwayland_wid' direction='in'/>"
+    "      <arg type='u' name='view_id' direction='out'/>"
+    "    </method>"
+    "    <method name='query_views_by_app_id'>"
+    "      <arg type='s' name='app_id' direction='in'/>"
+    "      <arg direction='out' type='au' />"
+    "    </method>"
+    /***
+     * Toplevels whose app id or title contains query (ignoring case),
+     * best matches first, at most limit (0 for all).
+     ***/
+    "    <method name='query_views_matching'>"
+    "      <arg type='s' name='query' direction='in'/>"
+    "      <arg type='u' name='limit' direction='in'/>"
+    "      <arg direction='out' type='au' />"
+    "    </method>"
+    /***
+     * Toplevels, most recently focused first, at most limit (0 for
+     * all). Views never focused follow in stacking order.
+     ***/
+    "    <method name='query_focus_history'>"
+    "      <arg type='u' name='limit' direction='in'/>"
+    "      <arg direction='out' type='au' />"
+    "    </method>"
+    /***
+     * Mapped toplevels by app id, as (app id, views, urgent,
+     * minimized: all views are), the same as app_group_changed.
+     ***/
+    "    <method name='query_app_groups'>"
+    "      <arg type='a(subb)' name='groups' direction='out'/>"
+    "    </method>"
     "    <method name='query_view_app_id'>"
     "      <arg type='u' name='view_id' direction='in'/>"
     "      <arg type='s' name='app_id' direction='out'/>"
@@ -282,6 +937,15 @@ const gchar introspection_xml [] =
     "      <arg type='u' name='view_id' direction='in'/>"
     "      <arg type='u' name='view_group_leader_view_id' direction='out'/>"
     "    </method>"
+    /***
+     * The leader of view_id's group and all its transients
+     * (dialogs and their dialogs), parents first.
+     ***/
+    "    <method name='query_view_group'>"
+    "      <arg type='u' name='view_id' direction='in'/>"
+    "      <arg type='u' name='view_group_leader_view_id' direction='out'/>"
+    "      <arg type='au' name='transient_view_ids' direction='out'/>"
+    "    </method>"
     "    <method name='query_view_role'>"
     "      <arg type='u' name='view_id' direction='in'/>"
     "      <arg type='u' name='view_state' direction='out'/>"
@@ -290,6 +954,22 @@ const gchar introspection_xml [] =
     "      <arg type='i' name='rows' direction='out'/>"
     "      <arg type='i' name='columns' direction='out'/>"
     "    </method>"
+    /***
+     * For pagers: the output's grid, the number of toplevels on
+     * each workspace row by row, and masks of the workspaces with
+     * toplevels, an urgent one, the focused one and a fullscreen
+     * one, workspace (x, y) being bit y * grid_width + x.
+     ***/
+    "    <method name='query_workspace_summary'>"
+    "      <arg type='u' name='output_id' direction='in'/>"
+    "      <arg type='i' name='grid_width' direction='out'/>"
+    "      <arg type='i' name='grid_height' direction='out'/>"
+    "      <arg type='au' name='views' direction='out'/>"
+    "      <arg type='t' name='occupied' direction='out'/>"
+    "      <arg type='t' name='urgent' direction='out'/>"
+    "      <arg type='t' name='focused' direction='out'/>"
+    "      <arg type='t' name='fullscreen' direction='out'/>"
+    "    </method>"
     "    <method name='query_view_attention'>"
     "      <arg type='u' name='view_id' direction='in'/>"
     "      <arg type='b' name='attention' direction='out'/>"
@@ -398,139 +1078,11 @@ const gchar introspection_xml [] =
     "     <arg type='u' name='view_id' direction='in'/>"
     "   </method>"
     /************************* Signals ************************/
-    /***
-     * Core Input Signals
-     ***/
-    "    <signal name='pointer_clicked'>"
-    "      <arg type='d' name='x_pos'/>"
-    "      <arg type='d' name='y_pos'/>"
-    "      <arg type='u' name='button'/>"
-    "      <arg type='b' name='button_released'/>"
-    "    </signal>"
-    "    <signal name='tablet_touched'/>"
-
-    /***
-     * View related signals, emitted from various
-     * sources
-     ***/
-    "    <signal name='view_added'>"
-    "      <arg type='u' name='view_id'/>"
-    "    </signal>"
-    "    <signal name='view_closed'>"
-    "      <arg type='u' name='view_id'/>"
-    "    </signal>"
-    "    <signal name='view_app_id_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='s' name='new_app_id'/>"
-    "    </signal>"
-    "    <signal name='view_title_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='s' name='new_title'/>"
-    "    </signal>"
-    "    <signal name='view_output_move_requested'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='u' name='old_output'/>"
-    "      <arg type='u' name='new_output'/>"
-    "    </signal>"
-    "    <signal name='view_output_moved'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='u' name='old_output'/>"
-    "      <arg type='u' name='new_output'/>"
-    "    </signal>"
-    "    <signal name='view_workspaces_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "    </signal>"
-    "    <signal name='view_attention_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='b' name='attention'/>"
-    "    </signal>"
-    "    <signal name='view_group_leader_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='u' name='view_group_leader_view_id'/>"
-    "    </signal>"
-    "    <signal name='view_tiling_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='u' name='edges'/>"
-    "    </signal>"
-    "    <signal name='view_geometry_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='i' name='x'/>"
-    "      <arg type='i' name='y'/>"
-    "      <arg type='i' name='width'/>"
-    "      <arg type='i' name='height'/>"
-    "    </signal>"
-    "    <signal name='view_moving_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "    </signal>"
-    "    <signal name='view_resizing_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "    </signal>"
-    "    <signal name='view_role_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='u' name='view_role'/>"
-    "    </signal>"
-    "    <signal name='view_maximized_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='b' name='maximized'/>"
-    "    </signal>"
-    "    <signal name='view_minimized_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='b' name='minimized'/>"
-    "    </signal>"
-    "    <signal name='view_fullscreen_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='b' name='fullscreened'/>"
-    "    </signal>"
-    "    <signal name='view_focus_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "    </signal>"
-    "    <signal name='view_keep_above_changed'>"
-    "      <arg type='u' name='view_id'/>"
-    "      <arg type='b' name='above'/>"
-    "    </signal>"
-    /***
-     * Output related signals, emitted from various
-     * sources
-     ***/
-    "    <signal name='output_workspace_changed'>"
-    "      <arg type='u' name='output_id'/>"
-    "      <arg type='i' name='workspace_horizontal'/>"
-    "      <arg type='i' name='workspace_vertical'/>"
-    "    </signal>"
-    "    <signal name='output_added'>"
-    "      <arg type='u' name='output_id'/>"
-    "    </signal>"
-    "    <signal name='output_removed'>"
-    "      <arg type='u' name='output_id'/>"
-    "    </signal>"
-    "    <signal name='output_configuration_changed'/>"
-
-    /***
-     * For wf-prop & co
-     ***/
-    "    <signal name='view_pressed'>"
-    "      <arg type='u' name='view_id'/>"
-    "    </signal>"
-    /***
-     * Tentative signals
-     *  "    <signal name='hotspot_edge_trigger_stop'>"
-     *  "      <arg type='u' name='hotspot_edge'/>"
-     *  "    </signal>"
-     *  "    <signal name='hotspot_edge_triggered'>"
-     *  "      <arg type='i' name='hotspot_edge'/>"
-     *  "    </signal>"
-     *  "    <signal name='hotspot_edge_trigger_stop'>"
-     *  "      <arg type='i' name='hotspot_edge'/>"
-     *  "    </signal>"
-     *
-     *  "    <signal name='inhibit_output_started'/>"
-     *  "    <signal name='inhibit_output_stopped'/>"
-     ***/
-
+    DBUS_SIGNALS_XML
     "  </interface>"
     "</node>";
 
-static void
+void
 handle_method_call (GDBusConnection* connection, const gchar* sender,
                     const gchar* object_path,
                     const gchar* interface_name,
@@ -547,1873 +1099,2225 @@ handle_method_call (GDBusConnection* connection, const gchar* sender,
         uint action;
 
         g_variant_get(parameters, "(uu)", &view_id, &action);
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
+        dbus_core->run_idle([=] ()
         {
-            wayfire_view view = get_view_from_view_id(view_id);
+            dbus_view_t* view = get_view_from_view_id(view_id);
             if (!check_view_toplevel(view)) {
-                delete idle_call;
-
                 return;
             }
 
             bool is_above;
-            wf::output_t* output;
-            wf::_view_signal signal_data;
-            is_above = view->has_data("wm-actions-above");
-            output = view->get_output();
+            is_above = view->is_above();
 
             if ((action == 0) && is_above) {
-                signal_data.view = view;
-                output->emit_signal("wm-actions-toggle-above", &signal_data);
+                view->toggle_above();
             }
             else
             if ((action == 1) && !is_above)
             {
-                signal_data.view = view;
-                output->emit_signal("wm-actions-toggle-above", &signal_data);
+                view->toggle_above();
             }
             else
             if (action == 2)
             {
-                signal_data.view = view;
-                output->emit_signal("wm-actions-toggle-above", &signal_data);
+                view->toggle_above();
+            }
+        });
+
+        method_return(invocation, NULL);
+
+        return;
+    }
+
+    /*************** View Actions ****************/
+    else
+    if (g_strcmp0(method_name, "ensure_view_visible") == 0)
+    {
+        uint view_id;
+        g_variant_get(parameters, "(u)", &view_id);
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+
+            if (check_view_toplevel(view)) {
+                view->ensure_visible();
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "update_view_minimize_hint") == 0)
+    {
+        uint view_id;
+        g_variant_get(parameters, "(u)", &view_id);
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+
+            if (check_view_toplevel(view)) {
+                dbus_point_t pos;
+                pos = dbus_core->get_active_output()->get_cursor_position();
+                view->set_minimize_hint({(int)pos.x, (int)pos.y, 5, 5});
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "shade_view") == 0)
+    {
+        uint view_id;
+        double intensity;
+
+        g_variant_get(parameters, "(ud)", &view_id, &intensity);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            view->set_alpha(intensity);
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "bring_view_to_front") == 0)
+    {
+        uint view_id;
+        g_variant_get(parameters, "(u)", &view_id);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+
+            if (check_view_toplevel(view)) {
+                view->bring_to_front();
+            }
+        });
+
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "restack_view_above") == 0)
+    {
+        uint view_id;
+        uint related_view_id;
+        g_variant_get(parameters, "(uu)", &view_id, &related_view_id);
+        restack_view(view_id, related_view_id, TRUE);
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "restack_view_below") == 0)
+    {
+        uint view_id;
+        uint related_view_id;
+        g_variant_get(parameters, "(uu)", &view_id, &related_view_id);
+        restack_view(view_id, related_view_id, FALSE);
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "minimize_view") == 0)
+    {
+        uint view_id;
+        uint action;
+
+        g_variant_get(parameters, "(uu)", &view_id, &action);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            if ((action == 0) && view->is_minimized()) {
+                view->minimize(false);
+            }
+
+            else
+            if ((action == 1) && !view->is_minimized())
+            {
+                view->minimize(true);
+            }
+
+            else
+            if (action == 2)
+            {
+                view->minimize(!view->is_minimized());
+            }
+        });
+
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "maximize_view") == 0)
+    {
+        uint view_id;
+        uint action;
+        g_variant_get(parameters, "(uu)", &view_id, &action);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            if (action == 0) {
+                view->maximize(false);
+            }
+
+            else
+            if (action == 1)
+            {
+                view->maximize(true);
+            }
+
+            else
+            if (action == 2)
+            {
+                view->maximize(!view->is_maximized());
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "focus_view") == 0)
+    {
+        uint view_id;
+        uint action;
+        g_variant_get(parameters, "(uu)", &view_id, &action);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            if (action == 0) {
+                view->set_activated(false);
+            }
+
+            else
+            if (action == 1)
+            {
+                view->set_activated(true);
+                view->focus_request();
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "fullscreen_view") == 0)
+    {
+        uint view_id;
+        uint action;
+        g_variant_get(parameters, "(uu)", &view_id, &action);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            if (action == 0) {
+                view->fullscreen(false);
+            }
+
+            else
+            if (action == 1)
+            {
+                view->fullscreen(true);
+            }
+
+            else
+            if (action == 2)
+            {
+                view->fullscreen(!view->is_fullscreen());
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "close_view") == 0)
+    {
+        uint view_id;
+        g_variant_get(parameters, "(u)", &view_id);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+
+            if (check_view_toplevel(view)) {
+                view->close();
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "change_view_minimize_hint") == 0)
+    {
+        uint view_id;
+        int x, y, width, height;
+
+        g_variant_get(parameters, "(uiiii)", &view_id, &x, &y, &width, &height);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            view->set_minimize_hint({x, y, width, height});
+        });
+
+        method_return(invocation, nullptr);
+
+        return;
+    }
+
+    else
+    if (g_strcmp0(method_name, "change_output_view") == 0)
+    {
+        uint view_id;
+        uint output_id;
+
+        g_variant_get(parameters, "(uu)", &view_id, &output_id);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            dbus_output_t* output = get_output_from_output_id(output_id);
+            if (output) {
+                view->move_to_output(output);
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "change_workspace_view") == 0)
+    {
+        uint view_id;
+        int new_workspace_x;
+        int new_workspace_y;
+
+        g_variant_get(parameters, "(uii)", &view_id, &new_workspace_x,
+                      &new_workspace_y);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_view_t* view = get_view_from_view_id(view_id);
+            if (!check_view_toplevel(view)) {
+                return;
+            }
+
+            view->move_to_workspace(new_workspace_x, new_workspace_y);
+        });
+
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "change_workspace_output") == 0)
+    {
+        uint output_id;
+        int new_workspace_x;
+        int new_workspace_y;
+
+        g_variant_get(parameters, "(uii)", &output_id, &new_workspace_x,
+                      &new_workspace_y);
+
+        dbus_core->run_idle([=] ()
+        {
+            dbus_output_t* output = get_output_from_output_id(output_id);
+
+            if (output) {
+                // Provides animation if available
+                output->request_workspace(new_workspace_x, new_workspace_y);
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "change_workspace_all_outputs") == 0)
+    {
+        int new_workspace_x;
+        int new_workspace_y;
+
+        g_variant_get(parameters, "(ii)", &new_workspace_x, &new_workspace_y);
+
+        dbus_core->run_idle([=] ()
+        {
+            for (dbus_output_t* output : dbus_core->get_outputs())
+            {
+                if (output) {
+                    output->request_workspace(new_workspace_x, new_workspace_y);
+                }
+            }
+        });
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "show_desktop") == 0)
+    {
+        method_return(invocation, NULL);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "scale") == 0)
+    {
+        gboolean all_workspaces = FALSE;
+        const gchar* app_id = nullptr;
+        g_variant_get(parameters, "(b&s)", &all_workspaces, &app_id);
+
+        dbus_core->run_idle(
+            [all_workspaces, app_id = std::string(app_id)] ()
+        {
+            dbus_core->scale(all_workspaces, app_id);
+        });
+
+        method_return(invocation, nullptr);
+    }
+
+    /*************** Non-reffing actions at end ****************/
+    else
+    if (g_strcmp0(method_name, "enable_property_mode") == 0)
+    {
+        gboolean enable;
+        g_variant_get(parameters, "(b)", &enable);
+        find_view_under_action = enable;
+
+        /**
+         * Eventually store current cursor
+         * and restore it if different from
+         * "default"
+         */
+        dbus_core->set_input_grab(enable);
+        dbus_core->run_idle([=] ()
+        {
+            dbus_core->set_cursor(enable ? "crosshair" : "default");
+        });
+
+        method_return(invocation, nullptr);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_cursor_position") == 0)
+    {
+        /*
+         * It uses the output relative cursor position
+         * as expected by minimize rect and popup positions
+         */
+        dbus_point_t cursor_position;
+        GVariant* value;
+
+        cursor_position = dbus_core->get_active_output()->get_cursor_position();
+        value = g_variant_new("(dd)", cursor_position.x, cursor_position.y);
+        method_return(invocation, value);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_output_ids") == 0)
+    {
+        std::vector<uint32_t> ids;
+
+        if (!list_reply_valid(&output_ids_reply)) {
+            for (dbus_output_t* output : dbus_core->get_outputs())
+            {
+                ids.push_back(output->get_id());
+            }
+
+            list_reply_store(&output_ids_reply, id_array_reply(ids));
+        }
+
+        method_return(invocation, output_ids_reply.reply);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_active_output") == 0)
+    {
+        uint output_id;
+        output_id = dbus_core->get_active_output()->get_id();
+        method_return(invocation, g_variant_new("(u)", output_id));
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_view_vector_ids") == 0)
+    {
+        std::vector<dbus_view_t*> view_vector;
+        std::vector<uint32_t> ids;
+
+        if (!list_reply_valid(&view_ids_reply)) {
+            view_vector = dbus_core->get_all_views();
+            ids.reserve(view_vector.size());
+            for (auto it = begin(view_vector); it != end(view_vector); ++it)
+            {
+                ids.push_back((*it)->get_id());
+            }
+
+            list_reply_store(&view_ids_reply, id_array_reply(ids));
+        }
+
+        method_return(invocation, view_ids_reply.reply);
+
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_view_vector_taskman_ids") == 0)
+    {
+        std::vector<dbus_view_t*> view_vector;
+        std::vector<uint32_t> ids;
+
+        if (!list_reply_valid(&taskman_ids_reply)) {
+            view_vector = dbus_core->get_all_views();
+            for (auto it = begin(view_vector); it != end(view_vector); ++it)
+            {
+                if (((*it)->get_role() != DBUS_VIEW_ROLE_TOPLEVEL) ||
+                    !(*it)->is_mapped()) {
+                    continue;
+                }
+                else
+                {
+                    ids.push_back((*it)->get_id());
+                }
             }
 
-            delete idle_call;
-        });
+            list_reply_store(&taskman_ids_reply, id_array_reply(ids));
+        }
 
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation, taskman_ids_reply.reply);
 
         return;
     }
-
-    /*************** View Actions ****************/
     else
-    if (g_strcmp0(method_name, "ensure_view_visible") == 0)
+    if (g_strcmp0(method_name, "query_views_filtered") == 0)
     {
-        uint view_id;
-        g_variant_get(parameters, "(u)", &view_id);
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wayfire_view view = get_view_from_view_id(view_id);
-
-            if (check_view_toplevel(view)) {
-                view->get_output()->ensure_visible(view);
-            }
+        std::vector<uint32_t> ids;
+        uint flags_mask;
+        uint flags_value;
+        uint output_id;
+        int workspace_x;
+        int workspace_y;
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        g_variant_get(parameters, "(uuuii)", &flags_mask, &flags_value,
+                      &output_id, &workspace_x, &workspace_y);
+        dbus_view_store_select(flags_mask, flags_value, output_id,
+                               workspace_x, workspace_y, &ids);
+        method_return(invocation, id_array_reply(ids));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "update_view_minimize_hint") == 0)
+    if (g_strcmp0(method_name, "query_views_by_pid") == 0)
     {
-        uint view_id;
-        g_variant_get(parameters, "(u)", &view_id);
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wayfire_view view = get_view_from_view_id(view_id);
+        std::vector<std::pair<uint32_t, uint32_t>> views;
+        std::vector<uint32_t> ids;
+        std::string xdisplay;
+        gint32 pid;
 
-            if (check_view_toplevel(view)) {
-                wf::pointf_t pos;
-                pos = core.get_active_output()->get_cursor_position();
-                view->set_minimize_hint({(int)pos.x, (int)pos.y, 5, 5});
-            }
+        g_variant_get(parameters, "(i)", &pid);
+        dbus_view_index_by_pid(pid, &ids);
+
+        /* the XWayland views without a pid yet are asked about on a worker */
+        dbus_view_index_pending(&views);
+        if (views.empty()) {
+            method_return(invocation, id_array_reply(ids));
+
+            return;
+        }
 
-            delete idle_call;
+        xdisplay = dbus_core->get_xwayland_display();
+        method_return_blocking(invocation, [=] ()
+        {
+            return xwayland_views_by_pid(xdisplay, pid, ids, views);
         });
-        g_dbus_method_invocation_return_value(invocation, NULL);
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "shade_view") == 0)
+    if (g_strcmp0(method_name, "query_view_by_xid") == 0)
     {
-        uint view_id;
-        double intensity;
+        uint window_id;
 
-        g_variant_get(parameters, "(ud)", &view_id, &intensity);
+        g_variant_get(parameters, "(u)", &window_id);
+        method_return(invocation, g_variant_new("(u)",
+                                                dbus_view_index_by_xid(window_id)));
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_views_by_app_id") == 0)
+    {
+        std::vector<uint32_t> ids;
+        const gchar* app_id;
 
-                return;
-            }
+        g_variant_get(parameters, "(&s)", &app_id);
+        dbus_view_index_by_app_id(app_id, &ids);
+        method_return(invocation, id_array_reply(ids));
 
-            if (intensity == 1.0) {
-                if (view->get_transformer("dbus-shade")) {
-                    view->pop_transformer("dbus-shade");
-                }
-            }
-            else
-            {
-                wf::view_2D* transformer;
-                if (!view->get_transformer("dbus-shade")) {
-                    view->add_transformer(std::make_unique<wf::view_2D> (view),
-                                          "dbus-shade");
-                }
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_views_matching") == 0)
+    {
+        std::vector<uint32_t> ids;
+        const gchar* query;
+        uint limit;
 
-                transformer = dynamic_cast<wf::view_2D*> (
-                    view->get_transformer("dbus-shade").get());
+        g_variant_get(parameters, "(&su)", &query, &limit);
+        dbus_view_search(query, limit, &ids);
+        method_return(invocation, id_array_reply(ids));
 
-                if (transformer->alpha != (float)intensity) {
-                    transformer->alpha = (float)intensity;
-                    // view->damage();
-                }
-            }
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_focus_history") == 0)
+    {
+        std::vector<uint32_t> ids;
+        uint limit;
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        g_variant_get(parameters, "(u)", &limit);
+        dbus_focus_history_get(limit, &ids);
+        method_return(invocation, id_array_reply(ids));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "bring_view_to_front") == 0)
+    if (g_strcmp0(method_name, "query_app_groups") == 0)
     {
-        uint view_id;
-        g_variant_get(parameters, "(u)", &view_id);
+        const dbus_app_groups_t& groups = dbus_app_groups_get();
+        GVariantBuilder builder;
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a(subb)"));
+        for (const std::pair<const std::string, dbus_app_group_t>& group :
+             groups)
         {
-            wayfire_view view = get_view_from_view_id(view_id);
-
-            if (check_view_toplevel(view)) {
-                wf::output_t* output = view->get_output();
-                output->workspace->bring_to_front(view);
-            }
-
-            delete idle_call;
-        });
+            g_variant_builder_add(&builder, "(subb)", group.first.c_str(),
+                                  group.second.views, group.second.urgent > 0,
+                                  app_group_minimized(group.second));
+        }
 
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation, g_variant_new("(a(subb))", &builder));
 
         return;
     }
+    /*************** Output Properties ****************/
     else
-    if (g_strcmp0(method_name, "restack_view_above") == 0)
+    if (g_strcmp0(method_name, "query_output_name") == 0)
     {
-        uint view_id;
-        uint related_view_id;
-        g_variant_get(parameters, "(uu)", &view_id, &related_view_id);
-        restack_view(view_id, related_view_id, TRUE);
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        uint output_id;
+        dbus_output_record_t* record;
+
+        g_variant_get(parameters, "(u)", &output_id);
+        record = dbus_output_registry_find(output_id);
+        method_return(invocation,
+                      output_string_reply(record ? &record->name : nullptr));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "restack_view_below") == 0)
+    if (g_strcmp0(method_name, "query_output_manufacturer") == 0)
     {
-        uint view_id;
-        uint related_view_id;
-        g_variant_get(parameters, "(uu)", &view_id, &related_view_id);
-        restack_view(view_id, related_view_id, FALSE);
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        uint output_id;
+        dbus_output_record_t* record;
+
+        g_variant_get(parameters, "(u)", &output_id);
+        record = dbus_output_registry_find(output_id);
+        method_return(invocation,
+                      output_string_reply(record ? &record->make : nullptr));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "minimize_view") == 0)
+    if (g_strcmp0(method_name, "query_output_model") == 0)
     {
-        uint view_id;
-        uint action;
-
-        g_variant_get(parameters, "(uu)", &view_id, &action);
-
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
+        uint output_id;
+        dbus_output_record_t* record;
 
-                return;
-            }
+        g_variant_get(parameters, "(u)", &output_id);
+        record = dbus_output_registry_find(output_id);
+        method_return(invocation,
+                      output_string_reply(record ? &record->model : nullptr));
 
-            if ((action == 0) && view->minimized) {
-                view->minimize_request(false);
-            }
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_output_serial") == 0)
+    {
+        uint output_id;
+        dbus_output_record_t* record;
 
-            else
-            if ((action == 1) && !view->minimized)
-            {
-                view->minimize_request(true);
-            }
+        g_variant_get(parameters, "(u)", &output_id);
+        record = dbus_output_registry_find(output_id);
+        method_return(invocation,
+                      output_string_reply(record ? &record->serial : nullptr));
 
-            else
-            if (action == 2)
-            {
-                view->minimize_request(!view->minimized);
-            }
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_output_workspace") == 0)
+    {
+        uint output_id;
+        uint horizontal_workspace = 0;
+        uint vertical_workspace = 0;
+        dbus_output_t* output;
+        dbus_workspace_t ws;
 
-            delete idle_call;
-        });
+        g_variant_get(parameters, "(u)", &output_id);
+        output = get_output_from_output_id(output_id);
+        if (output) {
+            ws = output->get_workspace();
+            horizontal_workspace = ws.x;
+            vertical_workspace = ws.y;
+        }
 
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation,
+                      g_variant_new("(uu)", horizontal_workspace, vertical_workspace));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "maximize_view") == 0)
+    if (g_strcmp0(method_name, "query_outputs") == 0)
     {
-        uint view_id;
-        uint action;
-        g_variant_get(parameters, "(uu)", &view_id, &action);
+        GVariantBuilder builder;
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a{ua{sv}}"));
+        for (const dbus_output_record_t& record : dbus_output_registry_get())
         {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
-
-                return;
-            }
-
-            if (action == 0) {
-                view->tile_request(0);
-            }
+            g_variant_builder_add(&builder, "{u@a{sv}}",
+                                  record.output->get_id(), record.entry);
+        }
 
-            else
-            if (action == 1)
-            {
-                view->tile_request(wf::TILED_EDGES_ALL);
-            }
+        method_return(invocation, g_variant_new("(a{ua{sv}})", &builder));
 
-            else
-            if (action == 2)
-            {
-                if (view->tiled_edges == wf::TILED_EDGES_ALL) {
-                    view->tile_request(0);
-                }
-                else
-                {
-                    view->tile_request(wf::TILED_EDGES_ALL);
-                }
-            }
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_workspace_grid_size") == 0)
+    {
+        dbus_workspace_t workspaces;
+        workspaces = dbus_core->get_active_output()->get_workspace_grid_size();
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation,
+                      g_variant_new("(ii)", workspaces.x, workspaces.y));
 
         return;
     }
+    /*************** View Properties ****************/
     else
-    if (g_strcmp0(method_name, "focus_view") == 0)
+    if (g_strcmp0(method_name, "query_workspace_summary") == 0)
     {
-        uint view_id;
-        uint action;
-        g_variant_get(parameters, "(uu)", &view_id, &action);
+        uint output_id;
+        dbus_output_t* output;
+        dbus_workspace_summary_t summary;
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
+        g_variant_get(parameters, "(u)", &output_id);
+        output = get_output_from_output_id(output_id);
+        if (!output) {
+            summary.grid = {0, 0};
+        }
+        else
         {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
-
-                return;
-            }
-
-            if (action == 0) {
-                view->set_activated(false);
-            }
-
-            else
-            if (action == 1)
-            {
-                view->set_activated(true);
-                view->focus_request();
-            }
-
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+            dbus_workspace_summary_get(output, &summary);
+        }
+
+        method_return(invocation,
+                      g_variant_new("(ii@autttt)", summary.grid.x,
+                                    summary.grid.y,
+                                    g_variant_new_fixed_array(
+                                        G_VARIANT_TYPE_UINT32,
+                                        summary.views.data(),
+                                        summary.views.size(),
+                                        sizeof(uint32_t)),
+                                    (guint64)summary.masks.occupied,
+                                    (guint64)summary.masks.urgent,
+                                    (guint64)summary.masks.focused,
+                                    (guint64)summary.masks.fullscreen));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "fullscreen_view") == 0)
+    if (g_strcmp0(method_name, "query_view_above_view") == 0)
     {
         uint view_id;
-        uint action;
-        g_variant_get(parameters, "(uu)", &view_id, &action);
+        g_variant_get(parameters, "(u)", &view_id);
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
+        dbus_view_t* view = get_view_from_view_id(view_id);
+        dbus_output_t* output;
+        int view_above = -1;
+        std::vector<dbus_view_t*> workspace_views;
 
-                return;
-            }
+        if (!check_view_toplevel(view)) {
+            method_return(invocation, g_variant_new("(i)", view_above));
 
-            wf::output_t* output = core.get_active_output();
+            return;
+        }
 
-            if (action == 0) {
-                view->fullscreen_request(output, false);
-            }
+        while (view->get_parent())
+        {
+            view = view->get_parent();
+        }
 
-            else
-            if (action == 1)
-            {
-                view->fullscreen_request(output, true);
-            }
+        if (!check_view_toplevel(view)) {
+            method_return(invocation, g_variant_new("(i)", view_above));
 
-            else
-            if (action == 2)
-            {
-                view->fullscreen_request(output, !view->fullscreen);
-            }
+            return;
+        }
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        output = view->get_output();
+        if (!output) {
+            method_return(invocation, g_variant_new("(i)", view_above));
 
-        return;
-    }
-    else
-    if (g_strcmp0(method_name, "close_view") == 0)
-    {
-        uint view_id;
-        g_variant_get(parameters, "(u)", &view_id);
+            return;
+        }
+
+        workspace_views = dbus_core->get_stacked_views(output);
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
+        for (size_t i = 0; i + 1 < workspace_views.size(); i++)
         {
-            wayfire_view view = get_view_from_view_id(view_id);
+            dbus_view_t* v = workspace_views[i];
+            if (!check_view_toplevel(v)) {
+                continue;
+            }
 
-            if (check_view_toplevel(view)) {
-                view->close();
+            if (v == view) {
+                if (i != 0) {
+                    if (check_view_toplevel(workspace_views[i - 1])) {
+                        view_above = workspace_views[i - 1]->get_id();
+                    }
+
+                    break;
+                }
             }
+        }
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation, g_variant_new("(i)", view_above));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "change_view_minimize_hint") == 0)
+    if (g_strcmp0(method_name, "query_view_below_view") == 0)
     {
         uint view_id;
-        int x, y, width, height;
+        g_variant_get(parameters, "(u)", &view_id);
 
-        g_variant_get(parameters, "(uiiii)", &view_id, &x, &y, &width, &height);
+        dbus_view_t* view = get_view_from_view_id(view_id);
+        dbus_output_t* output;
+        int view_below = -1;
+        std::vector<dbus_view_t*> workspace_views;
+
+        if (!check_view_toplevel(view)) {
+            method_return(invocation, g_variant_new("(i)", view_below));
+
+            return;
+        }
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
+        while (view->get_parent())
         {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
-
-                return;
-            }
+            view = view->get_parent();
+        }
 
-            view->set_minimize_hint({x, y, width, height});
-            delete idle_call;
-        });
+        if (!check_view_toplevel(view)) {
+            method_return(invocation, g_variant_new("(i)", view_below));
 
-        g_dbus_method_invocation_return_value(invocation, nullptr);
+            return;
+        }
 
-        return;
-    }
+        output = view->get_output();
+        if (!output) {
+            method_return(invocation, g_variant_new("(i)", view_below));
 
-    else
-    if (g_strcmp0(method_name, "change_output_view") == 0)
-    {
-        uint view_id;
-        uint output_id;
+            return;
+        }
 
-        g_variant_get(parameters, "(uu)", &view_id, &output_id);
+        workspace_views = dbus_core->get_stacked_views(output);
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
+        for (size_t i = 0; i + 1 < workspace_views.size(); i++)
         {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
-
-                return;
+            dbus_view_t* v = workspace_views[i];
+            if (!check_view_toplevel(v)) {
+                continue;
             }
 
-            wf::output_t* output = get_output_from_output_id(output_id);
-            if (output) {
-                core.move_view_to_output(view, output, TRUE);
+            if (v == view) {
+                if (check_view_toplevel(workspace_views[i + 1])) {
+                    view_below = workspace_views[i + 1]->get_id();
+                }
+
+                break;
             }
+        }
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation, g_variant_new("(i)", view_below));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "change_workspace_view") == 0)
+    if (g_strcmp0(method_name, "query_view_app_id") == 0)
     {
         uint view_id;
-        int new_workspace_x;
-        int new_workspace_y;
-
-        g_variant_get(parameters, "(uii)", &view_id, &new_workspace_x,
-                      &new_workspace_y);
+        gchar* response = "nullptr";
+        GVariant* app_id;
+        dbus_view_t* view;
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wayfire_view view = get_view_from_view_id(view_id);
-            if (!check_view_toplevel(view)) {
-                delete idle_call;
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-                return;
-            }
+        if (!check_view_toplevel(view)) {
+            method_return(invocation, g_variant_new("(s)", response));
 
-            wf::point_t new_workspace_coord = {new_workspace_x, new_workspace_y};
-            wf::output_t* output = view->get_output();
-            output->workspace->move_to_workspace(view, new_workspace_coord);
-            delete idle_call;
-        });
+            return;
+        }
 
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        app_id = view_string(view, VIEW_STRING_APP_ID);
+        method_return(invocation, g_variant_new_tuple(&app_id, 1));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "change_workspace_output") == 0)
+    if (g_strcmp0(method_name, "query_view_app_id_gtk_shell") == 0)
     {
-        uint output_id;
-        int new_workspace_x;
-        int new_workspace_y;
+        uint view_id;
+        gchar* response = "nullptr";
+        dbus_view_t* view;
 
-        g_variant_get(parameters, "(uii)", &output_id, &new_workspace_x,
-                      &new_workspace_y);
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wf::output_t* output = get_output_from_output_id(output_id);
+        if (!check_view_toplevel(view)) {
+            method_return(invocation, g_variant_new("(s)", response));
 
-            if (output) {
-                wf::point_t new_workspace_coord;
-                new_workspace_coord = {new_workspace_x, new_workspace_y};
-                output->workspace->request_workspace(new_workspace_coord);
-                // Provides animation if available
-            }
+            return;
+        }
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation,
+                      g_variant_new("(s)",
+                                    view->get_gtk_shell_app_id().c_str()));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "change_workspace_all_outputs") == 0)
+    if (g_strcmp0(method_name, "query_view_app_id_xwayland_net_wm_name") ==
+        0)
     {
-        int new_workspace_x;
-        int new_workspace_y;
-
-        g_variant_get(parameters, "(ii)", &new_workspace_x, &new_workspace_y);
+        uint view_id;
+        dbus_view_t* view;
+        std::string wm_name_app_id = "nullptr";
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once([=] ()
-        {
-            wf::point_t new_workspace_coord;
-            new_workspace_coord = {new_workspace_x, new_workspace_y};
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-            for (wf::output_t* output : wf_outputs)
-            {
-                if (output) {
-                    output->workspace->request_workspace(new_workspace_coord);
-                }
-            }
+        if (view && view->get_xwayland_window_id()) {
+            wm_name_app_id = view->get_xwayland_instance();
+        }
 
-            delete idle_call;
-        });
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        method_return(invocation,
+                      g_variant_new("(s)", wm_name_app_id.c_str()));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "show_desktop") == 0)
+    if (g_strcmp0(method_name, "query_view_title") == 0)
     {
-        // g_variant_ref(parameters);
-        // wl_event_loop_add_idle(core.ev_loop,
-        // local_thread_show_desktop,
-        // static_cast<void*> (parameters));
-        g_dbus_method_invocation_return_value(invocation, NULL);
+        uint view_id;
+        gchar* response = "nullptr";
+        GVariant* title;
+        dbus_view_t* view;
 
-        return;
-    }
-    else
-    if (g_strcmp0(method_name, "scale") == 0)
-    {
-        gboolean all_workspaces = FALSE;
-        gchar* app_id = nullptr;
-        g_variant_get(parameters, "(bs)", &all_workspaces, &app_id);
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-        wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-        idle_call->run_once(
-            [all_workspaces, app_id = std::string(app_id), idle_call] ()
-        {
-            wf::output_t* output = core.get_active_output();
-            auto filter = dbus_scale_filter::get(output);
-            filter->set_filter(std::move(app_id));
+        if (!check_view_toplevel(view)) {
+            method_return(invocation, g_variant_new("(s)", response));
 
-            if (output->is_plugin_active("scale")) {
-                output->emit_signal("scale-update", nullptr);
-            }
-            else
-            {
-                wf::activator_data_t adata;
-                adata.source = wf::activator_source_t::PLUGIN;
-                output->call_plugin(
-                    all_workspaces ? "scale/toggle_all" : "scale/toggle", adata);
-            }
+            return;
+        }
 
-            delete idle_call;
-        });
+        title = view_string(view, VIEW_STRING_TITLE);
+        method_return(invocation, g_variant_new_tuple(&title, 1));
 
-        g_dbus_method_invocation_return_value(invocation, nullptr);
+        return;
     }
-
-    /*************** Non-reffing actions at end ****************/
     else
-    if (g_strcmp0(method_name, "enable_property_mode") == 0)
+    if (g_strcmp0(method_name, "query_view_attention") == 0)
     {
-        bool enable;
-        g_variant_get(parameters, "(b)", &enable);
-        find_view_under_action = enable;
-
-        /**
-         * Eventually store current cursor
-         * and restore it if different from
-         * "default"
-         */
-        if (enable) {
-            for (wf::output_t* output : wf_outputs)
-            {
-                if (!output->activate_plugin(grab_interfaces[output])) {
-                    continue;
-                }
-
-                grab_interfaces[output]->grab();
-            }
+        uint view_id;
+        bool attention = false;
+        dbus_view_t* view;
 
-            wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-            idle_call->run_once([core, idle_call] ()
-            {
-                core.set_cursor("crosshair");
-                delete idle_call;
-            });
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
+        if (!check_view_toplevel(view)) {
+            return;
         }
-        else
-        {
-            for (wf::output_t* output : wf_outputs)
-            {
-                output->deactivate_plugin(grab_interfaces[output]);
-                grab_interfaces[output]->ungrab();
-            }
 
-            wf::wl_idle_call* idle_call = new wf::wl_idle_call;
-            idle_call->run_once([=] ()
-            {
-                core.set_cursor("default");
-                delete idle_call;
-            });
+        if (view->demands_attention()) {
+            attention = true;
         }
 
-        g_dbus_method_invocation_return_value(invocation, nullptr);
+        method_return(invocation, g_variant_new("(b)", attention));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_cursor_position") == 0)
+    if (g_strcmp0(method_name, "query_xwayland_display") == 0)
     {
-        /*
-         * It uses the output relative cursor position
-         * as expected by minimize rect and popup positions
-         */
-        wf::pointf_t cursor_position;
-        GVariant* value;
+        std::string xdisplay = dbus_core->get_xwayland_display();
 
-        cursor_position = core.get_active_output()->get_cursor_position();
-        value = g_variant_new("(dd)", cursor_position.x, cursor_position.y);
-        g_dbus_method_invocation_return_value(invocation, value);
+        method_return(invocation, g_variant_new("(s)", xdisplay.c_str()));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_output_ids") == 0)
+    if (g_strcmp0(method_name, "query_worker_stats") == 0)
     {
+        dbus_query_pool_stats_t stats = dbus_query_pool_get_stats();
         GVariantBuilder builder;
-        GVariant* value;
 
-        g_variant_builder_init(&builder, G_VARIANT_TYPE("au"));
-
-        for (wf::output_t* wf_output : wf_outputs)
-        {
-            g_variant_builder_add(&builder, "u", wf_output->get_id());
-        }
-
-        value = g_variant_new("(au)", &builder);
-        g_dbus_method_invocation_return_value(invocation, value);
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+        g_variant_builder_add(&builder, "{sv}", "threads",
+                              g_variant_new_uint32(DBUS_QUERY_POOL_THREADS));
+        g_variant_builder_add(&builder, "{sv}", "pending",
+                              g_variant_new_uint32(stats.pending));
+        g_variant_builder_add(&builder, "{sv}", "started",
+                              g_variant_new_uint64(stats.started));
+        g_variant_builder_add(&builder, "{sv}", "completed",
+                              g_variant_new_uint64(stats.completed));
+        g_variant_builder_add(&builder, "{sv}", "timed_out",
+                              g_variant_new_uint64(stats.timed_out));
+        g_variant_builder_add(&builder, "{sv}", "queue_time_total_us",
+                              g_variant_new_uint64(stats.queue_time_total));
+        g_variant_builder_add(&builder, "{sv}", "queue_time_max_us",
+                              g_variant_new_uint64(stats.queue_time_max));
+
+        method_return(invocation, g_variant_new("(a{sv})", &builder));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_active_output") == 0)
+    if (g_strcmp0(method_name, "query_view_xwayland_wid") == 0)
     {
-        uint output_id;
-        output_id = core.get_active_output()->get_id();
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(u)", output_id));
+        uint view_id;
+        uint window_id = 0;
+        dbus_view_t* view;
 
-        return;
-    }
-    else
-    if (g_strcmp0(method_name, "query_view_vector_ids") == 0)
-    {
-        std::vector<nonstd::observer_ptr<wf::view_interface_t>> view_vector;
-        GVariantBuilder builder;
-        GVariant* value;
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-        view_vector = core.get_all_views();
-        g_variant_builder_init(&builder, G_VARIANT_TYPE("au"));
-        for (auto it = begin(view_vector); it != end(view_vector); ++it)
-        {
-            g_variant_builder_add(&builder, "u", it->get()->get_id());
+        if (view) {
+            window_id = view->get_xwayland_window_id();
         }
 
-        value = g_variant_new("(au)", &builder);
-        g_dbus_method_invocation_return_value(invocation, value);
+        method_return(invocation, g_variant_new("(u)", window_id));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_view_vector_taskman_ids") == 0)
+    if (g_strcmp0(method_name, "query_view_xwayland_atom_cardinal") == 0)
     {
-        std::vector<nonstd::observer_ptr<wf::view_interface_t>> view_vector =
-            core.get_all_views();
-        GVariantBuilder builder;
-        GVariant* value;
+        uint view_id;
+        uint window_id;
+        const gchar* atom_name;
+        std::string atom;
+        std::string xdisplay;
+        dbus_view_t* view;
 
-        g_variant_builder_init(&builder, G_VARIANT_TYPE("au"));
-        for (auto it = begin(view_vector); it != end(view_vector); ++it)
-        {
-            if ((it->get()->role != wf::VIEW_ROLE_TOPLEVEL) ||
-                !it->get()->is_mapped()) {
-                continue;
-            }
-            else
-            {
-                g_variant_builder_add(&builder, "u", it->get()->get_id());
-            }
+        g_variant_get(parameters, "(u&s)", &view_id, &atom_name);
+        view = get_view_from_view_id(view_id);
+
+        if (!view) {
+            method_return(invocation, g_variant_new("(u)", 0));
+
+            return;
         }
 
-        value = g_variant_new("(au)", &builder);
-        g_dbus_method_invocation_return_value(invocation, value);
+        window_id = view->get_xwayland_window_id();
+        if (window_id == 0) {
+            method_return(invocation, g_variant_new("(u)", 0));
+
+            return;
+        }
+
+        atom     = atom_name;
+        xdisplay = dbus_core->get_xwayland_display();
+        method_return_blocking(invocation, [=] ()
+        {
+            return xwayland_atom_cardinal(xdisplay, window_id, atom);
+        });
 
         return;
     }
-    /*************** Output Properties ****************/
     else
-    if (g_strcmp0(method_name, "query_output_name") == 0)
+    if (g_strcmp0(method_name, "query_view_xwayland_atom_string") == 0)
     {
-        uint output_id;
-        gchar* response = "nullptr";
-        g_variant_get(parameters, "(u)", &output_id);
-        wf::output_t* wf_output = get_output_from_output_id(output_id);
+        uint view_id;
+        uint window_id;
+        const gchar* atom_name;
+        std::string atom;
+        std::string xdisplay;
+
+        g_variant_get(parameters, "(u&s)", &view_id, &atom_name);
 
-        if (wf_output != nullptr) {
-            response = g_strdup_printf(wf_output->to_string().c_str());
+        dbus_view_t* view = get_view_from_view_id(view_id);
+
+        if (!view) {
+            method_return(invocation, g_variant_new("(s)", "View not found."));
+
+            return;
         }
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
-        if (wf_output != nullptr) {
-            g_free(response);
+        window_id = view->get_xwayland_window_id();
+        if (window_id == 0) {
+            method_return(invocation,
+                          g_variant_new("(s)", "Not an xwayland surface."));
+
+            return;
         }
 
+        atom     = atom_name;
+        xdisplay = dbus_core->get_xwayland_display();
+        method_return_blocking(invocation, [=] ()
+        {
+            return xwayland_atom_string(xdisplay, window_id, atom);
+        });
+
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_output_manufacturer") == 0)
+    if (g_strcmp0(method_name, "query_view_credentials") == 0)
     {
-        uint output_id;
-        gchar* response = "nullptr";
-        wf::output_t* output;
-        wlr_output* wlr_output = nullptr;
+        uint view_id;
+        uint window_id;
+        pid_t pid = 0;
+        uid_t uid = 0;
+        gid_t gid = 0;
+        std::string xdisplay;
+        dbus_view_t* view;
 
-        g_variant_get(parameters, "(u)", &output_id);
-        output = get_output_from_output_id(output_id);
-        if (output) {
-            wlr_output = output->handle;
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-            if (wlr_output != nullptr) {
-                response = g_strdup_printf(wlr_output->make);
-            }
+        if (!view) {
+            method_return(invocation, g_variant_new("(iuu)", 0, 0, 0));
+
+            return;
         }
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
-        if (wlr_output != nullptr) {
-            g_free(response);
+        view->get_client_credentials(&pid, &uid, &gid);
+        window_id = view->get_xwayland_window_id();
+        if (window_id != 0) {
+            xdisplay = dbus_core->get_xwayland_display();
+            method_return_blocking(invocation, [=] ()
+            {
+                return xwayland_credentials(xdisplay, window_id, pid, uid, gid);
+            });
+
+            return;
         }
 
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG, "returning standard credentials.");
+#endif
+        method_return(invocation, g_variant_new("(iuu)", pid, uid, gid));
+
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_output_model") == 0)
+    if (g_strcmp0(method_name, "query_view_above") == 0)
     {
-        uint output_id;
-        gchar* response = "nullptr";
-        wf::output_t* output;
-        wlr_output* wlr_output = nullptr;
+        dbus_view_t* view;
+        uint view_id;
+        bool above;
 
-        g_variant_get(parameters, "(u)", &output_id);
-        output = get_output_from_output_id(output_id);
-        if (output) {
-            wlr_output = output->handle;
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
+        above = false;
 
-            if (wlr_output != nullptr) {
-                response = g_strdup_printf(wlr_output->model);
+        if (view) {
+            if (view->is_above()) {
+                above = true;
             }
         }
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
-        if (wlr_output != nullptr) {
-            g_free(response);
+#ifdef DBUS_PLUGIN_DEBUG
+        else
+        {
+            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_above no view");
         }
+#endif
+        method_return(invocation, g_variant_new("(b)", above));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_output_serial") == 0)
+    if (g_strcmp0(method_name, "query_view_maximized") == 0)
     {
-        uint output_id;
-        gchar* response = "nullptr";
-        wf::output_t* wf_output;
-        wlr_output* wlr_output = nullptr;
+        dbus_view_t* view;
+        uint view_id;
+        bool response = false;
 
-        g_variant_get(parameters, "(u)", &output_id);
-        wf_output = get_output_from_output_id(output_id);
-        wlr_output = wf_output->handle;
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-        if (wlr_output != nullptr) {
-            response = g_strdup_printf(wlr_output->serial);
+        if (view) {
+            response = view->is_maximized();
         }
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
-        if (wlr_output != nullptr) {
-            g_free(response);
+#ifdef DBUS_PLUGIN_DEBUG
+        else
+        {
+            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_maximized no view");
         }
+#endif
+        method_return(invocation, g_variant_new("(b)", response));
 
         return;
     }
+
     else
-    if (g_strcmp0(method_name, "query_output_workspace") == 0)
+    if (g_strcmp0(method_name, "query_view_active") == 0)
     {
-        uint output_id;
-        uint horizontal_workspace = 0;
-        uint vertical_workspace = 0;
-        wf::output_t* wf_output;
-        wf::point_t ws;
+        dbus_view_t* view;
+        uint view_id;
+        bool response = false;
 
-        g_variant_get(parameters, "(u)", &output_id);
-        wf_output = get_output_from_output_id(output_id);
-        if (wf_output) {
-            ws = wf_output->workspace->get_current_workspace();
-            horizontal_workspace = ws.x;
-            vertical_workspace = ws.y;
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
+
+        if (view) {
+            response = view->is_activated();
         }
 
-        g_dbus_method_invocation_return_value(
-            invocation,
-            g_variant_new("(uu)", horizontal_workspace, vertical_workspace));
+#ifdef DBUS_PLUGIN_DEBUG
+        else
+        {
+            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_active no view");
+        }
+#endif
+        method_return(invocation, g_variant_new("(b)", response));
 
         return;
     }
+
     else
-    if (g_strcmp0(method_name, "query_workspace_grid_size") == 0)
+    if (g_strcmp0(method_name, "query_view_minimized") == 0)
     {
-        wf::dimensions_t workspaces;
-        workspaces = core.get_active_output()->workspace->get_workspace_grid_size();
+        dbus_view_t* view;
+        uint view_id;
+        bool response = false;
+
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
+
+        if (view) {
+            response = view->is_minimized();
+        }
 
-        g_dbus_method_invocation_return_value(
-            invocation, g_variant_new("(ii)", workspaces.width, workspaces.height));
+#ifdef DBUS_PLUGIN_DEBUG
+        else
+        {
+            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_minimized no view");
+        }
+#endif
+        method_return(invocation, g_variant_new("(b)", response));
 
         return;
     }
-    /*************** View Properties ****************/
+
     else
-    if (g_strcmp0(method_name, "query_view_above_view") == 0)
+    if (g_strcmp0(method_name, "query_view_fullscreen") == 0)
     {
         uint view_id;
-        g_variant_get(parameters, "(u)", &view_id);
-
-        wayfire_view view = get_view_from_view_id(view_id);
-        wf::output_t* output;
-        int view_above = -1;
-        std::vector<wayfire_view> workspace_views;
+        bool response = false;
+        dbus_view_t* view;
 
-        if (!check_view_toplevel(view)) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(i)", view_above));
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-            return;
+        if (view) {
+            response = view->is_fullscreen();
         }
 
-        while (view->parent)
+#ifdef DBUS_PLUGIN_DEBUG
+        else
         {
-            view = view->parent;
-        }
-
-        if (!check_view_toplevel(view)) {
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(i)", view_above));
-
-            return;
+            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_fullscreen no view");
         }
+#endif
+        method_return(invocation, g_variant_new("(b)", response));
 
-        output = view->get_output();
-        if (!output) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(i)", view_above));
-
-            return;
-        }
+        return;
+    }
+    else
+    if (g_strcmp0(method_name, "query_view_output") == 0)
+    {
+        uint view_id;
+        uint output_id = 0;
+        dbus_view_t* view;
 
-        workspace_views =
-            output->workspace->get_views_in_layer(wf::MIDDLE_LAYERS);
+        g_variant_get(parameters, "(u)", &view_id);
+        view = get_view_from_view_id(view_id);
 
-        for (int i = 0; i < workspace_views.size() - 1; i++)
-        {
-            wayfire_view v = workspace_views[i];
-            if (!check_view_toplevel(v)) {
-                continue;
+        if (view) {
+            if (view->get_output()) {
+                output_id = view->get_output()->get_id();
             }
 
-            if (v == view) {
-                if (i != 0) {
-                    if (check_view_toplevel(workspace_views[i - 1])) {
-                        view_above = workspace_views[i - 1]->get_id();
-                    }
+#ifdef DBUS_PLUGIN_DEBUG
 
-                    break;
-                }
+            else
+            {
+                g_warning("No output for view.");
             }
+#endif
         }
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(i)", view_above));
+        method_return(invocation, g_variant_new("(u)", output_id));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_view_below_view") == 0)
+    if (g_strcmp0(method_name, "query_view_workspaces") == 0)
     {
-        uint view_id;
-        g_variant_get(parameters, "(u)", &view_id);
-
-        wayfire_view view = get_view_from_view_id(view_id);
-        wf::output_t* output;
-        int view_below = -1;
-        std::vector<wayfire_view> workspace_views;
-
-        if (!check_view_toplevel(view)) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(i)", view_below));
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_workspaces ");
+#endif
 
-            return;
-        }
+        uint view_id;
+        GVariantBuilder builder;
+        GVariant* value;
 
-        while (view->parent)
-        {
-            view = view->parent;
-        }
+        g_variant_get(parameters, "(u)", &view_id);
+        dbus_view_t* view = get_view_from_view_id(view_id);
 
         if (!check_view_toplevel(view)) {
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(i)", view_below));
-
-            return;
-        }
+#ifdef DBUS_PLUGIN_DEBUG
 
-        output = view->get_output();
-        if (!output) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(i)", view_below));
+            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_workspaces no view");
+#endif
+            method_return(invocation, NULL);
 
             return;
         }
 
-        workspace_views =
-            output->workspace->get_views_in_layer(wf::MIDDLE_LAYERS);
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a(ii)"));
 
-        for (int i = 0; i < workspace_views.size() - 1; i++)
+        for (const dbus_workspace_t& ws : view->get_workspaces())
         {
-            wayfire_view v = workspace_views[i];
-            if (!check_view_toplevel(v)) {
-                continue;
-            }
-
-            if (v == view) {
-                if (i != workspace_views.size() - 1) {
-                    if (check_view_toplevel(workspace_views[i + 1])) {
-                        view_below = workspace_views[i + 1]->get_id();
-                    }
-
-                    break;
-                }
-            }
-
-            // if (view_below != -1)
-            // {
-            // g_warning("Below %s  is  %s", view->get_title().c_str(),
-            // get_view_from_view_id(view_below)->get_title().c_str());
-            // }
-            // else
-            // {
-            // g_warning("No view below %s", view->get_title().c_str());
-            // }
+            g_variant_builder_add(&builder, "(ii)", ws.x, ws.y);
         }
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(i)", view_below));
+        value = g_variant_new("(a(ii))", &builder);
+        method_return(invocation, value);
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_view_app_id") == 0)
+    if (g_strcmp0(method_name, "query_view_group_leader") == 0)
     {
         uint view_id;
-        gchar* response = "nullptr";
-        wayfire_view view;
+        uint group_leader_view_id;
 
         g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
-
-        if (!check_view_toplevel(view)) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(s)", response));
-
-            return;
-        }
+        group_leader_view_id = dbus_view_group_leader(focus_view_id(view_id));
 
-        response = g_strdup(view->get_app_id().c_str());
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
-        g_free(response);
+        method_return(invocation, g_variant_new("(u)", group_leader_view_id));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_view_app_id_gtk_shell") == 0)
+    if (g_strcmp0(method_name, "query_view_group") == 0)
     {
         uint view_id;
-        gchar* response = "nullptr";
-        wayfire_view view;
+        uint group_leader_view_id;
+        std::vector<uint32_t> ids;
+        GVariant* children [2];
 
         g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
-
-        if (!check_view_toplevel(view)) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(s)", response));
+        group_leader_view_id = dbus_view_group_leader(focus_view_id(view_id));
+        dbus_view_group_transients(group_leader_view_id, &ids);
 
-            return;
-        }
-
-        response = g_strdup(get_gtk_shell_app_id(view).c_str());
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
-        g_free(response);
+        children[0] = g_variant_new_uint32(group_leader_view_id);
+        children[1] = g_variant_new_fixed_array(G_VARIANT_TYPE_UINT32,
+                                                ids.data(), ids.size(),
+                                                sizeof(uint32_t));
+        method_return(invocation, g_variant_new_tuple(children, 2));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_view_app_id_xwayland_net_wm_name") ==
-        0)
+    if (g_strcmp0(method_name, "query_view_role") == 0)
     {
         uint view_id;
-        gchar* response = "nullptr";
-        wayfire_view view;
-        bool free_response = false;
+        uint response = DBUS_VIEW_ROLE_UNKNOWN;
+        dbus_view_t* view;
 
         g_variant_get(parameters, "(u)", &view_id);
         view = get_view_from_view_id(view_id);
 
         if (view) {
-            auto wlr_surf = view->get_wlr_surface();
-            if (!wlr_surf) {
-                g_dbus_method_invocation_return_value(invocation,
-                                                      g_variant_new("(s)", response));
-
-                return;
-            }
-
-            if (wlr_surface_is_xwayland_surface(wlr_surf)) {
-                struct wlr_xwayland_surface* xsurf;
-                xsurf = wlr_xwayland_surface_from_wlr_surface(wlr_surf);
-                if (!xsurf) {
-                    g_dbus_method_invocation_return_value(invocation,
-                                                          g_variant_new("(s)", response));
+            if (view->is_mapped()) {
+                response = view->get_role();
 
-                    return;
+                if ((response == DBUS_VIEW_ROLE_TOPLEVEL) &&
+                    view->is_modal_dialog()) {
+                    response = DBUS_VIEW_ROLE_UNKNOWN;
                 }
-
-                g_assert(xsurf != NULL);
-                std::string wm_name_app_id = nonull(xsurf->instance);
-                response = g_strdup_printf(wm_name_app_id.c_str());
-                free_response = true;
             }
         }
 
-        if (free_response) {
-            g_free(response);
-        }
-
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
+        method_return(invocation, g_variant_new("(u)", response));
 
         return;
     }
     else
-    if (g_strcmp0(method_name, "query_view_title") == 0)
+    if (g_strcmp0(method_name, "query_view_test_data") == 0)
     {
         uint view_id;
-        gchar* response = "nullptr";
-        wayfire_view view;
+        uint width;
+        uint height;
+        dbus_view_t* view;
 
         g_variant_get(parameters, "(u)", &view_id);
         view = get_view_from_view_id(view_id);
 
-        if (!check_view_toplevel(view)) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(s)", response));
+        if (!check_view_toplevel(view))
+        {
+            method_return(invocation, g_variant_new("(uu)", 0, 0));
 
             return;
         }
 
-        response = g_strdup_printf(view->get_title().c_str());
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", response));
-        g_free(response);
+        if (view->get_xwayland_size(&width, &height)) {
+            method_return(invocation, g_variant_new("(uu)", width, height));
+        }
 
         return;
     }
+
+    /*************** Other Actions ****************/
     else
-    if (g_strcmp0(method_name, "query_view_attention") == 0)
+    if (g_strcmp0(method_name, "inhibit_output_start") == 0)
     {
-        uint view_id;
-        bool attention = false;
-        wayfire_view view;
+        g_variant_unref(parameters);
+    }
+    else
+    if (g_strcmp0(method_name, "inhibit_output_stop") == 0)
+    {
+        g_variant_unref(parameters);
+    }
+    else
+    if (g_strcmp0(method_name, "trigger_show_desktop") == 0)
+    {
+        g_variant_unref(parameters);
+    }
+    else
+    if (g_strcmp0(method_name, "trigger_show_overview") == 0)
+    {
+        g_variant_unref(parameters);
+    }
+}
 
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
-        if (!check_view_toplevel(view)) {
-            return;
-        }
+static GVariant*
+handle_get_property (GDBusConnection* connection,
+                     const gchar* sender,
+                     const gchar* object_path,
+                     const gchar* interface_name,
+                     const gchar* property_name, GError** error,
+                     gpointer user_data)
+{
+    // returning nullptr would crash compositor
+    GVariant* ret = g_variant_new_string("nullptr");
 
-        if (view->has_data("view-demands-attention")) {
-            attention = true;
+    /* unused */
+    return ret;
+}
+
+static gboolean
+handle_set_property (GDBusConnection* connection,
+                     const gchar* sender,
+                     const gchar* object_path,
+                     const gchar* interface_name,
+                     const gchar* property_name, GVariant* value,
+                     GError** error, gpointer user_data)
+{
+    /* unused */
+    return false;
+}
+
+static const GDBusInterfaceVTable interface_vtable = {
+    handle_method_call, handle_get_property, handle_set_property, {0}
+};
+
+/***
+ * Takes signal_data, either floating (fresh from g_variant_new_*)
+ * or a reference the caller hands over.
+ ***/
+gboolean
+bus_emit_signal (const gchar* signal_name, GVariant* signal_data)
+{
+    GError* local_error = NULL;
+    if (signal_data != nullptr) {
+        g_variant_take_ref(signal_data);
+    }
+
+    if (signal_sink) {
+        signal_sink(signal_name, signal_data);
+    }
+
+    if (!dbus_connection) {
+        if (signal_data != nullptr) {
+            g_variant_unref(signal_data);
         }
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(b)", attention));
-
-        return;
+        return true;
     }
-    else
-    if (g_strcmp0(method_name, "query_xwayland_display") == 0)
-    {
-        const char* xdisplay = core.get_xwayland_display().c_str();
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(s)", xdisplay));
+    g_dbus_connection_emit_signal(
+        dbus_connection, nullptr, "/org/wayland/compositor",
+        "org.wayland.compositor", signal_name, signal_data, &local_error);
+    g_assert_no_error(local_error);
 
-        return;
+    if (signal_data != nullptr) {
+        g_variant_unref(signal_data);
     }
-    else
-    if (g_strcmp0(method_name, "query_view_xwayland_wid") == 0)
-    {
-        uint view_id;
-        wayfire_view view;
-
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
-
-        if (!view) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(u)", 0));
-
-            return;
-        }
 
-        if (xwayland_enabled == 1) {
-            auto main_wlr_surface = view->get_main_surface()->get_wlr_surface();
-            if (!main_wlr_surface) {
-                g_dbus_method_invocation_return_value(invocation,
-                                                      g_variant_new("(u)", 0));
+    return true;
+}
 
-                return;
-            }
+static void
+on_bus_acquired (GDBusConnection* connection, const gchar* name,
+                 gpointer user_data)
+{
+    uint registration_id;
 
-            if (wlr_surface_is_xwayland_surface(main_wlr_surface)) {
+    dbus_connection = connection;
+    registration_id = g_dbus_connection_register_object(
+        connection, "/org/wayland/compositor", introspection_data->interfaces[0],
+        &interface_vtable, nullptr, nullptr, nullptr);
 #ifdef DBUS_PLUGIN_DEBUG
-                LOG(wf::log::LOG_LEVEL_DEBUG, "xwayland is the surface type.");
+    LOG(wf::log::LOG_LEVEL_DEBUG, "Acquired the Bus");
 #endif
-                struct wlr_xwayland_surface* main_xsurf;
-                main_xsurf = wlr_xwayland_surface_from_wlr_surface(main_wlr_surface);
-                g_dbus_method_invocation_return_value(
-                    invocation, g_variant_new("(u)", main_xsurf->window_id));
+}
 
-                return;
-            }
-        }
+static void
+on_name_acquired (GDBusConnection* connection, const gchar* name,
+                  gpointer user_data)
+{
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG,
+        "Acquired the name " + std::string(name) + "on the session bus\n");
+#endif
+}
 
-        g_dbus_method_invocation_return_value(invocation, g_variant_new("(u)", 0));
+static void
+on_name_lost (GDBusConnection* connection, const gchar* name,
+              gpointer user_data)
+{
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG,
+        "Lost the name " + std::string(name) + "on the session bus");
+#endif
+}
 
-        return;
-    }
-    else
-    if (g_strcmp0(method_name, "query_view_xwayland_atom_cardinal") == 0)
-    {
-        uint view_id;
-        uint atom_value_cardinal = 0;
-        gchar* atom_name;
-        wayfire_view view;
+void
+acquire_bus ()
+{
+    GBusNameOwnerFlags flags = G_BUS_NAME_OWNER_FLAGS_NONE;
+// flags = G_BUS_NAME_OWNER_FLAGS_DO_NOT_QUEUE;
+    introspection_data = g_dbus_node_info_new_for_xml(introspection_xml, nullptr);
 
-        g_variant_get(parameters, "(us)", &view_id, &atom_name);
-        view = get_view_from_view_id(view_id);
+    owner_id = g_bus_own_name(G_BUS_TYPE_SESSION, "org.wayland.compositor", flags,
+                              on_bus_acquired, on_name_acquired, on_name_lost,
+                              nullptr, nullptr);
+}
 
-        if (!view) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(u)", 0));
+void
+release_bus ()
+{
+    /* the queued queries get an error, the X calls time out */
+    dbus_query_pool_shutdown();
+    dbus_xcb_shutdown();
+    /* the views of the dropped pid tasks stay claimed otherwise */
+    dbus_view_index_invalidate();
+    g_bus_unown_name(owner_id);
+    list_reply_clear(&view_ids_reply);
+    list_reply_clear(&taskman_ids_reply);
+    list_reply_clear(&output_ids_reply);
+    view_strings_clear();
+    g_dbus_node_info_unref(introspection_data);
+    introspection_data = nullptr;
+    dbus_connection = nullptr;
+}
 
-            return;
-        }
+/******************************View Related Hooks***************************/
+/***
+ * A pointer button is interacted with
+ ***/
+void
+on_pointer_button (dbus_point_t cursor_position, uint32_t button,
+                   bool button_released, dbus_view_t* view_under_cursor)
+{
+    dbus_event_record_view(DBUS_EVENT_POINTER_BUTTON, view_under_cursor,
+                           (int64_t)cursor_position.x,
+                           (int64_t)cursor_position.y, button, button_released);
 
-        auto main_wlr_surface = view->get_main_surface()->get_wlr_surface();
-        if (!main_wlr_surface) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(u)", 0));
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG, "pointer_button_signal");
+#endif
 
-            return;
-        }
+    if (find_view_under_action && button_released) {
+        emit_view_pressed({view_under_cursor ? view_under_cursor->get_id() : 0});
+    }
 
-        if ((xwayland_enabled != 1) ||
-            !wlr_surface_is_xwayland_surface(main_wlr_surface)) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(u)", 0));
+    emit_pointer_clicked({cursor_position.x, cursor_position.y, button,
+                          button_released});
+}
 
-            return;
-        }
+/***
+ * A tablet button is interacted with
+ * TODO: do more for touch events
+ ***/
+void
+on_tablet_button ()
+{
+    dbus_event_record_view(DBUS_EVENT_TABLET_BUTTON, nullptr);
 
-        struct wlr_xwayland_surface* main_xsurf;
-        main_xsurf = wlr_xwayland_surface_from_wlr_surface(main_wlr_surface);
-
-        const char* xdisplay = core.get_xwayland_display().c_str();
-        int screen;
-        xcb_connection_t* conn = xcb_connect(xdisplay, &screen);
-        xcb_intern_atom_cookie_t atom_cookie;
-        xcb_atom_t atom;
-        xcb_intern_atom_reply_t* reply;
-        atom_cookie = xcb_intern_atom(conn, 0, strlen(atom_name), atom_name);
-        reply = xcb_intern_atom_reply(conn, atom_cookie, NULL);
-        if (reply != NULL) {
-            atom = reply->atom;
-            free(reply);
-        }
-        else
-        {
 #ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "reply for querying the atom is empty.");
+    LOG(wf::log::LOG_LEVEL_DEBUG, "tablet_button_signal");
 #endif
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(u)", atom_value_cardinal));
-
-            return;
-        }
+    emit_tablet_touched({});
+}
 
-        xcb_get_property_cookie_t reply_cookie;
-        xcb_get_property_reply_t* reply_value;
-        reply_cookie = xcb_get_property(conn, 0, main_xsurf->window_id, atom,
-                                        XCB_ATOM_ANY, 0, 2048);
-        reply_value = xcb_get_property_reply(conn, reply_cookie, NULL);
-        xcb_disconnect(conn);
+/***
+ * A new view is added to an output.
+ ***/
+void
+on_view_added (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_ADDED, view);
+    list_generation++;
 
-        if (reply_value->type == XCB_ATOM_CARDINAL) {
-            uint* uvalue = (uint*)xcb_get_property_value(reply_value);
-            atom_value_cardinal = *uvalue;
 #ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "value to uint.", atom_value_cardinal);
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_added");
 #endif
-        }
 
+    if (!view) {
 #ifdef DBUS_PLUGIN_DEBUG
-        else
-        {
-            LOG(wf::log::LOG_LEVEL_DEBUG, "requested value is not a cardinal");
-        }
+        LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_added no view");
 #endif
 
-        g_dbus_method_invocation_return_value(
-            invocation, g_variant_new("(u)", atom_value_cardinal));
-
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_xwayland_atom_string") == 0)
-    {
-        uint view_id;
-        gchar* atom_name;
-        gchar* atom_value_string = "No atom value received.";
-
-        g_variant_get(parameters, "(us)", &view_id, &atom_name);
 
-        wayfire_view view = get_view_from_view_id(view_id);
-
-        if (!view) {
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(s)", "View not found."));
+    view_strings_forget(view->get_id());
+    dbus_view_store_update(view);
+    dbus_view_index_add(view);
+    xwayland_pids_resolve();
+    dbus_view_search_update(view);
+    emit_view_added({view->get_id()});
+    app_groups_update(view);
+    workspace_summary_update(view);
+}
 
-            return;
-        }
+/***
+ * The View has received ping timeout.
+ ***/
+void
+on_view_timeout (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_TIMEOUT, view);
 
-        auto main_wlr_surface = view->get_main_surface()->get_wlr_surface();
+    if (!view) {
+        LOGE("view_timeout no view");
 
-        if (!main_wlr_surface) {
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(s)", "main_wlr_surface not found."));
+        return;
+    }
 
-            return;
-        }
+    LOGE("view_timeout ", view->get_id());
 
-        if ((xwayland_enabled != 1) ||
-            !wlr_surface_is_xwayland_surface(main_wlr_surface)) {
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(s)", "Not an xwayland surface."));
+    emit_view_timeout({view->get_id()});
+}
 
-            return;
-        }
+/***
+ * The view has closed.
+ ***/
+void
+on_view_closed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_CLOSED, view);
+    list_generation++;
 
-        struct wlr_xwayland_surface* main_xsurf;
-
-        main_xsurf = wlr_xwayland_surface_from_wlr_surface(main_wlr_surface);
-
-        const char* xdisplay = core.get_xwayland_display().c_str();
-        int screen;
-        xcb_connection_t* conn = xcb_connect(xdisplay, &screen);
-        xcb_intern_atom_cookie_t atom_cookie;
-        xcb_atom_t atom;
-        xcb_intern_atom_reply_t* reply;
-        atom_cookie = xcb_intern_atom(conn, 0, strlen(atom_name), atom_name);
-        reply = xcb_intern_atom_reply(conn, atom_cookie, NULL);
-        if (reply != NULL) {
-            atom = reply->atom;
-            free(reply);
-        }
-        else
-        {
-            g_dbus_method_invocation_return_value(
-                invocation,
-                g_variant_new("(s)", "reply for querying the atom is empty."));
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_closed");
+#endif
 
-            return;
-        }
+    if (!view) {
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG, "view_closed no view");
+#endif
 
-        xcb_get_property_cookie_t reply_cookie = xcb_get_property(
-            conn, 0, main_xsurf->window_id, atom, XCB_ATOM_ANY, 0, 2048);
-        xcb_get_property_reply_t* reply_value =
-            xcb_get_property_reply(conn, reply_cookie, NULL);
+        return;
+    }
 
-        char* value = static_cast<char*> (xcb_get_property_value(reply_value));
+    view_strings_forget(view->get_id());
+    dbus_view_store_remove(view->get_id());
+    dbus_view_index_remove(view->get_id());
+    dbus_view_search_remove(view->get_id());
+    dbus_focus_history_remove(view->get_id());
+    emit_view_closed({view->get_id()});
+    app_groups_remove(view->get_id());
+    workspace_summary_remove(view->get_id());
+}
 
-        xcb_disconnect(conn);
+/***
+ * The view's app_id has changed.
+ ***/
+void
+on_view_app_id_changed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_APP_ID_CHANGED, view);
 
-        if (reply_value->type != XCB_ATOM_CARDINAL) {
-            atom_value_string = value;
 #ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "value to char.", atom_value_string);
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_app_id_changed");
 #endif
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(s)", atom_value_string));
-
-            return;
-        }
-        else
-        {
-            g_dbus_method_invocation_return_value(
-                invocation,
-                g_variant_new("(s)", "XCB_ATOM_CARDINAL type requested."));
 
-            return;
-        }
-    }
-    else
-    if (g_strcmp0(method_name, "query_view_credentials") == 0)
-    {
-        uint view_id;
-        pid_t pid = 0;
-        uid_t uid = 0;
-        gid_t gid = 0;
-        wayfire_view view;
+    if (!view) {
+#ifdef DBUS_PLUGIN_DEBUG
 
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
+        LOG(wf::log::LOG_LEVEL_DEBUG, "view_app_id_changed no view");
+#endif
 
-        if (!view) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(iuu)", 0, 0, 0));
+        return;
+    }
 
-            return;
-        }
+    view_string_forget(view->get_id(), VIEW_STRING_APP_ID);
+    dbus_view_index_update_app_id(view);
+    dbus_view_search_update(view);
+    emit_view_app_id_changed({view->get_id(),
+                              view_string(view, VIEW_STRING_APP_ID)});
+    app_groups_update(view);
+}
 
-        if (xwayland_enabled == 1) {
-            auto main_surface = view->get_main_surface()->get_wlr_surface();
-            if (!main_surface) {
-                g_dbus_method_invocation_return_value(invocation,
-                                                      g_variant_new("(iuu)", 0, 0, 0));
+/***
+ * The view's title has changed.
+ ***/
+void
+on_view_title_changed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_TITLE_CHANGED, view);
 
-                return;
-            }
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_title_changed");
+#endif
 
-            if (wlr_surface_is_xwayland_surface(main_surface)) {
-                struct wlr_xwayland_surface* main_xsurf;
-                xcb_res_client_id_spec_t spec = {0};
-                xcb_generic_error_t* err = NULL;
-                xcb_res_query_client_ids_cookie_t cookie;
-                xcb_res_query_client_ids_reply_t* reply;
-                int screen;
+    if (!view) {
+        return;
+    }
 
-                const char* xdisplay = core.get_xwayland_display().c_str();
-                xcb_connection_t* conn = xcb_connect(xdisplay, &screen);
+    view_string_forget(view->get_id(), VIEW_STRING_TITLE);
+    dbus_view_search_update(view);
+    emit_view_title_changed({view->get_id(),
+                             view_string(view, VIEW_STRING_TITLE)});
+}
 
-                main_xsurf = wlr_xwayland_surface_from_wlr_surface(main_surface);
-                spec.client = main_xsurf->window_id;
-                spec.mask = XCB_RES_CLIENT_ID_MASK_LOCAL_CLIENT_PID;
-                cookie = xcb_res_query_client_ids(conn, 1, &spec);
-                reply = xcb_res_query_client_ids_reply(conn, cookie, &err);
+/***
+ * The view's fullscreen status has changed.
+ ***/
+void
+on_view_fullscreen_changed (dbus_view_t* view, bool state)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_FULLSCREEN_CHANGED, view, state);
+    /* a request, the view is still in its old state */
+    dbus_view_store_update_state(view, DBUS_VIEW_FLAG_FULLSCREEN, state);
 
-                if (reply == NULL) {
 #ifdef DBUS_PLUGIN_DEBUG
-                    LOG(wf::log::LOG_LEVEL_DEBUG,
-                        "could not get pid from xserver, empty reply");
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_fullscreened");
 #endif
-                }
-                else
-                {
-                    xcb_res_client_id_value_iterator_t it;
-                    it = xcb_res_query_client_ids_ids_iterator(reply);
-                    for (; it.rem; xcb_res_client_id_value_next(&it))
-                    {
-                        spec = it.data->spec;
-                        if (spec.mask & XCB_RES_CLIENT_ID_MASK_LOCAL_CLIENT_PID) {
-                            pid = *xcb_res_client_id_value_value(it.data);
-                            break;
-                        }
-                    }
 
-                    free(reply);
-                }
+    if (!view) {
+        return;
+    }
 
-                xcb_disconnect(conn);
+    emit_view_fullscreen_changed({view->get_id(), state});
+    workspace_summary_update_fullscreen(view, state);
+}
 
-                if (pid != 0) {
-                    LOG(wf::log::LOG_LEVEL_DEBUG,
-                        "returning xwayland window credentials.");
-                    g_dbus_method_invocation_return_value(
-                        invocation, g_variant_new("(iuu)", pid, uid, gid));
+/***
+ * The view's geometry has changed.
+ ***/
+void
+on_view_geometry_changed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_GEOMETRY_CHANGED, view);
+    dbus_view_store_update_geometry(view);
+    /* crossing into another workspace */
+    workspace_summary_update_geometry(view);
 
-                    return;
-                }
-            }
-        }
+    if (!geometry_signal) {
+        return;
+    }
 
 #ifdef DBUS_PLUGIN_DEBUG
-        LOG(wf::log::LOG_LEVEL_DEBUG, "returning standard credentials.");
+
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_geometry_changed");
 #endif
-        wl_client_get_credentials(view->get_client(), &pid, &uid, &gid);
-        g_dbus_method_invocation_return_value(
-            invocation, g_variant_new("(iuu)", pid, uid, gid));
 
+    dbus_geometry_t geometry;
+
+    if (!view) {
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_above") == 0)
-    {
-        wayfire_view view;
-        uint view_id;
-        bool above;
 
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
-        above = false;
+    geometry = view->get_output_geometry();
+    emit_view_geometry_changed({view->get_id(), geometry.x, geometry.y,
+                                geometry.width, geometry.height});
+}
 
-        if (view) {
-            if (view->has_data("wm-actions-above")) {
-                above = true;
-            }
-        }
+/***
+ * The view's tiling status has changed.
+ ***/
+void
+on_view_tiled (dbus_view_t* view, uint32_t edges)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_TILED, view, edges);
+    /* the view is tiled by now, maximized with all edges */
+    dbus_view_store_update(view);
 
 #ifdef DBUS_PLUGIN_DEBUG
-        else
-        {
-            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_above no view");
-        }
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_tiled");
 #endif
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(b)", above));
 
+    if (!view) {
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_maximized") == 0)
-    {
-        wayfire_view view;
-        uint view_id;
-        bool response = false;
 
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
+    emit_view_tiling_changed({view->get_id(), edges});
+}
 
-        if (view) {
-            response = (view->tiled_edges == wf::TILED_EDGES_ALL);
-        }
+/***
+ * The view's output has changed.
+ ***/
+void
+on_view_output_moved (dbus_view_t* view, uint32_t old_output,
+                      uint32_t new_output)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_OUTPUT_MOVED, view, old_output,
+                           new_output);
+    dbus_view_store_update(view);
 
 #ifdef DBUS_PLUGIN_DEBUG
-        else
-        {
-            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_maximized no view");
-        }
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_output_moved");
 #endif
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(b)", response));
 
+    if (!view) {
         return;
     }
 
-    else
-    if (g_strcmp0(method_name, "query_view_active") == 0)
-    {
-        wayfire_view view;
-        uint view_id;
-        bool response = false;
-
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
+    emit_view_output_moved({view->get_id(), old_output, new_output});
+    workspace_summary_update(view);
+}
 
-        if (view) {
-            response = view->activated;
-        }
+/***
+ * The view's output is about to change.
+ ***/
+void
+on_view_output_move_requested (dbus_view_t* view, uint32_t old_output,
+                               uint32_t new_output)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_OUTPUT_MOVE_REQUESTED, view,
+                           old_output, new_output);
 
 #ifdef DBUS_PLUGIN_DEBUG
-        else
-        {
-            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_active no view");
-        }
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_output_move_requested");
 #endif
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(b)", response));
 
-        return;
+    if (view) {
+        emit_view_output_move_requested({view->get_id(), old_output,
+                                         new_output});
     }
+}
 
-    else
-    if (g_strcmp0(method_name, "query_view_minimized") == 0)
-    {
-        wayfire_view view;
-        uint view_id;
-        bool response = false;
-
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
-
-        if (view) {
-            response = view->minimized;
-        }
+/***
+ * The view's role has changed.
+ ***/
+void
+on_view_role_changed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_ROLE_CHANGED, view);
+    list_generation++;
+    dbus_view_store_update(view);
+    dbus_view_search_update(view);
 
 #ifdef DBUS_PLUGIN_DEBUG
-        else
-        {
-            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_minimized no view");
-        }
+    LOG(wf::log::LOG_LEVEL_DEBUG, "role_changed");
+#endif
+
+    if (!view) {
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG, "role_changed no view");
 #endif
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(b)", response));
 
         return;
     }
 
-    else
-    if (g_strcmp0(method_name, "query_view_fullscreen") == 0)
-    {
-        uint view_id;
-        bool response = false;
-        wayfire_view view;
+    if (view->get_role() != DBUS_VIEW_ROLE_TOPLEVEL) {
+        dbus_focus_history_remove(view->get_id());
+    }
 
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
+    emit_view_role_changed({view->get_id(), (uint32_t)view->get_role()});
+    app_groups_update(view);
+    workspace_summary_update(view);
+}
 
-        if (view) {
-            response = view->fullscreen;
-        }
+/***
+ * The view's workspaces have changed.
+ ***/
+void
+on_view_workspaces_changed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_WORKSPACES_CHANGED, view);
+    dbus_view_store_update(view);
 
 #ifdef DBUS_PLUGIN_DEBUG
-        else
-        {
-            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_fullscreen no view");
-        }
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_workspaces_changed");
 #endif
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(b)", response));
 
+    if (!view) {
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_output") == 0)
-    {
-        uint view_id;
-        uint output_id = 0;
-        wayfire_view view;
 
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
+    emit_view_workspaces_changed({view->get_id()});
+    workspace_summary_update(view);
+}
 
-        if (view) {
-            if (view->get_output()) {
-                output_id = view->get_output()->get_id();
-            }
+/***
+ * The view's maximized status has changed.
+ ***/
+void
+on_view_maximized (dbus_view_t* view, bool state)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_MAXIMIZED, view, state);
+    /* a request, the view is still in its old state */
+    dbus_view_store_update_state(view, DBUS_VIEW_FLAG_MAXIMIZED, state);
 
 #ifdef DBUS_PLUGIN_DEBUG
-
-            else
-            {
-                g_warning("No output for view.");
-            }
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_maximized");
 #endif
-        }
-
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(u)", output_id));
 
+    if (!view) {
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_workspaces") == 0)
-    {
-#ifdef DBUS_PLUGIN_DEBUG
-        LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_workspaces ");
-#endif
 
-        uint view_id;
-        double area;
-        GVariantBuilder builder;
-        GVariant* value;
-        wf::geometry_t workspace_relative_geometry;
-        wlr_box view_relative_geometry;
-        wf::geometry_t intersection;
-        wf::dimensions_t workspaces;
-        wf::output_t* output;
+    emit_view_maximized_changed({view->get_id(), state});
+}
 
-        g_variant_get(parameters, "(u)", &view_id);
-        wayfire_view view = get_view_from_view_id(view_id);
+/***
+ * The view's minimized status has changed.
+ ***/
+void
+on_view_minimized (dbus_view_t* view, bool state)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_MINIMIZED, view, state);
+    /* a request, the view is still in its old state */
+    dbus_view_store_update_state(view, DBUS_VIEW_FLAG_MINIMIZED, state);
 
-        if (!check_view_toplevel(view)) {
 #ifdef DBUS_PLUGIN_DEBUG
-
-            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_workspaces no view");
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_minimized");
 #endif
-            g_dbus_method_invocation_return_value(invocation, NULL);
 
-            return;
-        }
-
-        workspaces = core.get_active_output()->workspace->get_workspace_grid_size();
-
-        view_relative_geometry = view->get_bounding_box();
-        output = view->get_output();
+    if (!view) {
+        return;
+    }
 
-        g_variant_builder_init(&builder, G_VARIANT_TYPE("a(ii)"));
+    emit_view_minimized_changed({view->get_id(), state});
+    app_groups_update_minimized(view, state);
+    workspace_summary_update_minimized(view, state);
+}
 
-        for (int horizontal_workspace = 0; horizontal_workspace < workspaces.width;
-             horizontal_workspace++)
-        {
-            for (int vertical_workspace = 0; vertical_workspace < workspaces.height;
-                 vertical_workspace++)
-            {
-                wf::point_t ws = {horizontal_workspace, vertical_workspace};
-                if (output->workspace->view_visible_on(view, ws)) {
-                    workspace_relative_geometry = output->render->get_ws_box(ws);
-                    intersection = wf::geometry_intersection(view_relative_geometry,
-                                                             workspace_relative_geometry);
-                    area = 1.0 * intersection.width * intersection.height;
-                    area /= 1.0 * view_relative_geometry.width *
-                        view_relative_geometry.height;
-
-                    if (area > 0.1) {
-                        g_variant_builder_add(&builder, "(ii)", horizontal_workspace,
-                                              vertical_workspace);
-                    }
-                }
-            }
-        }
+/***
+ * The view's focus has changed.
+ ***/
+void
+on_view_focus_changed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_FOCUS_CHANGED, view);
+    dbus_view_store_set_activated(view);
 
-        value = g_variant_new("(a(ii))", &builder);
-        g_dbus_method_invocation_return_value(invocation, value);
+    uint view_id;
 
+    if (!view) {
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_group_leader") == 0)
-    {
-        uint view_id;
-        uint group_leader_view_id;
-        wayfire_view view;
 
-        g_variant_get(parameters, "(u)", &view_id);
-        group_leader_view_id = view_id;
-        view = get_view_from_view_id(view_id);
+    view_id = view->get_id();
 
-        if (view) {
-            while (view->parent)
-            {
-                view = view->parent;
-            }
+    if (view_id == focused_view_id) {
+#ifdef DBUS_PLUGIN_DEBUG
+        LOG(wf::log::LOG_LEVEL_DEBUG,
+            "output_view_focus_changed old focus view");
+#endif
 
-            group_leader_view_id = view->get_id();
+        return;
+    }
+
+    if (view->get_role() != DBUS_VIEW_ROLE_TOPLEVEL) {
 #ifdef DBUS_PLUGIN_DEBUG
-            LOG(wf::log::LOG_LEVEL_DEBUG, "query_view_group_leader found returning");
+        LOG(wf::log::LOG_LEVEL_DEBUG,
+            "output_view_focus_changed not a toplevel ");
 #endif
-        }
 
-        g_dbus_method_invocation_return_value(
-            invocation, g_variant_new("(u)", group_leader_view_id));
+        return;
+    }
 
+    if (!view->is_activated()) {
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_role") == 0)
-    {
-        uint view_id;
-        uint response = 0;
-        bool is_modal_dialog;
-        wayfire_view view;
 
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
+    if (view->demands_attention()) {
+        view->clear_attention();
+    }
 
-        if (view) {
-            if (view->is_mapped()) {
-                is_modal_dialog = view->has_data("gtk-shell-modal");
+    focused_view_id = view_id;
+    dbus_focus_history_push(view_id);
+    emit_view_focus_changed({view_id});
+    /* the attention was cleared */
+    app_groups_update(view);
+    workspace_summary_focus(view);
+}
 
-                if ((view->role == wf::VIEW_ROLE_TOPLEVEL) && !is_modal_dialog) {
-                    response = 1;
-                }
+/***
+ * The view hints have changed
+ * The currently ownly interesting hint
+ * is view-demands-attention
+ ***/
+void
+on_view_hints_changed (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_HINTS_CHANGED, view);
+    dbus_view_store_update(view);
 
-                else
-                if (view->role == wf::VIEW_ROLE_DESKTOP_ENVIRONMENT)
-                {
-                    response = 2;
-                }
+    bool view_wants_attention = false;
 
-                else
-                if (view->role == wf::VIEW_ROLE_UNMANAGED)
-                {
-                    response = 3;
-                }
-            }
-        }
+    if (!view) {
+#ifdef DBUS_PLUGIN_DEBUG
 
-        g_dbus_method_invocation_return_value(invocation,
-                                              g_variant_new("(u)", response));
+        LOG(wf::log::LOG_LEVEL_DEBUG, "view_hints_changed no view");
+#endif
 
         return;
     }
-    else
-    if (g_strcmp0(method_name, "query_view_test_data") == 0)
-    {
-        uint view_id;
-        wayfire_view view;
-
-        g_variant_get(parameters, "(u)", &view_id);
-        view = get_view_from_view_id(view_id);
 
-        if (!check_view_toplevel(view))
-        {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(uu)", 0, 0));
+#ifdef DBUS_PLUGIN_DEBUG
 
-            return;
-        }
+    LOG(wf::log::LOG_LEVEL_DEBUG, "view_hints_changed",
+        view->demands_attention());
+#endif
+    if (view->demands_attention()) {
+        view_wants_attention = true;
+    }
 
-        auto wlr_surf = view->get_wlr_surface();
-        if (!wlr_surf) {
-            g_dbus_method_invocation_return_value(invocation,
-                                                  g_variant_new("(uu)", 0, 0));
+    emit_view_attention_changed({view->get_id(), view_wants_attention});
+    app_groups_update(view);
+    workspace_summary_update(view);
+}
 
-            return;
-        }
+/***
+ * The view may or may not be moving now.
+ * The status of that has somehow changed.
+ * https://github.com/WayfireWM/wayfire/issues/639
+ ***/
+void
+on_view_moving (dbus_view_t* view)
+{
+    dbus_event_record_view(DBUS_EVENT_VIEW_MOVING, view);
 
-        if (wlr_surface_is_xwayland_surface(wlr_surf)) {
-            struct wlr_xwayland_surface* xsurf;
-            xsurf = wlr_xwayland_surface_from_wlr_surface(wlr_surf);
-            g_dbus_method_invocation_return_value(
-                invocation, g_variant_new("(uu)", xsurf->width, xsurf->height));
-        }
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_moving");
+#endif
 
+    if (!view) {
         return;
     }
 
-    /*************** Other Actions ****************/
-    else
-    if (g_strcmp0(method_name, "inhibit_output_start") == 0)
-    {
-        g_variant_unref(parameters);
-    }
-    else
-    if (g_strcmp0(method_name, "inhibit_output_stop") == 0)
-    {
-        g_variant_unref(parameters);
-    }
-    else
-    if (g_strcmp0(method_name, "trigger_show_desktop") == 0)
-    {
-        g_variant_unref(parameters);
-    }
-    else
-    if (g_strcmp0(method_name, "trigger_show_overview") == 0)
-    {
-        g_variant_unref(parameters);
-    }
+    emit_view_moving_changed({view->get_id()});
 }
 
-static GVariant*
-handle_get_property (GDBusConnection* connection,
-                     const gchar* sender,
-                     const gchar* object_path,
-                     const gchar* interface_name,
-                     const gchar* property_name, GError** error,
-                     gpointer user_data)
+/***
+ * The view may or may not be resizing now.
+ * The status of that has somehow changed.
+ * https://github.com/WayfireWM/wayfire/issues/639
+ ***/
+void
+on_view_resizing (dbus_view_t* view)
 {
-    // returning nullptr would crash compositor
-    GVariant* ret = g_variant_new_string("nullptr");
+    dbus_event_record_view(DBUS_EVENT_VIEW_RESIZING, view);
 
-    // kept as an example
-    // if (g_strcmp0(property_name, "view_vector_ids") == 0)
-    // {
-    // std::vector<nonstd::observer_ptr<wf::view_interface_t>> view_vector =
-    // core.get_all_views();
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_view_resizing");
+#endif
 
-    // GVariantBuilder builder;
-    // g_variant_builder_init(&builder, G_VARIANT_TYPE("au"));
-    // for (auto it = begin(view_vector); it != end(view_vector); ++it)
-    // g_variant_builder_add(&builder, "u", it->get()->get_id());
-    // ret = g_variant_builder_end(&builder);
-    // }
+    if (!view) {
+        return;
+    }
 
-    /* unused */
-    return ret;
+    emit_view_resizing_changed({view->get_id()});
 }
 
-static gboolean
-handle_set_property (GDBusConnection* connection,
-                     const gchar* sender,
-                     const gchar* object_path,
-                     const gchar* interface_name,
-                     const gchar* property_name, GVariant* value,
-                     GError** error, gpointer user_data)
+/***
+ * The wm-actions plugin changed the above_layer
+ * state of a view.
+ ***/
+void
+on_view_keep_above (dbus_view_t* view)
 {
-    /* unused */
-    return false;
-}
+    dbus_event_record_view(DBUS_EVENT_VIEW_KEEP_ABOVE, view);
+    dbus_view_store_update(view);
 
-static const GDBusInterfaceVTable interface_vtable = {
-    handle_method_call, handle_get_property, handle_set_property, {0}
-};
+    if (!view) {
+        return;
+    }
 
-static gboolean
-bus_emit_signal (gchar* signal_name, GVariant* signal_data)
-{
-    GError* local_error = NULL;
-    if (!dbus_connection) {
-        if (signal_data != nullptr) {
-            g_variant_unref(signal_data);
-        }
+    emit_view_keep_above_changed({view->get_id(), view->is_above()});
+}
 
-        return true;
-    }
+/***
+ * The view became a transient of another view or stopped being one,
+ * its group leader and that of its own transients may have changed.
+ ***/
+void
+on_view_parent_changed (dbus_view_t* view)
+{
+    std::vector<uint32_t> ids;
+    uint32_t leader_id;
 
-    g_dbus_connection_emit_signal(
-        dbus_connection, nullptr, "/org/wayland/compositor",
-        "org.wayland.compositor", signal_name, signal_data, &local_error);
-    g_assert_no_error(local_error);
+    dbus_event_record_view(DBUS_EVENT_VIEW_PARENT_CHANGED, view,
+                           (view && view->get_parent()) ?
+                           view->get_parent()->get_id() : 0);
 
-    if (signal_data != nullptr) {
-        g_variant_unref(signal_data);
+    if (!view) {
+        return;
     }
 
-    return true;
+    dbus_view_group_update(view);
+    leader_id = dbus_view_group_leader(view->get_id());
+    ids.push_back(view->get_id());
+    dbus_view_group_transients(view->get_id(), &ids);
+    for (uint32_t view_id : ids)
+    {
+        emit_view_group_leader_changed({view_id, leader_id});
+    }
 }
 
-static void
-on_bus_acquired (GDBusConnection* connection, const gchar* name,
-                 gpointer user_data)
+/******************************Output Related Hooks***************************/
+/***
+ * If the output configuration is changed somehow,
+ * scaling / resolution etc changes, this is emitted
+ ***/
+void
+on_output_configuration_changed (dbus_output_t* output)
 {
-    uint registration_id;
+    dbus_event_record_output(DBUS_EVENT_OUTPUT_CONFIGURATION_CHANGED, output);
+    dbus_output_registry_update(output);
 
-    dbus_connection = connection;
-    registration_id = g_dbus_connection_register_object(
-        connection, "/org/wayland/compositor", introspection_data->interfaces[0],
-        &interface_vtable, nullptr, nullptr, nullptr);
 #ifdef DBUS_PLUGIN_DEBUG
-    LOG(wf::log::LOG_LEVEL_DEBUG, "Acquired the Bus");
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_configuration_changed");
 #endif
+
+    emit_output_configuration_changed({});
 }
 
-static void
-on_name_acquired (GDBusConnection* connection, const gchar* name,
-                  gpointer user_data)
+/***
+ * The workspace of an output changed
+ ***/
+void
+on_output_workspace_changed (dbus_output_t* output, int x, int y)
 {
+    dbus_event_record_output(DBUS_EVENT_OUTPUT_WORKSPACE_CHANGED, output, x, y);
+    dbus_view_store_update_output(output);
+    dbus_output_registry_update(output);
+
 #ifdef DBUS_PLUGIN_DEBUG
-    LOG(wf::log::LOG_LEVEL_DEBUG,
-        "Acquired the name " + std::string(name) + "on the session bus\n");
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_workspace_changed");
 #endif
+
+    emit_output_workspace_changed({output->get_id(), x, y});
 }
 
-static void
-on_name_lost (GDBusConnection* connection, const gchar* name,
-              gpointer user_data)
+/***
+ * A new output has been added
+ ***/
+void
+on_output_added (dbus_output_t* output)
 {
+    dbus_event_record_output(DBUS_EVENT_OUTPUT_ADDED, output);
+    dbus_output_registry_update(output);
+    dbus_workspace_summary_add_output(output->get_id());
+    list_generation++;
+
 #ifdef DBUS_PLUGIN_DEBUG
-    LOG(wf::log::LOG_LEVEL_DEBUG,
-        "Lost the name " + std::string(name) + "on the session bus");
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_layout_output_added");
 #endif
+
+    emit_output_added({output->get_id()});
 }
 
-static void
-acquire_bus ()
+/***
+ * An output has been removed
+ ***/
+void
+on_output_removed (dbus_output_t* output)
 {
-    GBusNameOwnerFlags flags;
-// flags = G_BUS_NAME_OWNER_FLAGS_DO_NOT_QUEUE;
-    introspection_data = g_dbus_node_info_new_for_xml(introspection_xml, nullptr);
+    dbus_event_record_output(DBUS_EVENT_OUTPUT_REMOVED, output);
+    dbus_output_registry_remove(output->get_id());
+    dbus_workspace_summary_remove_output(output->get_id());
+    list_generation++;
 
-    owner_id = g_bus_own_name(G_BUS_TYPE_SESSION, "org.wayland.compositor", flags,
-                              on_bus_acquired, on_name_acquired, on_name_lost,
-                              nullptr, nullptr);
+#ifdef DBUS_PLUGIN_DEBUG
+    LOG(wf::log::LOG_LEVEL_DEBUG, "output_layout_output_removed");
+#endif
+
+    emit_output_removed({output->get_id()});
 }
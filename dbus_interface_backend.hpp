@@ -0,0 +1,82 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ * Copyright (C) 2019 - 2020 Damian Ivanov <damianatorrpm@gmail.com>
+ *
+ * dbus_interface_backend.hpp -- compositor agnostic part of the
+ * plugin: the bus object, the method dispatcher and the signal
+ * emitters the plugin's hooks forward to. It only sees the core
+ * through dbus_core_t.
+ ********************************************************************/
+
+#ifndef DBUS_INTERFACE_BACKEND_HPP
+#define DBUS_INTERFACE_BACKEND_HPP
+
+#include <gio/gio.h>
+#include "dbus_core.hpp"
+
+extern const gchar introspection_xml [];
+extern GDBusNodeInfo* introspection_data;
+extern GDBusConnection* dbus_connection;
+
+extern uint focused_view_id;
+extern bool find_view_under_action;
+extern gboolean geometry_signal;
+
+/***
+ * The GDBusInterfaceVTable entry point.
+ * A nullptr invocation is accepted for in-process callers,
+ * the reply then goes to method_reply_sink (or is dropped).
+ ***/
+void handle_method_call (GDBusConnection* connection, const gchar* sender,
+                         const gchar* object_path,
+                         const gchar* interface_name,
+                         const gchar* method_name, GVariant* parameters,
+                         GDBusMethodInvocation* invocation,
+                         gpointer user_data);
+extern void (*method_reply_sink)(GVariant* reply);
+
+/***
+ * Sees every signal before it is sent (or dropped without a
+ * connection), for in-process callers counting the traffic.
+ * signal_data may be nullptr and is only borrowed.
+ ***/
+extern void (*signal_sink)(const gchar* signal_name, GVariant* signal_data);
+
+gboolean bus_emit_signal (const gchar* signal_name, GVariant* signal_data);
+void acquire_bus ();
+void release_bus ();
+
+/************************* Hooks ************************/
+void on_pointer_button (dbus_point_t cursor_position, uint32_t button,
+                        bool button_released, dbus_view_t* view_under_cursor);
+void on_tablet_button ();
+
+void on_view_added (dbus_view_t* view);
+void on_view_timeout (dbus_view_t* view);
+void on_view_closed (dbus_view_t* view);
+void on_view_app_id_changed (dbus_view_t* view);
+void on_view_title_changed (dbus_view_t* view);
+void on_view_fullscreen_changed (dbus_view_t* view, bool state);
+void on_view_geometry_changed (dbus_view_t* view);
+void on_view_tiled (dbus_view_t* view, uint32_t edges);
+void on_view_output_moved (dbus_view_t* view, uint32_t old_output,
+                           uint32_t new_output);
+void on_view_output_move_requested (dbus_view_t* view, uint32_t old_output,
+                                    uint32_t new_output);
+void on_view_role_changed (dbus_view_t* view);
+void on_view_workspaces_changed (dbus_view_t* view);
+void on_view_maximized (dbus_view_t* view, bool state);
+void on_view_minimized (dbus_view_t* view, bool state);
+void on_view_focus_changed (dbus_view_t* view);
+void on_view_hints_changed (dbus_view_t* view);
+void on_view_moving (dbus_view_t* view);
+void on_view_resizing (dbus_view_t* view);
+void on_view_keep_above (dbus_view_t* view);
+void on_view_parent_changed (dbus_view_t* view);
+
+void on_output_configuration_changed (dbus_output_t* output);
+void on_output_workspace_changed (dbus_output_t* output, int x, int y);
+void on_output_added (dbus_output_t* output);
+void on_output_removed (dbus_output_t* output);
+
+#endif
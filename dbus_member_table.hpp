@@ -0,0 +1,215 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_member_table.hpp -- the part the aggregates over views (app
+ * groups, workspace summaries) share. Each member view remembers
+ * what it added to the aggregate under its key, a change takes that
+ * back out and adds the new state, then the keys whose state differs
+ * from before are reported.
+ ********************************************************************/
+
+#ifndef DBUS_MEMBER_TABLE_HPP
+#define DBUS_MEMBER_TABLE_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+/***
+ * aggregate_t holds the counts, the table calls it through:
+ *   key_t, member_t, state_t: a member's key, what it remembers,
+ *     what is compared and reported for a key (state_t() for a key
+ *     without members)
+ *   key (member), state (key), states (&by_key), same (a, b)
+ *   count (member, step): adds step to the counts, 1 or -1
+ *   clear (): drops the counts for a rebuild
+ *   is_member (view), member (view)
+ ***/
+template<class aggregate_t>
+class dbus_member_table_t
+{
+  public:
+    typedef typename aggregate_t::key_t key_t;
+    typedef typename aggregate_t::member_t member_t;
+    typedef typename aggregate_t::state_t state_t;
+    /* a view id and its new state, nullptr if it leaves */
+    typedef std::pair<uint32_t, const member_t*> change_t;
+
+    const member_t*
+    find (uint32_t view_id)
+    {
+        typename std::unordered_map<uint32_t, member_t>::iterator member;
+
+        member = members.find(view_id);
+
+        return (member != members.end()) ? &member->second : nullptr;
+    }
+
+    /***
+     * The keys involved are compared once all the changes are in,
+     * a key the changes leave as it was isn't reported.
+     ***/
+    void
+    set (std::initializer_list<change_t> changes, std::vector<key_t>* changed)
+    {
+        typename std::unordered_map<uint32_t, member_t>::iterator old;
+        std::vector<std::pair<key_t, state_t>> before;
+
+        for (const change_t& change : changes)
+        {
+            old = members.find(change.first);
+            if (old != members.end()) {
+                remember(aggregate_t::key(old->second), &before);
+            }
+
+            if (change.second) {
+                remember(aggregate_t::key(*change.second), &before);
+            }
+        }
+
+        for (const change_t& change : changes)
+        {
+            old = members.find(change.first);
+            if (old != members.end()) {
+                /* wraps around to a decrement */
+                aggregate_t::count(old->second, (uint32_t)-1);
+                members.erase(old);
+            }
+
+            if (change.second) {
+                aggregate_t::count(*change.second, 1);
+                members[change.first] = *change.second;
+            }
+        }
+
+        for (const std::pair<key_t, state_t>& key : before)
+        {
+            if (changed && !aggregate_t::same(key.second,
+                                              aggregate_t::state(key.first))) {
+                changed->push_back(key.first);
+            }
+        }
+    }
+
+    /***
+     * The view's state from aggregate_t::member, passed through
+     * adjust (member_t*) for what the hook knows ahead of the view.
+     ***/
+    template<class adjust_t>
+    void
+    update (dbus_view_t* view, adjust_t adjust, std::vector<key_t>* changed)
+    {
+        member_t member;
+
+        ensure(changed);
+        if (!view) {
+            return;
+        }
+
+        if (!aggregate_t::is_member(view)) {
+            set({{view->get_id(), nullptr}}, changed);
+
+            return;
+        }
+
+        member = aggregate_t::member(view);
+        adjust(&member);
+        set({{view->get_id(), &member}}, changed);
+    }
+
+    void
+    update (dbus_view_t* view, std::vector<key_t>* changed)
+    {
+        update(view, [] (member_t*) {}, changed);
+    }
+
+    void
+    remove (uint32_t view_id, std::vector<key_t>* changed)
+    {
+        ensure(changed);
+        set({{view_id, nullptr}}, changed);
+    }
+
+    void
+    ensure (std::vector<key_t>* changed)
+    {
+        if (!valid && dbus_core) {
+            rebuild(changed);
+        }
+    }
+
+    void
+    invalidate ()
+    {
+        valid = false;
+    }
+
+  private:
+    std::unordered_map<uint32_t, member_t> members;
+    bool valid = false;
+    /* the first build has nothing to compare with */
+    bool built = false;
+
+    static void
+    remember (const key_t& key, std::vector<std::pair<key_t, state_t>>* before)
+    {
+        for (const std::pair<key_t, state_t>& seen : *before)
+        {
+            if (seen.first == key) {
+                return;
+            }
+        }
+
+        before->emplace_back(key, aggregate_t::state(key));
+    }
+
+    void
+    rebuild (std::vector<key_t>* changed)
+    {
+        std::unordered_map<key_t, state_t> previous;
+        std::unordered_map<key_t, state_t> current;
+        member_t member;
+
+        aggregate_t::states(&previous);
+        aggregate_t::clear();
+        members.clear();
+        for (dbus_view_t* view : dbus_core->get_all_views())
+        {
+            if (!aggregate_t::is_member(view)) {
+                continue;
+            }
+
+            member = aggregate_t::member(view);
+            aggregate_t::count(member, 1);
+            members[view->get_id()] = member;
+        }
+
+        if (changed && built) {
+            for (const std::pair<const key_t, state_t>& key : previous)
+            {
+                if (!aggregate_t::same(key.second,
+                                       aggregate_t::state(key.first))) {
+                    changed->push_back(key.first);
+                }
+            }
+
+            aggregate_t::states(&current);
+            for (const std::pair<const key_t, state_t>& key : current)
+            {
+                if ((previous.find(key.first) == previous.end()) &&
+                    !aggregate_t::same(state_t(), key.second)) {
+                    changed->push_back(key.first);
+                }
+            }
+        }
+
+        valid = true;
+        built = true;
+    }
+};
+
+#endif
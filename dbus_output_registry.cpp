@@ -0,0 +1,178 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_output_registry.cpp -- the records in the core's order,
+ * with an id -> position map for the lookups.
+ ********************************************************************/
+
+#include <unordered_map>
+
+#include "dbus_output_registry.hpp"
+
+static std::vector<dbus_output_record_t> records;
+static std::unordered_map<uint32_t, size_t> positions;
+static bool registry_valid = false;
+
+static std::string
+nonull (const char* value)
+{
+    return value ? value : "";
+}
+
+static void
+add_string (GVariantBuilder* builder, const char* key,
+            const std::string& value)
+{
+    if (!value.empty()) {
+        g_variant_builder_add(builder, "{sv}", key,
+                              g_variant_new_string(value.c_str()));
+    }
+}
+
+static void
+add_int (GVariantBuilder* builder, const char* key, int value)
+{
+    g_variant_builder_add(builder, "{sv}", key, g_variant_new_int32(value));
+}
+
+static void
+record_read (dbus_output_record_t* record, dbus_output_t* output)
+{
+    dbus_geometry_t geometry = output->get_layout_geometry();
+    dbus_workspace_t grid    = output->get_workspace_grid_size();
+    dbus_workspace_t workspace = output->get_workspace();
+    GVariantBuilder builder;
+
+    record->output = output;
+    record->name   = output->get_name();
+    record->make   = nonull(output->get_make());
+    record->model  = nonull(output->get_model());
+    record->serial = nonull(output->get_serial());
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    add_string(&builder, "name", record->name);
+    add_string(&builder, "make", record->make);
+    add_string(&builder, "model", record->model);
+    add_string(&builder, "serial", record->serial);
+    add_int(&builder, "x", geometry.x);
+    add_int(&builder, "y", geometry.y);
+    add_int(&builder, "width", geometry.width);
+    add_int(&builder, "height", geometry.height);
+    g_variant_builder_add(&builder, "{sv}", "scale",
+                          g_variant_new_double(output->get_scale()));
+    g_variant_builder_add(&builder, "{sv}", "transform",
+                          g_variant_new_uint32(output->get_transform()));
+    add_int(&builder, "grid_width", grid.x);
+    add_int(&builder, "grid_height", grid.y);
+    add_int(&builder, "workspace_x", workspace.x);
+    add_int(&builder, "workspace_y", workspace.y);
+
+    if (record->entry) {
+        g_variant_unref(record->entry);
+    }
+
+    record->entry = g_variant_ref_sink(g_variant_builder_end(&builder));
+}
+
+static void
+registry_clear ()
+{
+    for (dbus_output_record_t& record : records)
+    {
+        g_variant_unref(record.entry);
+    }
+
+    records.clear();
+    positions.clear();
+}
+
+static void
+registry_rebuild ()
+{
+    registry_clear();
+    for (dbus_output_t* output : dbus_core->get_outputs())
+    {
+        positions[output->get_id()] = records.size();
+        records.push_back({});
+        record_read(&records.back(), output);
+    }
+
+    registry_valid = true;
+}
+
+static void
+registry_ensure ()
+{
+    if (!registry_valid && dbus_core) {
+        registry_rebuild();
+    }
+}
+
+void
+dbus_output_registry_update (dbus_output_t* output)
+{
+    std::unordered_map<uint32_t, size_t>::iterator position;
+
+    if (!registry_valid || !output) {
+        return;
+    }
+
+    position = positions.find(output->get_id());
+    if (position == positions.end()) {
+        positions[output->get_id()] = records.size();
+        records.push_back({});
+        record_read(&records.back(), output);
+
+        return;
+    }
+
+    record_read(&records[position->second], output);
+}
+
+void
+dbus_output_registry_remove (uint32_t output_id)
+{
+    std::unordered_map<uint32_t, size_t>::iterator position;
+
+    if (!registry_valid) {
+        return;
+    }
+
+    position = positions.find(output_id);
+    if (position == positions.end()) {
+        return;
+    }
+
+    g_variant_unref(records[position->second].entry);
+    records.erase(records.begin() + position->second);
+    positions.clear();
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        positions[records[i].output->get_id()] = i;
+    }
+}
+
+void
+dbus_output_registry_invalidate ()
+{
+    registry_valid = false;
+}
+
+dbus_output_record_t*
+dbus_output_registry_find (uint32_t output_id)
+{
+    std::unordered_map<uint32_t, size_t>::iterator position;
+
+    registry_ensure();
+    position = positions.find(output_id);
+
+    return (position != positions.end()) ? &records[position->second] : nullptr;
+}
+
+const std::vector<dbus_output_record_t>&
+dbus_output_registry_get ()
+{
+    registry_ensure();
+
+    return records;
+}
@@ -0,0 +1,55 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_output_registry.hpp -- the outputs by id, each with its
+ * metadata read once and its query_outputs entry built once.
+ * Refreshed by the output hooks (added, removed, configuration and
+ * workspace changes), so looking up an output or listing all of
+ * them doesn't ask the compositor.
+ ********************************************************************/
+
+#ifndef DBUS_OUTPUT_REGISTRY_HPP
+#define DBUS_OUTPUT_REGISTRY_HPP
+
+#include <gio/gio.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+struct dbus_output_record_t
+{
+    dbus_output_t* output;
+    std::string name;
+    /* empty if the backend doesn't provide them */
+    std::string make;
+    std::string model;
+    std::string serial;
+    /***
+     * a{sv}: name, make, model, serial (if known), x, y, width,
+     * height, scale, transform, grid_width, grid_height,
+     * workspace_x, workspace_y. Owned by the record.
+     ***/
+    GVariant* entry;
+};
+
+/***
+ * Reads the output again, adds it if it is new.
+ ***/
+void dbus_output_registry_update (dbus_output_t* output);
+void dbus_output_registry_remove (uint32_t output_id);
+
+/***
+ * The registry is rebuilt from dbus_core on the next lookup,
+ * for changes no hook reports.
+ ***/
+void dbus_output_registry_invalidate ();
+
+/* nullptr if there is no such output */
+dbus_output_record_t* dbus_output_registry_find (uint32_t output_id);
+
+/* in the core's order */
+const std::vector<dbus_output_record_t>& dbus_output_registry_get ();
+
+#endif
@@ -0,0 +1,208 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_query_pool.cpp -- a GThreadPool of jobs, each query with a
+ * timeout source on the main context. The worker and the timeout
+ * race for the answered flag, the winner replies, the job goes once
+ * both have let go of it. A task is a job without either, on a pool
+ * of its own.
+ ********************************************************************/
+
+#include "dbus_query_pool.hpp"
+
+struct query_job_t
+{
+    /* nullptr, and no timeout, for a task */
+    GDBusMethodInvocation* invocation;
+    dbus_query_work_t work;
+    GSource* timeout;
+    gint64 pushed;
+    /* set by whoever replies */
+    gint answered;
+    /* the worker's and the timeout's */
+    gint refs;
+};
+
+static GThreadPool* pool = nullptr;
+/* the tasks' own, one at a time, so they can't hold up the queries */
+static GThreadPool* task_pool = nullptr;
+/* queued or running */
+static gint tasks = 0;
+/* the queued jobs are failed instead of run */
+static gint stopping = 0;
+static GMutex stats_lock;
+static dbus_query_pool_stats_t stats;
+
+static void
+job_unref (gpointer data)
+{
+    query_job_t* job = (query_job_t*)data;
+
+    if (g_atomic_int_dec_and_test(&job->refs)) {
+        if (job->timeout) {
+            g_source_unref(job->timeout);
+        }
+
+        delete job;
+    }
+}
+
+static gboolean
+job_timed_out (gpointer data)
+{
+    query_job_t* job = (query_job_t*)data;
+
+    if (g_atomic_int_compare_and_exchange(&job->answered, 0, 1)) {
+        g_dbus_method_invocation_return_error_literal(
+            job->invocation, G_DBUS_ERROR, G_DBUS_ERROR_TIMEOUT,
+            "The query timed out.");
+
+        g_mutex_lock(&stats_lock);
+        stats.timed_out++;
+        g_mutex_unlock(&stats_lock);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+job_run (gpointer data, gpointer user_data)
+{
+    query_job_t* job = (query_job_t*)data;
+    uint64_t queue_time = g_get_monotonic_time() - job->pushed;
+    GVariant* reply     = nullptr;
+    bool replied;
+
+    g_mutex_lock(&stats_lock);
+    stats.pending--;
+    stats.started++;
+    stats.queue_time_total += queue_time;
+    stats.queue_time_max    = MAX(stats.queue_time_max, queue_time);
+    g_mutex_unlock(&stats_lock);
+
+    if (!g_atomic_int_get(&job->answered) && !g_atomic_int_get(&stopping)) {
+        reply = job->work();
+    }
+
+    replied = g_atomic_int_compare_and_exchange(&job->answered, 0, 1);
+    if (replied && job->invocation && g_atomic_int_get(&stopping) && !reply) {
+        g_dbus_method_invocation_return_error_literal(
+            job->invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED,
+            "The plugin is unloading.");
+    }
+    else
+    if (replied && job->invocation)
+    {
+        g_dbus_method_invocation_return_value(job->invocation, reply);
+    }
+    else
+    if (reply)
+    {
+        /* too late, the caller has the timeout error */
+        g_variant_unref(g_variant_ref_sink(reply));
+    }
+
+    g_mutex_lock(&stats_lock);
+    stats.completed += replied ? 1 : 0;
+    g_mutex_unlock(&stats_lock);
+
+    /* drops the timeout's reference unless it has fired already */
+    if (job->timeout) {
+        g_source_destroy(job->timeout);
+    }
+
+    if (!job->invocation) {
+        g_atomic_int_add(&tasks, -1);
+    }
+
+    job_unref(job);
+}
+
+static void
+job_push (GThreadPool** to, gint threads, query_job_t* job)
+{
+    if (!*to) {
+        *to = g_thread_pool_new(job_run, nullptr, threads, FALSE, nullptr);
+    }
+
+    g_mutex_lock(&stats_lock);
+    stats.pending++;
+    g_mutex_unlock(&stats_lock);
+
+    g_thread_pool_push(*to, job, nullptr);
+}
+
+void
+dbus_query_pool_push (GDBusMethodInvocation* invocation,
+                      dbus_query_work_t work, guint timeout_ms)
+{
+    query_job_t* job;
+
+    job = new query_job_t();
+    job->invocation = invocation;
+    job->work     = std::move(work);
+    job->pushed   = g_get_monotonic_time();
+    job->answered = 0;
+    job->refs     = 2;
+    job->timeout  = g_timeout_source_new(timeout_ms);
+    g_source_set_callback(job->timeout, job_timed_out, job, job_unref);
+    g_source_attach(job->timeout, g_main_context_get_thread_default());
+    job_push(&pool, DBUS_QUERY_POOL_THREADS, job);
+}
+
+void
+dbus_query_pool_run (dbus_query_task_t task)
+{
+    query_job_t* job;
+
+    job = new query_job_t();
+    job->invocation = nullptr;
+    job->work     = [task] () -> GVariant*
+    {
+        task();
+
+        return nullptr;
+    };
+    job->pushed   = g_get_monotonic_time();
+    job->answered = 0;
+    job->refs     = 1;
+    job->timeout  = nullptr;
+    g_atomic_int_inc(&tasks);
+    job_push(&task_pool, 1, job);
+}
+
+bool
+dbus_query_pool_task_idle ()
+{
+    return g_atomic_int_get(&tasks) == 0;
+}
+
+dbus_query_pool_stats_t
+dbus_query_pool_get_stats ()
+{
+    dbus_query_pool_stats_t copy;
+
+    g_mutex_lock(&stats_lock);
+    copy = stats;
+    g_mutex_unlock(&stats_lock);
+
+    return copy;
+}
+
+void
+dbus_query_pool_shutdown ()
+{
+    g_atomic_int_set(&stopping, 1);
+    /* only the running jobs take time, bounded by their X calls */
+    if (pool) {
+        g_thread_pool_free(pool, FALSE, TRUE);
+        pool = nullptr;
+    }
+
+    if (task_pool) {
+        g_thread_pool_free(task_pool, FALSE, TRUE);
+        task_pool = nullptr;
+    }
+
+    g_atomic_int_set(&stopping, 0);
+}
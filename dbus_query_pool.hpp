@@ -0,0 +1,66 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_query_pool.hpp -- a few worker threads for the queries that
+ * block on another process (the XCB round trips to XWayland). The
+ * handler captures what the query needs on the main thread, a worker
+ * does the blocking part and returns the reply to the caller itself,
+ * so a hung X client can't stall the compositor.
+ ********************************************************************/
+
+#ifndef DBUS_QUERY_POOL_HPP
+#define DBUS_QUERY_POOL_HPP
+
+#include <gio/gio.h>
+#include <cstdint>
+#include <functional>
+
+#define DBUS_QUERY_POOL_THREADS 2
+/* a query not answered by then gets G_DBUS_ERROR_TIMEOUT */
+#define DBUS_QUERY_TIMEOUT_MS 1000
+
+/***
+ * The blocking part of a query, run on a worker, so it must not
+ * touch dbus_core. Returns the reply.
+ ***/
+typedef std::function<GVariant*()> dbus_query_work_t;
+/* work nobody waits for, it reports its results itself */
+typedef std::function<void()> dbus_query_task_t;
+
+struct dbus_query_pool_stats_t
+{
+    /* pushed, no worker has started them yet */
+    uint32_t pending;
+    uint64_t started;
+    /* answered by the worker, and tasks done */
+    uint64_t completed;
+    uint64_t timed_out;
+    /* from the push to a worker starting it, in microseconds */
+    uint64_t queue_time_total;
+    uint64_t queue_time_max;
+};
+
+/***
+ * Takes over invocation, which is answered with the reply of work
+ * or the timeout error, whichever comes first. A query still
+ * queued when it times out doesn't run at all.
+ ***/
+void dbus_query_pool_push (GDBusMethodInvocation* invocation,
+                           dbus_query_work_t work, guint timeout_ms);
+/***
+ * No caller, no timeout. The tasks run one at a time on a worker
+ * of their own, a hung one holds up the next task but no query.
+ ***/
+void dbus_query_pool_run (dbus_query_task_t task);
+/* no task queued or running, for pushing one batch at a time */
+bool dbus_query_pool_task_idle ();
+
+dbus_query_pool_stats_t dbus_query_pool_get_stats ();
+
+/***
+ * For unloading: the queued queries are answered with an error and
+ * the queued tasks dropped, it only waits for the running ones.
+ ***/
+void dbus_query_pool_shutdown ();
+
+#endif
@@ -0,0 +1,133 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_signals.hpp -- the signals of org.wayland.compositor, as one
+ * table that generates their part of introspection_xml and a typed
+ * emitter per signal:
+ *
+ *   emit_view_geometry_changed({view_id, x, y, width, height});
+ *
+ * The arguments are a plain struct (view_geometry_changed_args_t),
+ * so a wrong count or a narrowing conversion doesn't compile. The
+ * body is put together from the typed g_variant_new_* constructors,
+ * no format string is parsed per event.
+ ********************************************************************/
+
+#ifndef DBUS_SIGNALS_HPP
+#define DBUS_SIGNALS_HPP
+
+#include <gio/gio.h>
+#include "dbus_interface_backend.hpp"
+
+/***
+ * SIGNAL(name, args) with args a list of ARG(type, name),
+ * type one of the D-Bus basic types below or vardict (a{sv}).
+ ***/
+#define DBUS_SIGNALS(SIGNAL, ARG) \
+    /* Core Input Signals */ \
+    SIGNAL(pointer_clicked, ARG(d, x_pos) ARG(d, y_pos) ARG(u, button) \
+           ARG(b, button_released)) \
+    SIGNAL(tablet_touched, ) \
+    /* View related signals, emitted from various sources */ \
+    SIGNAL(view_added, ARG(u, view_id)) \
+    SIGNAL(view_closed, ARG(u, view_id)) \
+    SIGNAL(view_timeout, ARG(u, view_id)) \
+    SIGNAL(view_app_id_changed, ARG(u, view_id) ARG(s, new_app_id)) \
+    SIGNAL(view_title_changed, ARG(u, view_id) ARG(s, new_title)) \
+    SIGNAL(view_output_move_requested, ARG(u, view_id) ARG(u, old_output) \
+           ARG(u, new_output)) \
+    SIGNAL(view_output_moved, ARG(u, view_id) ARG(u, old_output) \
+           ARG(u, new_output)) \
+    SIGNAL(view_workspaces_changed, ARG(u, view_id)) \
+    SIGNAL(view_attention_changed, ARG(u, view_id) ARG(b, attention)) \
+    SIGNAL(view_group_leader_changed, ARG(u, view_id) \
+           ARG(u, view_group_leader_view_id)) \
+    SIGNAL(view_tiling_changed, ARG(u, view_id) ARG(u, edges)) \
+    SIGNAL(view_geometry_changed, ARG(u, view_id) ARG(i, x) ARG(i, y) \
+           ARG(i, width) ARG(i, height)) \
+    SIGNAL(view_moving_changed, ARG(u, view_id)) \
+    SIGNAL(view_resizing_changed, ARG(u, view_id)) \
+    SIGNAL(view_role_changed, ARG(u, view_id) ARG(u, view_role)) \
+    SIGNAL(view_maximized_changed, ARG(u, view_id) ARG(b, maximized)) \
+    SIGNAL(view_minimized_changed, ARG(u, view_id) ARG(b, minimized)) \
+    SIGNAL(view_fullscreen_changed, ARG(u, view_id) ARG(b, fullscreened)) \
+    SIGNAL(view_focus_changed, ARG(u, view_id)) \
+    SIGNAL(view_keep_above_changed, ARG(u, view_id) ARG(b, above)) \
+    /* Output related signals, emitted from various sources */ \
+    SIGNAL(output_workspace_changed, ARG(u, output_id) \
+           ARG(i, workspace_horizontal) ARG(i, workspace_vertical)) \
+    SIGNAL(output_added, ARG(u, output_id)) \
+    SIGNAL(output_removed, ARG(u, output_id)) \
+    SIGNAL(output_configuration_changed, ) \
+    /* Application groups (views by app id) */ \
+    SIGNAL(app_group_changed, ARG(s, app_id) ARG(u, views) ARG(b, urgent) \
+           ARG(b, minimized)) \
+    /* Workspace summaries (per output, see query_workspace_summary) */ \
+    SIGNAL(workspace_summary_changed, ARG(u, output_id) ARG(t, occupied) \
+           ARG(t, urgent) ARG(t, focused) ARG(t, fullscreen)) \
+    /* For wf-prop & co */ \
+    SIGNAL(view_pressed, ARG(u, view_id))
+
+/***
+ * Tentative signals
+ *  hotspot_edge_triggered (i hotspot_edge)
+ *  hotspot_edge_trigger_stop (i hotspot_edge)
+ *  inhibit_output_started ()
+ *  inhibit_output_stopped ()
+ ***/
+
+#define DBUS_SIGNAL_CTYPE_b gboolean
+#define DBUS_SIGNAL_CTYPE_d double
+#define DBUS_SIGNAL_CTYPE_i int32_t
+/* a GVariant string, floating or borrowed, so interned ones are shared */
+#define DBUS_SIGNAL_CTYPE_s GVariant*
+#define DBUS_SIGNAL_CTYPE_t uint64_t
+#define DBUS_SIGNAL_CTYPE_u uint32_t
+/* floating or borrowed, like the strings */
+#define DBUS_SIGNAL_CTYPE_vardict GVariant*
+
+#define DBUS_SIGNAL_VALUE_b g_variant_new_boolean
+#define DBUS_SIGNAL_VALUE_d g_variant_new_double
+#define DBUS_SIGNAL_VALUE_i g_variant_new_int32
+#define DBUS_SIGNAL_VALUE_s
+#define DBUS_SIGNAL_VALUE_t g_variant_new_uint64
+#define DBUS_SIGNAL_VALUE_u g_variant_new_uint32
+#define DBUS_SIGNAL_VALUE_vardict
+
+#define DBUS_SIGNAL_DBUS_TYPE_b "b"
+#define DBUS_SIGNAL_DBUS_TYPE_d "d"
+#define DBUS_SIGNAL_DBUS_TYPE_i "i"
+#define DBUS_SIGNAL_DBUS_TYPE_s "s"
+#define DBUS_SIGNAL_DBUS_TYPE_t "t"
+#define DBUS_SIGNAL_DBUS_TYPE_u "u"
+#define DBUS_SIGNAL_DBUS_TYPE_vardict "a{sv}"
+
+/* introspection_xml */
+#define DBUS_SIGNAL_XML_ARG(type, name) \
+    "      <arg type='" DBUS_SIGNAL_DBUS_TYPE_ ## type "' name='" #name "'/>"
+#define DBUS_SIGNAL_XML(name, args) \
+    "    <signal name='" #name "'>" args "    </signal>"
+#define DBUS_SIGNALS_XML DBUS_SIGNALS(DBUS_SIGNAL_XML, DBUS_SIGNAL_XML_ARG)
+
+/* the argument structs */
+#define DBUS_SIGNAL_FIELD(type, name) DBUS_SIGNAL_CTYPE_ ## type name;
+#define DBUS_SIGNAL_STRUCT(name, args) struct name ## _args_t { args };
+DBUS_SIGNALS(DBUS_SIGNAL_STRUCT, DBUS_SIGNAL_FIELD)
+
+/***
+ * The emitters. The last element of children only keeps the
+ * array non-empty, signals without arguments have no body.
+ ***/
+#define DBUS_SIGNAL_CHILD(type, name) DBUS_SIGNAL_VALUE_ ## type(args.name),
+#define DBUS_SIGNAL_EMITTER(name, fields) \
+    static inline void \
+    emit_ ## name (const name ## _args_t& args) \
+    { \
+        GVariant* children [] = {fields nullptr}; \
+        gsize n_children = G_N_ELEMENTS(children) - 1; \
+        bus_emit_signal(#name, n_children ? \
+                        g_variant_new_tuple(children, n_children) : nullptr); \
+    }
+DBUS_SIGNALS(DBUS_SIGNAL_EMITTER, DBUS_SIGNAL_CHILD)
+
+#endif
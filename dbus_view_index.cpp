@@ -0,0 +1,420 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_view_index.cpp -- the view indices. While they are not valid
+ * the hooks leave them alone, the next lookup rebuilds them from
+ * dbus_core in one pass.
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <unordered_map>
+
+#include "dbus_view_index.hpp"
+
+/* what a view is filed under in the reverse maps */
+struct view_keys_t
+{
+    pid_t pid;
+    uint32_t window_id;
+    std::string app_id;
+    /* a pending view claimed for asking the X server */
+    bool claimed;
+};
+
+/* view id -> parent id, for views with a parent */
+static std::unordered_map<uint32_t, uint32_t> parents;
+/* view id -> its direct transients, in the order they were mapped */
+static std::unordered_map<uint32_t, std::vector<uint32_t>> transients;
+
+static std::unordered_map<uint32_t, view_keys_t> view_keys;
+static std::unordered_map<pid_t, std::vector<uint32_t>> views_by_pid;
+static std::unordered_map<uint32_t, uint32_t> view_by_xid;
+static std::unordered_map<std::string, std::vector<uint32_t>> views_by_app_id;
+/***
+ * XWayland views still filed under the wayland client's (Xwayland's)
+ * pid, until their X client's pid is reported.
+ ***/
+static std::vector<uint32_t> pending_pids;
+/* pids asked for off the main thread, as (view id, pid), -1 if asking failed */
+static std::vector<std::pair<uint32_t, pid_t>> reported_pids;
+static GMutex reported_lock;
+
+static bool index_valid = false;
+
+template<class key_t>
+static void
+file_view (std::unordered_map<key_t, std::vector<uint32_t>>& map,
+           const key_t& key, uint32_t view_id)
+{
+    map[key].push_back(view_id);
+}
+
+template<class key_t>
+static void
+unfile_view (std::unordered_map<key_t, std::vector<uint32_t>>& map,
+             const key_t& key, uint32_t view_id)
+{
+    typename std::unordered_map<key_t, std::vector<uint32_t>>::iterator ids;
+
+    ids = map.find(key);
+    if (ids == map.end()) {
+        return;
+    }
+
+    ids->second.erase(std::remove(ids->second.begin(), ids->second.end(),
+                                  view_id), ids->second.end());
+    if (ids->second.empty()) {
+        map.erase(ids);
+    }
+}
+
+static void
+group_unlink (uint32_t view_id)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator parent;
+
+    parent = parents.find(view_id);
+    if (parent == parents.end()) {
+        return;
+    }
+
+    unfile_view(transients, parent->second, view_id);
+    parents.erase(parent);
+}
+
+static void
+group_link (dbus_view_t* view)
+{
+    dbus_view_t* parent = view->get_parent();
+    uint32_t view_id    = view->get_id();
+
+    if (!parent || (parent->get_id() == view_id)) {
+        return;
+    }
+
+    parents[view_id] = parent->get_id();
+    file_view(transients, parent->get_id(), view_id);
+}
+
+static void
+keys_remove (uint32_t view_id)
+{
+    std::unordered_map<uint32_t, view_keys_t>::iterator keys;
+
+    keys = view_keys.find(view_id);
+    if (keys == view_keys.end()) {
+        return;
+    }
+
+    unfile_view(views_by_pid, keys->second.pid, view_id);
+    unfile_view(views_by_app_id, keys->second.app_id, view_id);
+    if (keys->second.window_id != 0) {
+        view_by_xid.erase(keys->second.window_id);
+        pending_pids.erase(std::remove(pending_pids.begin(),
+                                       pending_pids.end(), view_id),
+                           pending_pids.end());
+    }
+
+    view_keys.erase(keys);
+}
+
+static void
+keys_add (dbus_view_t* view)
+{
+    uint32_t view_id = view->get_id();
+    view_keys_t keys;
+    uid_t uid;
+    gid_t gid;
+
+    keys.pid = 0;
+    view->get_client_credentials(&keys.pid, &uid, &gid);
+    keys.window_id = view->get_xwayland_window_id();
+    keys.app_id    = view->get_app_id();
+    keys.claimed   = false;
+
+    file_view(views_by_pid, keys.pid, view_id);
+    file_view(views_by_app_id, keys.app_id, view_id);
+    if (keys.window_id != 0) {
+        view_by_xid[keys.window_id] = view_id;
+        pending_pids.push_back(view_id);
+    }
+
+    view_keys[view_id] = keys;
+}
+
+static void
+refile_pid (uint32_t view_id, pid_t pid)
+{
+    std::unordered_map<uint32_t, view_keys_t>::iterator keys;
+
+    keys = view_keys.find(view_id);
+    if ((keys == view_keys.end()) || (pid == 0) || (pid == keys->second.pid)) {
+        return;
+    }
+
+    unfile_view(views_by_pid, keys->second.pid, view_id);
+    keys->second.pid = pid;
+    file_view(views_by_pid, pid, view_id);
+}
+
+static void
+take_reported_pids ()
+{
+    std::unordered_map<uint32_t, view_keys_t>::iterator keys;
+    std::vector<std::pair<uint32_t, pid_t>> reported;
+
+    g_mutex_lock(&reported_lock);
+    reported.swap(reported_pids);
+    g_mutex_unlock(&reported_lock);
+
+    /* refile_pid skips views closed in the meantime */
+    for (const std::pair<uint32_t, pid_t>& view : reported)
+    {
+        if (view.second < 0) {
+            keys = view_keys.find(view.first);
+            if (keys != view_keys.end()) {
+                keys->second.claimed = false;
+            }
+
+            continue;
+        }
+
+        refile_pid(view.first, view.second);
+        pending_pids.erase(std::remove(pending_pids.begin(),
+                                       pending_pids.end(), view.first),
+                           pending_pids.end());
+    }
+}
+
+static void
+index_rebuild ()
+{
+    parents.clear();
+    transients.clear();
+    view_keys.clear();
+    views_by_pid.clear();
+    view_by_xid.clear();
+    views_by_app_id.clear();
+    pending_pids.clear();
+    for (dbus_view_t* view : dbus_core->get_all_views())
+    {
+        if (view->is_mapped()) {
+            group_link(view);
+            keys_add(view);
+        }
+    }
+
+    index_valid = true;
+}
+
+static void
+index_ensure ()
+{
+    if (!index_valid && dbus_core) {
+        index_rebuild();
+    }
+}
+
+void
+dbus_view_index_add (dbus_view_t* view)
+{
+    if (!index_valid || !view) {
+        return;
+    }
+
+    group_unlink(view->get_id());
+    group_link(view);
+    keys_remove(view->get_id());
+    keys_add(view);
+}
+
+void
+dbus_view_index_remove (uint32_t view_id)
+{
+    std::unordered_map<uint32_t, std::vector<uint32_t>>::iterator children;
+
+    if (!index_valid) {
+        return;
+    }
+
+    group_unlink(view_id);
+    children = transients.find(view_id);
+    if (children != transients.end()) {
+        for (uint32_t child : children->second)
+        {
+            parents.erase(child);
+        }
+
+        transients.erase(children);
+    }
+
+    keys_remove(view_id);
+}
+
+void
+dbus_view_group_update (dbus_view_t* view)
+{
+    if (!index_valid || !view) {
+        return;
+    }
+
+    group_unlink(view->get_id());
+    if (view->is_mapped()) {
+        group_link(view);
+    }
+}
+
+uint32_t
+dbus_view_group_leader (uint32_t view_id)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator parent;
+    /* a parent loop can't happen in the compositor, don't hang on one */
+    size_t depth = 0;
+
+    index_ensure();
+    parent = parents.find(view_id);
+    while ((parent != parents.end()) && (depth++ < parents.size()))
+    {
+        view_id = parent->second;
+        parent  = parents.find(view_id);
+    }
+
+    return view_id;
+}
+
+void
+dbus_view_group_transients (uint32_t leader_id, std::vector<uint32_t>* ids)
+{
+    std::unordered_map<uint32_t, std::vector<uint32_t>>::iterator children;
+    size_t first = ids->size();
+    uint32_t parent_id = leader_id;
+
+    index_ensure();
+    for (size_t i = first; ; i++)
+    {
+        children = transients.find(parent_id);
+        if (children != transients.end()) {
+            ids->insert(ids->end(), children->second.begin(),
+                        children->second.end());
+        }
+
+        if ((i >= ids->size()) || (ids->size() - first > parents.size())) {
+            break;
+        }
+
+        parent_id = (*ids)[i];
+    }
+}
+
+void
+dbus_view_index_update_app_id (dbus_view_t* view)
+{
+    std::unordered_map<uint32_t, view_keys_t>::iterator keys;
+
+    if (!index_valid || !view) {
+        return;
+    }
+
+    keys = view_keys.find(view->get_id());
+    if (keys == view_keys.end()) {
+        return;
+    }
+
+    unfile_view(views_by_app_id, keys->second.app_id, keys->first);
+    keys->second.app_id = view->get_app_id();
+    file_view(views_by_app_id, keys->second.app_id, keys->first);
+}
+
+void
+dbus_view_index_by_pid (pid_t pid, std::vector<uint32_t>* ids)
+{
+    std::unordered_map<pid_t, std::vector<uint32_t>>::iterator found;
+
+    index_ensure();
+    take_reported_pids();
+    found = views_by_pid.find(pid);
+    if (found != views_by_pid.end()) {
+        ids->insert(ids->end(), found->second.begin(), found->second.end());
+    }
+}
+
+uint32_t
+dbus_view_index_by_xid (uint32_t window_id)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator found;
+
+    index_ensure();
+    found = view_by_xid.find(window_id);
+
+    return (found != view_by_xid.end()) ? found->second : 0;
+}
+
+void
+dbus_view_index_by_app_id (const std::string& app_id,
+                           std::vector<uint32_t>* ids)
+{
+    std::unordered_map<std::string, std::vector<uint32_t>>::iterator found;
+
+    index_ensure();
+    found = views_by_app_id.find(app_id);
+    if (found != views_by_app_id.end()) {
+        ids->insert(ids->end(), found->second.begin(), found->second.end());
+    }
+}
+
+void
+dbus_view_index_invalidate ()
+{
+    index_valid = false;
+}
+
+void
+dbus_view_index_pending (std::vector<std::pair<uint32_t, uint32_t>>* views)
+{
+    std::unordered_map<uint32_t, view_keys_t>::iterator keys;
+
+    index_ensure();
+    take_reported_pids();
+    for (uint32_t view_id : pending_pids)
+    {
+        keys = view_keys.find(view_id);
+        if (keys != view_keys.end()) {
+            views->emplace_back(view_id, keys->second.window_id);
+        }
+    }
+}
+
+void
+dbus_view_index_claim_pending (
+    std::vector<std::pair<uint32_t, uint32_t>>* views)
+{
+    std::unordered_map<uint32_t, view_keys_t>::iterator keys;
+
+    index_ensure();
+    take_reported_pids();
+    for (uint32_t view_id : pending_pids)
+    {
+        keys = view_keys.find(view_id);
+        if ((keys != view_keys.end()) && !keys->second.claimed) {
+            keys->second.claimed = true;
+            views->emplace_back(view_id, keys->second.window_id);
+        }
+    }
+}
+
+void
+dbus_view_index_set_pid (uint32_t view_id, pid_t pid)
+{
+    g_mutex_lock(&reported_lock);
+    reported_pids.emplace_back(view_id, pid);
+    g_mutex_unlock(&reported_lock);
+}
+
+void
+dbus_view_index_pid_failed (uint32_t view_id)
+{
+    g_mutex_lock(&reported_lock);
+    reported_pids.emplace_back(view_id, -1);
+    g_mutex_unlock(&reported_lock);
+}
@@ -0,0 +1,90 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_view_index.hpp -- indices over the mapped views, kept up to
+ * date by the backend's hooks, so the lookups that would otherwise
+ * ask every view (or walk up its parents) are one map access.
+ ********************************************************************/
+
+#ifndef DBUS_VIEW_INDEX_HPP
+#define DBUS_VIEW_INDEX_HPP
+
+#include <sys/types.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+/***
+ * A view enters the indices when it is mapped and leaves them when
+ * it is unmapped.
+ ***/
+void dbus_view_index_add (dbus_view_t* view);
+void dbus_view_index_remove (uint32_t view_id);
+
+/***
+ * The transient tree: a mapped view with a parent is one of its
+ * transients, a view without one leads its group. When a view is
+ * unmapped its transients lead their own groups.
+ * dbus_view_group_update follows a change of the view's parent.
+ ***/
+void dbus_view_group_update (dbus_view_t* view);
+
+/***
+ * The root of view_id's group, view_id itself if it has no parent
+ * or isn't mapped.
+ ***/
+uint32_t dbus_view_group_leader (uint32_t view_id);
+
+/***
+ * The transients of leader_id, all levels, parents before their
+ * own transients.
+ ***/
+void dbus_view_group_transients (uint32_t leader_id,
+                                 std::vector<uint32_t>* ids);
+
+/***
+ * Reverse lookups by the client's pid, the XWayland window id and
+ * the app id. The pid of an XWayland view is that of the X client
+ * (as query_view_credentials), it is asked from the X server off the
+ * main thread when the view is mapped, until it is reported the
+ * view is filed under Xwayland's. dbus_view_index_update_app_id
+ * follows app id changes.
+ ***/
+void dbus_view_index_update_app_id (dbus_view_t* view);
+void dbus_view_index_by_pid (pid_t pid, std::vector<uint32_t>* ids);
+/* 0 if no mapped view has the window */
+uint32_t dbus_view_index_by_xid (uint32_t window_id);
+void dbus_view_index_by_app_id (const std::string& app_id,
+                                std::vector<uint32_t>* ids);
+
+/***
+ * The XWayland views whose pid hasn't been reported yet, as (view
+ * id, window id), for asking the X server off the main thread.
+ * They stay pending until whoever asks reports back with
+ * dbus_view_index_set_pid, from any thread (pid 0 if the server
+ * doesn't know it), the views are refiled on the next lookup.
+ ***/
+void dbus_view_index_pending (
+    std::vector<std::pair<uint32_t, uint32_t>>* views);
+void dbus_view_index_set_pid (uint32_t view_id, pid_t pid);
+
+/***
+ * For asking as the views are mapped: the pending views no one has
+ * claimed yet, they are claimed until their pid is reported or
+ * dbus_view_index_pid_failed hands them back (the X server couldn't
+ * be reached) for the next claim.
+ ***/
+void dbus_view_index_claim_pending (
+    std::vector<std::pair<uint32_t, uint32_t>>* views);
+void dbus_view_index_pid_failed (uint32_t view_id);
+
+/***
+ * The indices are rebuilt from dbus_core on the next lookup,
+ * for changes no hook reports.
+ ***/
+void dbus_view_index_invalidate ();
+
+#endif
@@ -0,0 +1,304 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_view_search.cpp -- the trigram index. Every toplevel's folded
+ * app id and title are split into byte trigrams, each trigram maps
+ * to the views containing it. A search starts from the rarest
+ * trigram of the query and checks those views for the substring,
+ * queries shorter than a trigram check all views.
+ *
+ * Title changes only touch the trigrams that came or went, a
+ * terminal updating its title doesn't rebuild its whole entry.
+ ********************************************************************/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+#include "dbus_view_search.hpp"
+
+struct search_entry_t
+{
+    /* lower-cased */
+    std::string app_id;
+    std::string title;
+    /* sorted, no duplicates */
+    std::vector<uint32_t> trigrams;
+};
+
+static std::unordered_map<uint32_t, search_entry_t> entries;
+/* trigram -> the views having it */
+static std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+static bool search_valid = false;
+
+static std::string
+search_fold (const std::string& text)
+{
+    gchar* folded;
+    std::string result;
+
+    if (g_utf8_validate(text.c_str(), text.size(), nullptr)) {
+        folded = g_utf8_strdown(text.c_str(), text.size());
+    }
+    else
+    {
+        folded = g_ascii_strdown(text.c_str(), text.size());
+    }
+
+    result = folded;
+    g_free(folded);
+
+    return result;
+}
+
+static void
+add_trigrams (const std::string& text, std::vector<uint32_t>* trigrams)
+{
+    const guchar* bytes = (const guchar*)text.c_str();
+
+    for (size_t i = 0; i + 2 < text.size(); i++)
+    {
+        trigrams->push_back((bytes[i] << 16) | (bytes[i + 1] << 8) |
+                            bytes[i + 2]);
+    }
+}
+
+static void
+sort_trigrams (std::vector<uint32_t>* trigrams)
+{
+    std::sort(trigrams->begin(), trigrams->end());
+    trigrams->erase(std::unique(trigrams->begin(), trigrams->end()),
+                    trigrams->end());
+}
+
+static void
+posting_remove (uint32_t trigram, uint32_t view_id)
+{
+    std::unordered_map<uint32_t, std::vector<uint32_t>>::iterator views;
+
+    views = postings.find(trigram);
+    if (views == postings.end()) {
+        return;
+    }
+
+    views->second.erase(std::remove(views->second.begin(),
+                                    views->second.end(), view_id),
+                        views->second.end());
+    if (views->second.empty()) {
+        postings.erase(views);
+    }
+}
+
+static void
+entry_remove (uint32_t view_id)
+{
+    std::unordered_map<uint32_t, search_entry_t>::iterator entry;
+
+    entry = entries.find(view_id);
+    if (entry == entries.end()) {
+        return;
+    }
+
+    for (uint32_t trigram : entry->second.trigrams)
+    {
+        posting_remove(trigram, view_id);
+    }
+
+    entries.erase(entry);
+}
+
+static void
+entry_update (dbus_view_t* view)
+{
+    uint32_t view_id = view->get_id();
+    search_entry_t& entry = entries[view_id];
+    std::vector<uint32_t> trigrams;
+    std::vector<uint32_t> changed;
+
+    entry.app_id = search_fold(view->get_app_id());
+    entry.title  = search_fold(view->get_title());
+    add_trigrams(entry.app_id, &trigrams);
+    add_trigrams(entry.title, &trigrams);
+    sort_trigrams(&trigrams);
+
+    std::set_difference(entry.trigrams.begin(), entry.trigrams.end(),
+                        trigrams.begin(), trigrams.end(),
+                        std::back_inserter(changed));
+    for (uint32_t trigram : changed)
+    {
+        posting_remove(trigram, view_id);
+    }
+
+    changed.clear();
+    std::set_difference(trigrams.begin(), trigrams.end(),
+                        entry.trigrams.begin(), entry.trigrams.end(),
+                        std::back_inserter(changed));
+    for (uint32_t trigram : changed)
+    {
+        postings[trigram].push_back(view_id);
+    }
+
+    entry.trigrams.swap(trigrams);
+}
+
+static bool
+is_searched (dbus_view_t* view)
+{
+    return view->is_mapped() && (view->get_role() == DBUS_VIEW_ROLE_TOPLEVEL);
+}
+
+static void
+search_rebuild ()
+{
+    entries.clear();
+    postings.clear();
+    for (dbus_view_t* view : dbus_core->get_all_views())
+    {
+        if (is_searched(view)) {
+            entry_update(view);
+        }
+    }
+
+    search_valid = true;
+}
+
+/***
+ * 0 (best) to 4, -1 if the entry doesn't contain query.
+ ***/
+static int
+search_rank (const search_entry_t& entry, const std::string& query)
+{
+    const std::string* texts [] = {&entry.app_id, &entry.title};
+    bool found = false;
+
+    if (entry.app_id == query) {
+        return 0;
+    }
+
+    if (entry.app_id.compare(0, query.size(), query) == 0) {
+        return 1;
+    }
+
+    if (entry.title.compare(0, query.size(), query) == 0) {
+        return 2;
+    }
+
+    for (const std::string* text : texts)
+    {
+        for (size_t at = text->find(query); at != std::string::npos;
+             at = text->find(query, at + 1))
+        {
+            if ((at == 0) || !g_ascii_isalnum((*text)[at - 1])) {
+                return 3;
+            }
+
+            found = true;
+        }
+    }
+
+    return found ? 4 : -1;
+}
+
+void
+dbus_view_search_update (dbus_view_t* view)
+{
+    if (!search_valid || !view) {
+        return;
+    }
+
+    if (is_searched(view)) {
+        entry_update(view);
+    }
+    else
+    {
+        entry_remove(view->get_id());
+    }
+}
+
+void
+dbus_view_search_remove (uint32_t view_id)
+{
+    if (search_valid) {
+        entry_remove(view_id);
+    }
+}
+
+void
+dbus_view_search_invalidate ()
+{
+    search_valid = false;
+}
+
+void
+dbus_view_search (const std::string& query, uint32_t limit,
+                  std::vector<uint32_t>* ids)
+{
+    std::string folded = search_fold(query);
+    std::vector<uint32_t> trigrams;
+    std::vector<uint32_t> candidates;
+    std::vector<std::pair<int, uint32_t>> matches;
+    std::unordered_map<uint32_t, std::vector<uint32_t>>::iterator views;
+    std::unordered_map<uint32_t, search_entry_t>::iterator entry;
+    const std::vector<uint32_t>* rarest = nullptr;
+
+    if (!search_valid && dbus_core) {
+        search_rebuild();
+    }
+
+    add_trigrams(folded, &trigrams);
+    sort_trigrams(&trigrams);
+    for (uint32_t trigram : trigrams)
+    {
+        views = postings.find(trigram);
+        if (views == postings.end()) {
+            return;
+        }
+
+        if (!rarest || (views->second.size() < rarest->size())) {
+            rarest = &views->second;
+        }
+    }
+
+    if (rarest) {
+        candidates = *rarest;
+    }
+    else
+    {
+        for (const std::pair<const uint32_t, search_entry_t>& e : entries)
+        {
+            candidates.push_back(e.first);
+        }
+    }
+
+    for (uint32_t view_id : candidates)
+    {
+        int rank;
+
+        entry = entries.find(view_id);
+        if (entry == entries.end()) {
+            continue;
+        }
+
+        rank = search_rank(entry->second, folded);
+        if (rank >= 0) {
+            matches.emplace_back(rank, view_id);
+        }
+    }
+
+    if ((limit != 0) && (matches.size() > limit)) {
+        std::partial_sort(matches.begin(), matches.begin() + limit,
+                          matches.end());
+        matches.resize(limit);
+    }
+    else
+    {
+        std::sort(matches.begin(), matches.end());
+    }
+
+    for (const std::pair<int, uint32_t>& match : matches)
+    {
+        ids->push_back(match.second);
+    }
+}
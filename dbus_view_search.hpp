@@ -0,0 +1,41 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_view_search.hpp -- type-ahead search over the app ids and
+ * titles of the mapped toplevels, for query_views_matching. A
+ * trigram index over the lower-cased strings narrows the views down
+ * to a few candidates, which are then checked and ranked.
+ ********************************************************************/
+
+#ifndef DBUS_VIEW_SEARCH_HPP
+#define DBUS_VIEW_SEARCH_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+/***
+ * A view enters the index when it is mapped, its entry follows its
+ * app id, title and role, unmapped views leave it.
+ ***/
+void dbus_view_search_update (dbus_view_t* view);
+void dbus_view_search_remove (uint32_t view_id);
+
+/***
+ * The index is rebuilt from dbus_core on the next search,
+ * for changes no hook reports.
+ ***/
+void dbus_view_search_invalidate ();
+
+/***
+ * Toplevels whose app id or title contains query, ignoring case,
+ * best first: app id equal to the query, app id starting with it,
+ * title starting with it, a word starting with it, anywhere else.
+ * At most limit ids (0 for all), an empty query matches all views.
+ ***/
+void dbus_view_search (const std::string& query, uint32_t limit,
+                       std::vector<uint32_t>* ids);
+
+#endif
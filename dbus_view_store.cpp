@@ -0,0 +1,319 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_view_store.cpp -- the columnar view store. Rows are kept
+ * densely packed (a removed row is replaced by the last one), the
+ * filter is a branch free pass over the columns the compiler can
+ * vectorise, followed by collecting the matching ids.
+ ********************************************************************/
+
+#include <unordered_map>
+
+#include "dbus_view_store.hpp"
+
+dbus_view_store_t dbus_view_store;
+/* view id -> row */
+static std::unordered_map<uint32_t, uint32_t> rows;
+static bool store_valid = false;
+
+static uint32_t
+view_flags (dbus_view_t* view)
+{
+    uint32_t flags = 0;
+
+    flags |= view->is_mapped() ? DBUS_VIEW_FLAG_MAPPED : 0;
+    flags |= (view->get_role() == DBUS_VIEW_ROLE_TOPLEVEL) ?
+        DBUS_VIEW_FLAG_TOPLEVEL : 0;
+    flags |= view->is_minimized() ? DBUS_VIEW_FLAG_MINIMIZED : 0;
+    flags |= view->is_maximized() ? DBUS_VIEW_FLAG_MAXIMIZED : 0;
+    flags |= view->is_fullscreen() ? DBUS_VIEW_FLAG_FULLSCREEN : 0;
+    flags |= view->is_activated() ? DBUS_VIEW_FLAG_ACTIVATED : 0;
+    flags |= view->is_above() ? DBUS_VIEW_FLAG_ABOVE : 0;
+    flags |= view->demands_attention() ? DBUS_VIEW_FLAG_ATTENTION : 0;
+
+    return flags;
+}
+
+static bool
+workspace_bit (int x, int y, uint64_t* bit)
+{
+    if ((x < 0) || (y < 0) || (x >= DBUS_VIEW_STORE_WORKSPACE_STRIDE) ||
+        (y >= DBUS_VIEW_STORE_WORKSPACE_STRIDE)) {
+        return false;
+    }
+
+    *bit = 1ull << (y * DBUS_VIEW_STORE_WORKSPACE_STRIDE + x);
+
+    return true;
+}
+
+static uint64_t
+workspace_mask (dbus_view_t* view)
+{
+    uint64_t mask = 0;
+    uint64_t bit;
+
+    for (const dbus_workspace_t& ws : view->get_workspaces())
+    {
+        if (workspace_bit(ws.x, ws.y, &bit)) {
+            mask |= bit;
+        }
+    }
+
+    return mask;
+}
+
+static void
+fill_row (uint32_t row, dbus_view_t* view)
+{
+    dbus_output_t* output = view->get_output();
+    dbus_view_store_t& store = dbus_view_store;
+
+    store.flags[row]      = view_flags(view);
+    store.output_ids[row] = output ? output->get_id() : 0;
+    store.geometry[row]   = output ? view->get_output_geometry() :
+        dbus_geometry_t{0, 0, 0, 0};
+    /* a view without an output is on no workspace, don't ask it */
+    store.workspaces[row] = 0;
+    store.stale[row] = output ? 1 : 0;
+    store.views[row] = view;
+}
+
+static uint32_t
+add_row (dbus_view_t* view)
+{
+    dbus_view_store_t& store = dbus_view_store;
+    uint32_t row = store.ids.size();
+
+    store.ids.push_back(view->get_id());
+    store.flags.push_back(0);
+    store.output_ids.push_back(0);
+    store.workspaces.push_back(0);
+    store.geometry.push_back({0, 0, 0, 0});
+    store.stale.push_back(1);
+    store.views.push_back(view);
+    rows[view->get_id()] = row;
+
+    return row;
+}
+
+static void
+rebuild ()
+{
+    dbus_view_store_t& store = dbus_view_store;
+
+    store = dbus_view_store_t();
+    rows.clear();
+    for (dbus_view_t* view : dbus_core->get_all_views())
+    {
+        fill_row(add_row(view), view);
+    }
+
+    store_valid = true;
+}
+
+void
+dbus_view_store_update (dbus_view_t* view)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator row;
+
+    if (!store_valid || !view) {
+        return;
+    }
+
+    row = rows.find(view->get_id());
+    fill_row((row != rows.end()) ? row->second : add_row(view), view);
+}
+
+void
+dbus_view_store_update_state (dbus_view_t* view, uint32_t flag, bool state)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator row;
+    uint32_t i;
+
+    if (!store_valid || !view) {
+        return;
+    }
+
+    row = rows.find(view->get_id());
+    i   = (row != rows.end()) ? row->second : add_row(view);
+    fill_row(i, view);
+    dbus_view_store.flags[i] &= ~flag;
+    dbus_view_store.flags[i] |= state ? flag : 0;
+}
+
+void
+dbus_view_store_update_geometry (dbus_view_t* view)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator row;
+
+    if (!store_valid || !view) {
+        return;
+    }
+
+    row = rows.find(view->get_id());
+    if (row == rows.end()) {
+        return;
+    }
+
+    dbus_view_store.geometry[row->second] = view->get_output_geometry();
+    dbus_view_store.stale[row->second]    =
+        dbus_view_store.output_ids[row->second] != 0;
+}
+
+void
+dbus_view_store_set_activated (dbus_view_t* view)
+{
+    std::unordered_map<uint32_t, uint32_t>::iterator row;
+    uint32_t* flags = dbus_view_store.flags.data();
+    size_t count    = dbus_view_store.flags.size();
+
+    if (!store_valid || !view) {
+        return;
+    }
+
+    /* the previously focused view isn't reported */
+    for (size_t i = 0; i < count; i++)
+    {
+        flags[i] &= ~DBUS_VIEW_FLAG_ACTIVATED;
+    }
+
+    row = rows.find(view->get_id());
+    if ((row != rows.end()) && view->is_activated()) {
+        flags[row->second] |= DBUS_VIEW_FLAG_ACTIVATED;
+    }
+}
+
+void
+dbus_view_store_update_output (dbus_output_t* output)
+{
+    dbus_view_store_t& store = dbus_view_store;
+    uint32_t output_id = output->get_id();
+
+    if (!store_valid) {
+        return;
+    }
+
+    /* geometry is relative to the output's current workspace */
+    for (size_t i = 0; i < store.ids.size(); i++)
+    {
+        if (store.output_ids[i] == output_id) {
+            store.geometry[i] = store.views[i]->get_output_geometry();
+        }
+    }
+}
+
+void
+dbus_view_store_remove (uint32_t view_id)
+{
+    dbus_view_store_t& store = dbus_view_store;
+    std::unordered_map<uint32_t, uint32_t>::iterator row;
+    uint32_t last;
+    uint32_t i;
+
+    row = rows.find(view_id);
+    if (!store_valid || (row == rows.end())) {
+        return;
+    }
+
+    i    = row->second;
+    last = store.ids.size() - 1;
+    rows.erase(row);
+    if (i != last) {
+        store.ids[i]        = store.ids[last];
+        store.flags[i]      = store.flags[last];
+        store.output_ids[i] = store.output_ids[last];
+        store.workspaces[i] = store.workspaces[last];
+        store.geometry[i]   = store.geometry[last];
+        store.stale[i]      = store.stale[last];
+        store.views[i]      = store.views[last];
+        rows[store.ids[i]]  = i;
+    }
+
+    store.ids.pop_back();
+    store.flags.pop_back();
+    store.output_ids.pop_back();
+    store.workspaces.pop_back();
+    store.geometry.pop_back();
+    store.stale.pop_back();
+    store.views.pop_back();
+}
+
+void
+dbus_view_store_invalidate ()
+{
+    store_valid = false;
+}
+
+void
+dbus_view_store_select (uint32_t flags_mask, uint32_t flags_value,
+                        uint32_t output_id, int workspace_x,
+                        int workspace_y, std::vector<uint32_t>* ids)
+{
+    dbus_view_store_t& store = dbus_view_store;
+    bool any_workspace = workspace_x < 0;
+    bool check_on_view = false;
+    uint64_t ws_bit    = 0;
+    std::vector<uint8_t> match;
+    size_t count;
+
+    if (!store_valid) {
+        rebuild();
+    }
+
+    if (!any_workspace) {
+        check_on_view = !workspace_bit(workspace_x, workspace_y, &ws_bit);
+        for (size_t i = 0; i < store.ids.size(); i++)
+        {
+            if (store.stale[i]) {
+                store.workspaces[i] = workspace_mask(store.views[i]);
+                store.stale[i] = 0;
+            }
+        }
+    }
+
+    count = store.ids.size();
+    match.resize(count);
+
+    const uint32_t* flags      = store.flags.data();
+    const uint32_t* output_ids = store.output_ids.data();
+    const uint64_t* workspaces = store.workspaces.data();
+    uint8_t* matches = match.data();
+    bool any_output  = output_id == 0;
+    bool skip_ws     = any_workspace || check_on_view;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        matches[i] = ((flags[i] & flags_mask) == flags_value) &
+            (any_output | (output_ids[i] == output_id)) &
+            (skip_ws | ((workspaces[i] & ws_bit) != 0));
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!matches[i]) {
+            continue;
+        }
+
+        if (check_on_view) {
+            bool on_workspace = false;
+
+            if (store.output_ids[i] == 0) {
+                continue;
+            }
+
+            for (const dbus_workspace_t& ws : store.views[i]->get_workspaces())
+            {
+                if ((ws.x == workspace_x) && (ws.y == workspace_y)) {
+                    on_workspace = true;
+                }
+            }
+
+            if (!on_workspace) {
+                continue;
+            }
+        }
+
+        ids->push_back(store.ids[i]);
+    }
+}
@@ -0,0 +1,84 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_view_store.hpp -- a columnar copy of the state of the views
+ * (id, packed flags, output, workspaces, geometry), kept up to date
+ * by the backend's hooks, for the bulk and filtered queries.
+ * A filter is a scan over a few contiguous arrays instead of a walk
+ * over the compositor's views with several virtual calls per view.
+ ********************************************************************/
+
+#ifndef DBUS_VIEW_STORE_HPP
+#define DBUS_VIEW_STORE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+/* the flags word, as exposed by query_views_filtered */
+#define DBUS_VIEW_FLAG_MAPPED     (1u << 0)
+#define DBUS_VIEW_FLAG_TOPLEVEL   (1u << 1)
+#define DBUS_VIEW_FLAG_MINIMIZED  (1u << 2)
+#define DBUS_VIEW_FLAG_MAXIMIZED  (1u << 3)
+#define DBUS_VIEW_FLAG_FULLSCREEN (1u << 4)
+#define DBUS_VIEW_FLAG_ACTIVATED  (1u << 5)
+#define DBUS_VIEW_FLAG_ABOVE      (1u << 6)
+#define DBUS_VIEW_FLAG_ATTENTION  (1u << 7)
+
+/***
+ * Workspace (x, y) is bit y * 8 + x of the mask, whatever the grid,
+ * workspaces beyond the first 8x8 are checked on the view itself.
+ ***/
+#define DBUS_VIEW_STORE_WORKSPACE_STRIDE 8
+
+struct dbus_view_store_t
+{
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> flags;
+    std::vector<uint32_t> output_ids;
+    /* the workspaces the view is on */
+    std::vector<uint64_t> workspaces;
+    std::vector<dbus_geometry_t> geometry;
+    /***
+     * The workspace mask needs recomputing, set on geometry changes.
+     * Rows without an output keep a mask of 0 and are never recomputed.
+     ***/
+    std::vector<uint8_t> stale;
+    std::vector<dbus_view_t*> views;
+};
+
+extern dbus_view_store_t dbus_view_store;
+
+/***
+ * Rows follow the hooks. The store holds every view the core
+ * reports, mapped or not (the mapped flag tells), an update inserts
+ * views it hasn't seen yet, views leave it when they are closed or
+ * destroyed. dbus_view_store_update_state takes one of the flags
+ * from the hook instead of the view, for the request hooks that run
+ * before the view changes.
+ ***/
+void dbus_view_store_update (dbus_view_t* view);
+void dbus_view_store_update_state (dbus_view_t* view, uint32_t flag,
+                                   bool state);
+void dbus_view_store_update_geometry (dbus_view_t* view);
+void dbus_view_store_set_activated (dbus_view_t* view);
+void dbus_view_store_update_output (dbus_output_t* output);
+void dbus_view_store_remove (uint32_t view_id);
+
+/***
+ * The store is rebuilt from dbus_core on the next query,
+ * for changes no hook reports.
+ ***/
+void dbus_view_store_invalidate ();
+
+/***
+ * Ids of the views with (flags & flags_mask) == flags_value, on
+ * output_id (0 for any) and on workspace (x, y) of their output
+ * (x < 0 for any), in the order the store holds them.
+ ***/
+void dbus_view_store_select (uint32_t flags_mask, uint32_t flags_value,
+                             uint32_t output_id, int workspace_x,
+                             int workspace_y, std::vector<uint32_t>* ids);
+
+#endif
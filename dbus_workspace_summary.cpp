@@ -0,0 +1,398 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_workspace_summary.cpp -- the counts per output and workspace,
+ * the members are kept by a dbus_member_table_t keyed by output id.
+ ********************************************************************/
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "dbus_member_table.hpp"
+#include "dbus_workspace_summary.hpp"
+
+struct workspace_counts_t
+{
+    uint32_t views      = 0;
+    uint32_t focused    = 0;
+    uint32_t urgent     = 0;
+    uint32_t fullscreen = 0;
+};
+
+struct output_summary_t
+{
+    dbus_workspace_t grid;
+    /* row by row */
+    std::vector<workspace_counts_t> workspaces;
+};
+
+static std::unordered_map<uint32_t, output_summary_t> outputs;
+/* their views are still on them until they are moved */
+static std::unordered_set<uint32_t> removed_outputs;
+static uint32_t focused_id = 0;
+
+static dbus_workspace_masks_t
+output_masks (const output_summary_t& summary)
+{
+    dbus_workspace_masks_t masks;
+    uint64_t bit;
+
+    for (size_t i = 0; (i < summary.workspaces.size()) && (i < 64); i++)
+    {
+        const workspace_counts_t& counts = summary.workspaces[i];
+
+        bit = 1ull << i;
+        masks.occupied   |= counts.views ? bit : 0;
+        masks.urgent     |= counts.urgent ? bit : 0;
+        masks.focused    |= counts.focused ? bit : 0;
+        masks.fullscreen |= counts.fullscreen ? bit : 0;
+    }
+
+    return masks;
+}
+
+static output_summary_t&
+output_summary (dbus_output_t* output)
+{
+    std::unordered_map<uint32_t, output_summary_t>::iterator summary;
+    dbus_workspace_t grid;
+
+    summary = outputs.find(output->get_id());
+    if (summary != outputs.end()) {
+        return summary->second;
+    }
+
+    grid = output->get_workspace_grid_size();
+    output_summary_t& added = outputs[output->get_id()];
+    added.grid = grid;
+    added.workspaces.resize((grid.x > 0) && (grid.y > 0) ? grid.x * grid.y : 0);
+
+    return added;
+}
+
+static int
+floor_div (int a, int b)
+{
+    return (a / b) - (((a % b) != 0) && ((a < 0) != (b < 0)));
+}
+
+/***
+ * The index of the workspace the view's geometry lies entirely
+ * within, -1 if it crosses a workspace edge. A view that stays
+ * within the same workspace is on that one only.
+ ***/
+static int
+view_cell (dbus_view_t* view, dbus_output_t* output)
+{
+    dbus_geometry_t geometry = view->get_output_geometry();
+    dbus_geometry_t size     = output->get_layout_geometry();
+    dbus_workspace_t current = output->get_workspace();
+    dbus_workspace_t grid    = output->get_workspace_grid_size();
+    int x;
+    int y;
+
+    if ((size.width <= 0) || (size.height <= 0)) {
+        return -1;
+    }
+
+    x = floor_div(geometry.x, size.width);
+    y = floor_div(geometry.y, size.height);
+    if ((geometry.x + geometry.width > (x + 1) * size.width) ||
+        (geometry.y + geometry.height > (y + 1) * size.height)) {
+        return -1;
+    }
+
+    x += current.x;
+    y += current.y;
+    if ((x < 0) || (y < 0) || (x >= grid.x) || (y >= grid.y)) {
+        return -1;
+    }
+
+    return y * grid.x + x;
+}
+
+struct workspace_summary_aggregate_t
+{
+    typedef uint32_t key_t;
+    typedef dbus_workspace_masks_t state_t;
+
+    struct member_t
+    {
+        uint32_t output_id;
+        std::vector<dbus_workspace_t> workspaces;
+        bool focused;
+        bool urgent;
+        /* fullscreen counts unless the view is minimized */
+        bool fullscreen;
+        bool minimized;
+        /* the workspace the view lies within, -1 if it spans several */
+        int cell;
+    };
+
+    static key_t
+    key (const member_t& member)
+    {
+        return member.output_id;
+    }
+
+    static state_t
+    state (key_t output_id)
+    {
+        std::unordered_map<uint32_t, output_summary_t>::iterator summary;
+
+        summary = outputs.find(output_id);
+
+        return (summary != outputs.end()) ? output_masks(summary->second) :
+               state_t();
+    }
+
+    static void
+    states (std::unordered_map<key_t, state_t>* by_key)
+    {
+        for (const std::pair<const uint32_t, output_summary_t>& output :
+             outputs)
+        {
+            (*by_key)[output.first] = output_masks(output.second);
+        }
+    }
+
+    static bool
+    same (const state_t& a, const state_t& b)
+    {
+        return (a.occupied == b.occupied) && (a.urgent == b.urgent) &&
+               (a.focused == b.focused) && (a.fullscreen == b.fullscreen);
+    }
+
+    static void
+    count (const member_t& member, uint32_t step)
+    {
+        std::unordered_map<uint32_t, output_summary_t>::iterator summary;
+
+        /* the output may be gone already */
+        summary = outputs.find(member.output_id);
+        if (summary == outputs.end()) {
+            return;
+        }
+
+        dbus_workspace_t grid = summary->second.grid;
+        bool fullscreen = member.fullscreen && !member.minimized;
+        for (const dbus_workspace_t& ws : member.workspaces)
+        {
+            if ((ws.x < 0) || (ws.y < 0) || (ws.x >= grid.x) ||
+                (ws.y >= grid.y)) {
+                continue;
+            }
+
+            workspace_counts_t& counts =
+                summary->second.workspaces[ws.y * grid.x + ws.x];
+            counts.views      += step;
+            counts.focused    += member.focused ? step : 0;
+            counts.urgent     += member.urgent ? step : 0;
+            counts.fullscreen += fullscreen ? step : 0;
+        }
+    }
+
+    static void
+    clear ()
+    {
+        std::unordered_set<uint32_t> removed;
+
+        outputs.clear();
+        /* only those some view is still on are kept */
+        removed.swap(removed_outputs);
+        focused_id = 0;
+        for (dbus_view_t* view : dbus_core->get_all_views())
+        {
+            if (!is_member(view)) {
+                continue;
+            }
+
+            if (removed.count(view->get_output()->get_id()) != 0) {
+                removed_outputs.insert(view->get_output()->get_id());
+            }
+
+            if (!focused_id && view->is_activated()) {
+                focused_id = view->get_id();
+            }
+        }
+    }
+
+    static bool
+    is_member (dbus_view_t* view)
+    {
+        return view->is_mapped() &&
+               (view->get_role() == DBUS_VIEW_ROLE_TOPLEVEL) &&
+               view->get_output();
+    }
+
+    static member_t
+    member (dbus_view_t* view)
+    {
+        dbus_output_t* output = view->get_output();
+
+        if (removed_outputs.count(output->get_id()) == 0) {
+            output_summary(output);
+        }
+
+        return {output->get_id(), view->get_workspaces(),
+            view->get_id() == focused_id, view->demands_attention(),
+            view->is_fullscreen(), view->is_minimized(),
+            view_cell(view, output)};
+    }
+};
+
+typedef workspace_summary_aggregate_t::member_t summary_member_t;
+
+static dbus_member_table_t<workspace_summary_aggregate_t> members;
+
+void
+dbus_workspace_summary_update (dbus_view_t* view,
+                               std::vector<uint32_t>* changed)
+{
+    members.update(view, changed);
+}
+
+void
+dbus_workspace_summary_update_geometry (dbus_view_t* view,
+                                        std::vector<uint32_t>* changed)
+{
+    const summary_member_t* member;
+
+    members.ensure(changed);
+    if (!view) {
+        return;
+    }
+
+    /* moving within one workspace, the common case of a drag */
+    member = members.find(view->get_id());
+    if (member && (member->cell >= 0) && view->get_output() &&
+        (view->get_output()->get_id() == member->output_id) &&
+        (view_cell(view, view->get_output()) == member->cell)) {
+        return;
+    }
+
+    members.update(view, changed);
+}
+
+void
+dbus_workspace_summary_update_minimized (dbus_view_t* view, bool minimized,
+                                         std::vector<uint32_t>* changed)
+{
+    members.update(view, [=] (summary_member_t* member)
+    {
+        member->minimized = minimized;
+    }, changed);
+}
+
+void
+dbus_workspace_summary_update_fullscreen (dbus_view_t* view, bool fullscreen,
+                                          std::vector<uint32_t>* changed)
+{
+    members.update(view, [=] (summary_member_t* member)
+    {
+        member->fullscreen = fullscreen;
+    }, changed);
+}
+
+void
+dbus_workspace_summary_remove (uint32_t view_id,
+                               std::vector<uint32_t>* changed)
+{
+    members.ensure(changed);
+    if (view_id == focused_id) {
+        focused_id = 0;
+    }
+
+    members.remove(view_id, changed);
+}
+
+void
+dbus_workspace_summary_focus (dbus_view_t* view,
+                              std::vector<uint32_t>* changed)
+{
+    const summary_member_t* member;
+    summary_member_t unfocused;
+    summary_member_t focused;
+    uint32_t ids [2];
+
+    members.ensure(changed);
+    ids[0] = focused_id;
+    ids[1] = view ? view->get_id() : 0;
+    if (ids[0] == ids[1]) {
+        return;
+    }
+
+    focused_id = ids[1];
+    member = members.find(ids[0]);
+    if (member) {
+        unfocused = *member;
+        unfocused.focused = false;
+    }
+
+    /* focusing clears the attention, the view is read again */
+    if (members.find(ids[1]) && workspace_summary_aggregate_t::is_member(view)) {
+        focused = workspace_summary_aggregate_t::member(view);
+        /* compared once both moved, the focus may stay on the output */
+        members.set({{ids[0], member ? &unfocused : nullptr},
+                     {ids[1], &focused}}, changed);
+
+        return;
+    }
+
+    members.set({{ids[0], member ? &unfocused : nullptr}}, changed);
+}
+
+void
+dbus_workspace_summary_add_output (uint32_t output_id)
+{
+    /* an id that comes back is a new output */
+    removed_outputs.erase(output_id);
+}
+
+void
+dbus_workspace_summary_remove_output (uint32_t output_id)
+{
+    /* its views are updated as they move to another output */
+    outputs.erase(output_id);
+    removed_outputs.insert(output_id);
+}
+
+void
+dbus_workspace_summary_invalidate ()
+{
+    members.invalidate();
+}
+
+void
+dbus_workspace_summary_get (dbus_output_t* output,
+                            dbus_workspace_summary_t* summary)
+{
+    dbus_workspace_t grid = output->get_workspace_grid_size();
+
+    members.ensure(nullptr);
+
+    /* the grid size changed under the counts, no hook says so */
+    output_summary_t* counts = &output_summary(output);
+    if ((counts->grid.x != grid.x) || (counts->grid.y != grid.y)) {
+        members.invalidate();
+        members.ensure(nullptr);
+        counts = &output_summary(output);
+    }
+
+    summary->grid = counts->grid;
+    summary->views.clear();
+    for (const workspace_counts_t& workspace : counts->workspaces)
+    {
+        summary->views.push_back(workspace.views);
+    }
+
+    summary->masks = output_masks(*counts);
+}
+
+dbus_workspace_masks_t
+dbus_workspace_summary_masks (uint32_t output_id)
+{
+    members.ensure(nullptr);
+
+    return workspace_summary_aggregate_t::state(output_id);
+}
@@ -0,0 +1,79 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_workspace_summary.hpp -- per output and workspace, how many
+ * mapped toplevels are on it and whether one of them is urgent,
+ * focused or fullscreen, what a pager draws. Kept up to date by the
+ * backend's hooks, every update reports the outputs whose bits
+ * changed, for workspace_summary_changed.
+ ********************************************************************/
+
+#ifndef DBUS_WORKSPACE_SUMMARY_HPP
+#define DBUS_WORKSPACE_SUMMARY_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "dbus_core.hpp"
+
+/***
+ * Workspace (x, y) is bit y * grid width + x, workspaces past
+ * the 64th are only in the counts.
+ ***/
+struct dbus_workspace_masks_t
+{
+    uint64_t occupied   = 0;
+    uint64_t urgent     = 0;
+    uint64_t focused    = 0;
+    /* not minimized */
+    uint64_t fullscreen = 0;
+};
+
+struct dbus_workspace_summary_t
+{
+    dbus_workspace_t grid;
+    /* views per workspace, row by row */
+    std::vector<uint32_t> views;
+    dbus_workspace_masks_t masks;
+};
+
+/***
+ * Follow a view's output, workspaces, role, fullscreen and
+ * attention state (map and the hooks of those), its unmap and the
+ * focus. changed gets the ids of the outputs whose masks changed.
+ ***/
+void dbus_workspace_summary_update (dbus_view_t* view,
+                                    std::vector<uint32_t>* changed);
+/***
+ * For the geometry hook, the workspaces are only read again
+ * when the view may have crossed a workspace edge.
+ ***/
+void dbus_workspace_summary_update_geometry (dbus_view_t* view,
+                                             std::vector<uint32_t>* changed);
+/* the minimize and fullscreen hooks are requests, ahead of the view */
+void dbus_workspace_summary_update_minimized (dbus_view_t* view,
+                                              bool minimized,
+                                              std::vector<uint32_t>* changed);
+void dbus_workspace_summary_update_fullscreen (dbus_view_t* view,
+                                               bool fullscreen,
+                                               std::vector<uint32_t>* changed);
+void dbus_workspace_summary_remove (uint32_t view_id,
+                                    std::vector<uint32_t>* changed);
+void dbus_workspace_summary_focus (dbus_view_t* view,
+                                   std::vector<uint32_t>* changed);
+void dbus_workspace_summary_add_output (uint32_t output_id);
+void dbus_workspace_summary_remove_output (uint32_t output_id);
+
+/***
+ * The summaries are rebuilt from dbus_core on the next update or
+ * query, for changes no hook reports. Outputs whose masks differ
+ * from before are reported by that update.
+ ***/
+void dbus_workspace_summary_invalidate ();
+
+void dbus_workspace_summary_get (dbus_output_t* output,
+                                 dbus_workspace_summary_t* summary);
+/* all clear for an output without views */
+dbus_workspace_masks_t dbus_workspace_summary_masks (uint32_t output_id);
+
+#endif
@@ -0,0 +1,374 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ * Copyright (C) 2019 - 2020 Damian Ivanov <damianatorrpm@gmail.com>
+ ********************************************************************/
+
+extern "C" {
+#include <xcb/res.h>
+#include <xcb/xcb.h>
+};
+
+#include <gio/gio.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include "dbus_xcb_query.hpp"
+
+/***
+ * The deadlines of the open connections, kept by a watchdog thread.
+ * It has its own duplicate of each connection's socket, so shutting
+ * it down can't hit a descriptor number reused after xcb closed its
+ * own.
+ ***/
+struct xcb_watch_t
+{
+    gint64 deadline;
+    bool fired;
+};
+
+static GMutex watch_lock;
+static GCond watch_cond;
+/* duplicate socket -> its deadline */
+static std::unordered_map<int, xcb_watch_t> watches;
+static std::unordered_map<xcb_connection_t*, int> watched_connections;
+static GThread* watchdog = nullptr;
+static bool watchdog_stopping = false;
+
+static gpointer
+watchdog_run (gpointer data)
+{
+    gint64 next;
+
+    g_mutex_lock(&watch_lock);
+    while (!watchdog_stopping)
+    {
+        next = G_MAXINT64;
+        for (std::pair<const int, xcb_watch_t>& watch : watches)
+        {
+            if (!watch.second.fired &&
+                (watch.second.deadline <= g_get_monotonic_time())) {
+                /* the blocked read sees the end, xcb fails the connection */
+                shutdown(watch.first, SHUT_RDWR);
+                watch.second.fired = true;
+            }
+
+            if (!watch.second.fired) {
+                next = MIN(next, watch.second.deadline);
+            }
+        }
+
+        if (next == G_MAXINT64) {
+            g_cond_wait(&watch_cond, &watch_lock);
+        }
+        else
+        {
+            g_cond_wait_until(&watch_cond, &watch_lock, next);
+        }
+    }
+
+    g_mutex_unlock(&watch_lock);
+
+    return nullptr;
+}
+
+/***
+ * Watches fd's socket, returns the duplicate to unwatch it with,
+ * -1 if it can't be watched.
+ ***/
+static int
+watch_fd (int fd, guint timeout_ms)
+{
+    int watched = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+
+    if (watched < 0) {
+        return -1;
+    }
+
+    g_mutex_lock(&watch_lock);
+    watches[watched] = {g_get_monotonic_time() + timeout_ms * 1000ll, false};
+    if (!watchdog) {
+        watchdog = g_thread_new("dbus-xcb-watchdog", watchdog_run, nullptr);
+    }
+
+    g_cond_signal(&watch_cond);
+    g_mutex_unlock(&watch_lock);
+
+    return watched;
+}
+
+/* whether the deadline had passed */
+static bool
+unwatch_fd (int watched)
+{
+    bool fired = false;
+
+    g_mutex_lock(&watch_lock);
+    fired = watches[watched].fired;
+    watches.erase(watched);
+    g_mutex_unlock(&watch_lock);
+    close(watched);
+
+    return fired;
+}
+
+/***
+ * The socket of a local display (":N", XWayland's always is),
+ * -1 for another one or if it can't be reached.
+ ***/
+static int
+local_socket (const std::string& display)
+{
+    struct sockaddr_un address;
+    socklen_t length;
+    char* host = nullptr;
+    int number;
+    int screen;
+    int fd;
+
+    if (!xcb_parse_display(display.c_str(), &host, &number, &screen)) {
+        return -1;
+    }
+
+    if (host && (host[0] != '\0') && (strcmp(host, "unix") != 0)) {
+        free(host);
+
+        return -1;
+    }
+
+    free(host);
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    /* the abstract socket first, as xcb does */
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path + 1, sizeof(address.sun_path) - 1,
+             "/tmp/.X11-unix/X%d", number);
+    length = offsetof(struct sockaddr_un, sun_path) + 1 +
+        strlen(address.sun_path + 1);
+    if (connect(fd, (struct sockaddr*)&address, length) == 0) {
+        return fd;
+    }
+
+    snprintf(address.sun_path, sizeof(address.sun_path),
+             "/tmp/.X11-unix/X%d", number);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) == 0) {
+        return fd;
+    }
+
+    close(fd);
+
+    return -1;
+}
+
+xcb_connection_t*
+dbus_xcb_connect (const std::string& display, guint timeout_ms)
+{
+    xcb_connection_t* conn = nullptr;
+    int screen;
+    int watched = -1;
+    int fd = -1;
+
+    if (timeout_ms > 0) {
+        fd = local_socket(display);
+    }
+
+    /* watched before the setup, which blocks on the server too */
+    if (fd >= 0) {
+        watched = watch_fd(fd, timeout_ms);
+        conn    = xcb_connect_to_fd(fd, nullptr);
+        if (xcb_connection_has_error(conn)) {
+            xcb_disconnect(conn);
+            conn = nullptr;
+            /* a server that doesn't answer won't on a second try either */
+            if (unwatch_fd(watched)) {
+                return nullptr;
+            }
+
+            watched = -1;
+        }
+    }
+
+    /* a display that isn't local, or one that wants authorization */
+    if (!conn) {
+        conn = xcb_connect(display.c_str(), &screen);
+        if (xcb_connection_has_error(conn)) {
+            xcb_disconnect(conn);
+
+            return nullptr;
+        }
+
+        if (timeout_ms > 0) {
+            watched = watch_fd(xcb_get_file_descriptor(conn), timeout_ms);
+        }
+    }
+
+    if (watched >= 0) {
+        g_mutex_lock(&watch_lock);
+        watched_connections[conn] = watched;
+        g_mutex_unlock(&watch_lock);
+    }
+
+    return conn;
+}
+
+void
+dbus_xcb_disconnect (xcb_connection_t* conn)
+{
+    std::unordered_map<xcb_connection_t*, int>::iterator watched;
+    int fd = -1;
+
+    if (!conn) {
+        return;
+    }
+
+    g_mutex_lock(&watch_lock);
+    watched = watched_connections.find(conn);
+    if (watched != watched_connections.end()) {
+        fd = watched->second;
+        watched_connections.erase(watched);
+    }
+
+    g_mutex_unlock(&watch_lock);
+
+    if (fd >= 0) {
+        unwatch_fd(fd);
+    }
+
+    xcb_disconnect(conn);
+}
+
+void
+dbus_xcb_shutdown ()
+{
+    if (!watchdog) {
+        return;
+    }
+
+    g_mutex_lock(&watch_lock);
+    watchdog_stopping = true;
+    g_cond_signal(&watch_cond);
+    g_mutex_unlock(&watch_lock);
+
+    g_thread_join(watchdog);
+    watchdog = nullptr;
+    watchdog_stopping = false;
+}
+
+xcb_atom_t
+dbus_xcb_intern_atom (xcb_connection_t* conn, const char* atom_name)
+{
+    xcb_intern_atom_cookie_t atom_cookie;
+    xcb_intern_atom_reply_t* reply;
+    xcb_atom_t atom = XCB_ATOM_NONE;
+
+    atom_cookie = xcb_intern_atom(conn, 0, strlen(atom_name), atom_name);
+    reply = xcb_intern_atom_reply(conn, atom_cookie, NULL);
+    if (reply != NULL) {
+        atom = reply->atom;
+        free(reply);
+    }
+
+    return atom;
+}
+
+static xcb_get_property_reply_t*
+get_property (xcb_connection_t* conn, uint32_t window_id, xcb_atom_t atom)
+{
+    xcb_get_property_cookie_t reply_cookie;
+    xcb_get_property_reply_t* reply_value;
+
+    reply_cookie = xcb_get_property(conn, 0, window_id, atom,
+                                    XCB_ATOM_ANY, 0, 2048);
+    reply_value = xcb_get_property_reply(conn, reply_cookie, NULL);
+    if ((reply_value != NULL) && (reply_value->type == XCB_ATOM_NONE)) {
+        free(reply_value);
+
+        return NULL;
+    }
+
+    return reply_value;
+}
+
+bool
+dbus_xcb_get_cardinal (xcb_connection_t* conn, uint32_t window_id,
+                       xcb_atom_t atom, uint32_t* value)
+{
+    xcb_get_property_reply_t* reply_value;
+    bool found = false;
+
+    reply_value = get_property(conn, window_id, atom);
+    if (reply_value == NULL) {
+        return false;
+    }
+
+    if ((reply_value->type == XCB_ATOM_CARDINAL) &&
+        (xcb_get_property_value_length(reply_value) >= 4)) {
+        *value = *(uint32_t*)xcb_get_property_value(reply_value);
+        found  = true;
+    }
+
+    free(reply_value);
+
+    return found;
+}
+
+bool
+dbus_xcb_get_string (xcb_connection_t* conn, uint32_t window_id,
+                     xcb_atom_t atom, std::string* value, bool* is_cardinal)
+{
+    xcb_get_property_reply_t* reply_value;
+
+    reply_value = get_property(conn, window_id, atom);
+    if (reply_value == NULL) {
+        return false;
+    }
+
+    /* the value is not NUL terminated */
+    *is_cardinal = (reply_value->type == XCB_ATOM_CARDINAL);
+    value->assign((const char*)xcb_get_property_value(reply_value),
+                  xcb_get_property_value_length(reply_value));
+    free(reply_value);
+
+    return true;
+}
+
+pid_t
+dbus_xcb_get_client_pid (xcb_connection_t* conn, uint32_t window_id)
+{
+    xcb_res_client_id_spec_t spec = {0, 0};
+    xcb_res_query_client_ids_cookie_t cookie;
+    xcb_res_query_client_ids_reply_t* reply;
+    xcb_res_client_id_value_iterator_t it;
+    pid_t pid = 0;
+
+    spec.client = window_id;
+    spec.mask = XCB_RES_CLIENT_ID_MASK_LOCAL_CLIENT_PID;
+    cookie = xcb_res_query_client_ids(conn, 1, &spec);
+    reply = xcb_res_query_client_ids_reply(conn, cookie, NULL);
+    if (reply == NULL) {
+        return 0;
+    }
+
+    it = xcb_res_query_client_ids_ids_iterator(reply);
+    for (; it.rem; xcb_res_client_id_value_next(&it))
+    {
+        spec = it.data->spec;
+        if (spec.mask & XCB_RES_CLIENT_ID_MASK_LOCAL_CLIENT_PID) {
+            pid = *xcb_res_client_id_value_value(it.data);
+            break;
+        }
+    }
+
+    free(reply);
+
+    return pid;
+}
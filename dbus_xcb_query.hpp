@@ -0,0 +1,69 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * dbus_xcb_query.hpp -- the XWayland queries of the interface
+ * (window properties and the xcb-res client pid) as plain
+ * functions on a connection, so they can be benchmarked against
+ * any X server.
+ ********************************************************************/
+
+#ifndef DBUS_XCB_QUERY_HPP
+#define DBUS_XCB_QUERY_HPP
+
+extern "C" {
+#include <sys/types.h>
+#include <xcb/xcb.h>
+};
+
+#include <gio/gio.h>
+#include <cstdint>
+#include <string>
+
+/* how long the plugin's connections may take, setup and replies */
+#define DBUS_XCB_TIMEOUT_MS 500
+
+/***
+ * Connects to display, nullptr if the server can't be reached.
+ * With a timeout (0 for none) the connection is shut down that
+ * long after connecting, a server that stops answering fails the
+ * calls still waiting on it instead of blocking them for good.
+ * Closed with dbus_xcb_disconnect.
+ ***/
+xcb_connection_t* dbus_xcb_connect (const std::string& display,
+                                    guint timeout_ms);
+void dbus_xcb_disconnect (xcb_connection_t* conn);
+
+/***
+ * Stops the thread keeping the timeouts, once no connection is
+ * left, for unloading. It is started again by the next connect.
+ ***/
+void dbus_xcb_shutdown ();
+
+/***
+ * XCB_ATOM_NONE if the atom could not be interned.
+ ***/
+xcb_atom_t dbus_xcb_intern_atom (xcb_connection_t* conn, const char* atom_name);
+
+/***
+ * First CARDINAL of the property, false if the window has no such
+ * property or it is of another type.
+ ***/
+bool dbus_xcb_get_cardinal (xcb_connection_t* conn, uint32_t window_id,
+                            xcb_atom_t atom, uint32_t* value);
+
+/***
+ * The property's raw value as a string, false if the window has no
+ * such property. is_cardinal tells CARDINAL properties apart, their
+ * value is not text.
+ ***/
+bool dbus_xcb_get_string (xcb_connection_t* conn, uint32_t window_id,
+                          xcb_atom_t atom, std::string* value,
+                          bool* is_cardinal);
+
+/***
+ * Pid of the client owning window_id through the X-Resource
+ * extension, 0 if the server doesn't know it.
+ ***/
+pid_t dbus_xcb_get_client_pid (xcb_connection_t* conn, uint32_t window_id);
+
+#endif
@@ -10,11 +10,17 @@
 #include <giomm/application.h>
 #include <giomm/dbusconnection.h>
 #include <giomm/dbusproxy.h>
+#include <algorithm>
+#include <deque>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "wfdbus_mirror.hpp"
+
 using DBusConnection = Glib::RefPtr<Gio::DBus::Connection>;
 using DBusProxy = Glib::RefPtr<Gio::DBus::Proxy>;
 
@@ -25,60 +31,79 @@ using DBusProxy = Glib::RefPtr<Gio::DBus::Proxy>;
 static gboolean list = FALSE;
 static DBusConnection connection;
 static DBusProxy proxy;
+/* list, watch, export and pick read the state from here */
+static wfdbus::mirror_t* mirror;
 
-static std::vector<std::pair<int, int>>
-query_view_workspaces (guint view_id)
-{
-    std::vector<std::pair<int, int>> workspaces;
+/*
+ * bench mode: M callers each keep one async call in flight,
+ * methods are picked at random from the weighted mix.
+ */
+static gint bench_duration = 10;
+static gint bench_callers  = 8;
+static gchar* bench_mix    = NULL;
 
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    int x, y;
+/* watch mode redraws at most this often */
+static gint watch_refresh_ms = 250;
 
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_workspaces",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+/* export mode keeps streaming signals after the snapshot */
+static gboolean export_follow = FALSE;
 
-    g_assert_no_error(error);
+#define BENCH_DEFAULT_MIX \
+    "query_view_vector_taskman_ids:1,query_view_title:4,query_view_app_id:4," \
+    "query_view_minimized:2,query_view_active:2,query_view_workspaces:1," \
+    "query_view_output:1,query_output_name:1,update_view_minimize_hint:1"
 
-    GVariantIter iter;
-    GVariantIter iter2;
-    GVariantIter iter3;
-    GVariant* child;
-    GVariant* cchild;
-    GVariant* ccchild;
+struct bench_method_t
+{
+    std::string name;
+    uint weight;
+    /* the single in argument is a view id, an output id or absent */
+    gboolean takes_view_id;
+    gboolean takes_output_id;
+    std::vector<gint64> latencies;
+    uint errors;
+};
 
-    g_variant_iter_init(&iter, tmp);
+struct bench_call_t
+{
+    bench_method_t* method;
+    gint64 start;
+};
 
-    while ((child = g_variant_iter_next_value(&iter)))
-    {
-        g_variant_iter_init(&iter2, child);
-        while ((cchild = g_variant_iter_next_value(&iter2)))
-        {
-            g_variant_get_child(cchild, 0, "i", &x);
-            g_variant_get_child(cchild, 1, "i", &y);
-            g_debug("view workspaces: %i %i", x, y);
-            workspaces.push_back(std::make_pair(x, y));
-        }
-    }
+static std::vector<bench_method_t> bench_methods;
+static std::vector<uint> bench_view_ids;
+static std::vector<uint> bench_output_ids;
+static uint bench_total_weight = 0;
+static gint64 bench_deadline;
+static int bench_in_flight = 0;
+static GMainLoop* bench_loop;
 
-    g_variant_unref(tmp);
+static std::pair<int, int>
+query_output_workspace (guint output_id)
+{
+    GError* error = NULL;
+    GVariant* tmp = NULL;
+    uint x = 0;
+    uint y = 0;
 
-    if (workspaces.size() == 0) {
-        g_warning("No workspaces found for view: %u", view_id);
-    }
+    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_output_workspace",
+                                 g_variant_new("(u)", output_id),
+                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    g_assert_no_error(error);
+    g_variant_get(tmp, "(uu)", &x, &y);
+    g_variant_unref(tmp);
 
-    return workspaces;
+    return std::pair<int, int>{x, y};
 }
 
 static uint
-query_view_output (guint view_id)
+query_active_output ()
 {
     GError* error = NULL;
     GVariant* tmp = NULL;
     uint value = 0;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_output",
-                                 g_variant_new("(u)", view_id),
+
+    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_active_output", NULL,
                                  G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
     g_assert_no_error(error);
     g_variant_get(tmp, "(u)", &value);
@@ -87,382 +112,776 @@ query_view_output (guint view_id)
     return value;
 }
 
-static int
-query_view_below_view (guint view_id)
+static gchar*
+query_view_app_id_xwayland_net_wm_name (uint view_id)
 {
+    GError* error = NULL;
     GVariant* tmp = NULL;
-    int value = 0;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_below_view",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL);
-    g_variant_get(tmp, "(i)", &value);
+    gchar* value = NULL;
+
+    tmp = g_dbus_proxy_call_sync(
+        proxy->gobj(), "query_view_app_id_xwayland_net_wm_name",
+        g_variant_new("(u)", view_id), G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    g_assert_no_error(error);
+    g_variant_get(tmp, "(s)", &value);
     g_variant_unref(tmp);
 
     return value;
 }
 
 static int
-query_view_above_view (guint view_id)
+query_view_xwayland_atom_cardinal (uint view_id, const char* val)
 {
+    GError* error = NULL;
     GVariant* tmp = NULL;
-    int value = 0;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_above_view",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL);
-    g_variant_get(tmp, "(i)", &value);
+    int value;
+
+    tmp =
+        g_dbus_proxy_call_sync(proxy->gobj(), "query_view_xwayland_atom_cardinal",
+                               g_variant_new("(us)", view_id, val),
+                               G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    g_assert_no_error(error);
+    g_variant_get(tmp, "(u)", &value);
     g_variant_unref(tmp);
 
     return value;
 }
 
-static gboolean
-query_view_minimized (guint view_id)
+static std::vector<uint>
+query_id_vector (const gchar* method_name)
 {
+    std::vector<uint> ids;
     GError* error = NULL;
     GVariant* tmp = NULL;
-    gboolean value;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_minimized",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    GVariantIter* iter;
+    uint id;
 
+    tmp = g_dbus_proxy_call_sync(proxy->gobj(), method_name, NULL,
+                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
     g_assert_no_error(error);
-    g_variant_get(tmp, "(b)", &value);
+    g_variant_get(tmp, "(au)", &iter);
+    while (g_variant_iter_next(iter, "u", &id))
+    {
+        ids.push_back(id);
+    }
+
+    g_variant_iter_free(iter);
     g_variant_unref(tmp);
 
-    return value;
+    return ids;
 }
 
-static gboolean
-query_view_maximized (guint view_id)
+static void
+print_view_data (const wfdbus::view_t& data)
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gboolean value;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_maximized",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    g_print("View Id:           %u\n", data.view_id);
+    g_print("App Id:            [%s, %s]\n", data.app_id.c_str(),
+            data.app_id_gtk.c_str());
+    g_print("Title:             %s\n", data.title.c_str());
+    if (data.role == 1) {
+        g_print("Role:              %s\n", "Toplevel Window");
+    }
+    else
+    if (data.role == 2)
+    {
+        g_print("Role:              %s\n", "Desktop Environment");
+    }
+    else
+    if (data.role == 3)
+    {
+        g_print("Role:              %s\n", "Unmanaged Window");
+    }
+    else
+    {
+        g_print("Role:              %s\n", "Unknown");
+    }
 
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(b)", &value);
-    g_variant_unref(tmp);
+    g_print("Group Leader:      %i\n", data.group_leader);
+    g_print("Process id:        %i\n", data.pid);
+    g_print("User id:           %u\n", data.uid);
+    g_print("Group id:          %u\n", data.gid);
+    g_print("Active:            %s\n", (data.active ? "True" : "False"));
+    g_print("Minimized:         %s\n", (data.minimized ? "True" : "False"));
+    g_print("Maximized:         %s\n", (data.maximized ? "True" : "False"));
+    g_print("Fullscreen:        %s\n", (data.fullscreened ? "True" : "False"));
+    g_print("Workspaces:        ");
 
-    return value;
+    for (const std::pair<int, int>& ws : data.workspaces)
+    {
+        g_print("[%i, %i]", ws.first, ws.second);
+    }
+
+    g_print("\n");
+    g_print("Output:            [%u] %s\n", data.output,
+            mirror->get_output_name(data.output).c_str());
+    g_print("Above this view:   [%i] %s\n", data.above_id,
+            (data.above_id != -1 ? data.above_app_id.c_str() : "None"));
+    g_print("Below this view:   [%i] %s\n", data.below_id,
+            (data.below_id != -1 ? data.below_app_id.c_str() : "None"));
+
+    if (data.xwid == 0) {
+        g_print("\n == This is a native wayland window ==\n");
+    }
+    else
+    {
+        g_print("\n == This is a xwayland window ==\n\n");
+        std::stringstream stream;
+        stream << std::hex << data.xwid;
+        std::string result("0x" + stream.str());
+        g_print("X Window id:       %s\n", result.c_str());
+        g_print("Run xwininfo -all -id %s and/or xprop -id %s for more "
+                "information.\n",
+                result.c_str(), result.c_str());
+    }
 }
 
-static gboolean
-query_view_fullscreen (guint view_id)
+/* The interface's introspection data, free with g_dbus_node_info_unref */
+static GDBusNodeInfo*
+introspect_node ()
 {
+    GDBusNodeInfo* node_info;
     GError* error = NULL;
-    GVariant* tmp = NULL;
-    gboolean value;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_fullscreen",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    GVariant* tmp;
+    const gchar* xml;
 
+    tmp = g_dbus_connection_call_sync(connection->gobj(), DBUS_ID, DBUS_PATH,
+                                      "org.freedesktop.DBus.Introspectable",
+                                      "Introspect", NULL, G_VARIANT_TYPE("(s)"),
+                                      G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    g_assert_no_error(error);
+    g_variant_get(tmp, "(&s)", &xml);
+    node_info = g_dbus_node_info_new_for_xml(xml, &error);
     g_assert_no_error(error);
-    g_variant_get(tmp, "(b)", &value);
     g_variant_unref(tmp);
 
-    return value;
+    return node_info;
 }
 
-static gchar*
-query_output_name (guint output_id)
+/*
+ * Parses the "method[:weight],..." mix and checks every method
+ * against the interface's introspection data.
+ */
+static gboolean
+bench_parse_mix (const gchar* mix)
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gchar* value = NULL;
+    GDBusNodeInfo* node_info;
+    GDBusInterfaceInfo* interface_info;
+    gchar** entries;
 
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_output_name",
-                                 g_variant_new("(u)", output_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(s)", &value);
-    g_variant_unref(tmp);
+    node_info = introspect_node();
+    interface_info = g_dbus_node_info_lookup_interface(node_info, DBUS_ID);
 
-    return value;
+    entries = g_strsplit(mix, ",", -1);
+    for (gchar** entry = entries; *entry; entry++)
+    {
+        gchar** parts = g_strsplit(*entry, ":", 2);
+        GDBusMethodInfo* method_info;
+        bench_method_t method;
+        guint n_args = 0;
+
+        method.name   = g_strstrip(parts[0]);
+        method.weight = parts[1] ? (uint)g_ascii_strtoull(parts[1], NULL, 10) : 1;
+        method.takes_view_id   = FALSE;
+        method.takes_output_id = FALSE;
+        method.errors = 0;
+        g_strfreev(parts);
+
+        method_info = interface_info ?
+            g_dbus_interface_info_lookup_method(interface_info,
+                                                method.name.c_str()) : NULL;
+        if (!method_info) {
+            g_printerr("bench: no such method: %s\n", method.name.c_str());
+            g_strfreev(entries);
+            g_dbus_node_info_unref(node_info);
+
+            return FALSE;
+        }
+
+        while (method_info->in_args && method_info->in_args[n_args])
+        {
+            n_args++;
+        }
+
+        if (n_args == 1 &&
+            (g_strcmp0(method_info->in_args[0]->signature, "u") == 0)) {
+            if (g_strcmp0(method_info->in_args[0]->name, "output_id") == 0) {
+                method.takes_output_id = TRUE;
+            }
+            else
+            {
+                method.takes_view_id = TRUE;
+            }
+        }
+        else
+        if (n_args != 0)
+        {
+            g_printerr("bench: %s takes arguments other than an id\n",
+                       method.name.c_str());
+            g_strfreev(entries);
+            g_dbus_node_info_unref(node_info);
+
+            return FALSE;
+        }
+
+        if (method.weight == 0) {
+            continue;
+        }
+
+        bench_total_weight += method.weight;
+        bench_methods.push_back(method);
+    }
+
+    g_strfreev(entries);
+    g_dbus_node_info_unref(node_info);
+
+    return !bench_methods.empty();
 }
 
-static std::pair<int, int>
-query_output_workspace (guint output_id)
+static void bench_issue_call ();
+
+static void
+bench_call_done (GObject* source, GAsyncResult* res, gpointer user_data)
 {
+    bench_call_t* call = (bench_call_t*)user_data;
     GError* error = NULL;
-    GVariant* tmp = NULL;
-    uint x = 0;
-    uint y = 0;
+    GVariant* tmp;
 
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_output_workspace",
-                                 g_variant_new("(u)", output_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(uu)", &x, &y);
-    g_variant_unref(tmp);
+    tmp = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+    call->method->latencies.push_back(g_get_monotonic_time() - call->start);
+    if (error) {
+        call->method->errors++;
+        g_error_free(error);
+    }
+    else
+    {
+        g_variant_unref(tmp);
+    }
 
-    return std::pair<int, int>{x, y};
+    delete call;
+    bench_in_flight--;
+
+    if (g_get_monotonic_time() < bench_deadline) {
+        bench_issue_call();
+    }
+    else
+    if (bench_in_flight == 0)
+    {
+        g_main_loop_quit(bench_loop);
+    }
 }
 
-static uint
-query_active_output ()
+static void
+bench_issue_call ()
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    uint value = 0;
+    uint pick = g_random_int_range(0, bench_total_weight);
+    bench_method_t* method = NULL;
+    GVariant* parameters   = NULL;
 
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_active_output", NULL,
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(u)", &value);
-    g_variant_unref(tmp);
+    for (bench_method_t& m : bench_methods)
+    {
+        if (pick < m.weight) {
+            method = &m;
+            break;
+        }
 
-    return value;
+        pick -= m.weight;
+    }
+
+    if (method->takes_view_id) {
+        parameters = g_variant_new("(u)",
+            bench_view_ids[g_random_int_range(0, bench_view_ids.size())]);
+    }
+    else
+    if (method->takes_output_id)
+    {
+        parameters = g_variant_new("(u)",
+            bench_output_ids[g_random_int_range(0, bench_output_ids.size())]);
+    }
+
+    bench_in_flight++;
+    g_dbus_proxy_call(proxy->gobj(), method->name.c_str(), parameters,
+                      G_DBUS_CALL_FLAGS_NONE, -1, NULL, bench_call_done,
+                      new bench_call_t{method, g_get_monotonic_time()});
 }
 
-static uint
-query_view_role (uint view_id)
+static double
+bench_percentile_ms (const std::vector<gint64>& sorted, double p)
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    uint value = 0;
-
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_role",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(u)", &value);
-    g_variant_unref(tmp);
+    if (sorted.empty()) {
+        return 0;
+    }
 
-    return value;
+    return sorted[(size_t)(p * (sorted.size() - 1) + 0.5)] / 1000.0;
 }
 
-static uint
-query_view_group_leader (uint view_id)
+static int
+run_bench ()
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    uint value;
+    gint64 start;
+    double elapsed;
+    uint64_t calls  = 0;
+    uint64_t errors = 0;
 
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_group_leader",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(u)", &value);
-    g_variant_unref(tmp);
+    if (!bench_parse_mix(bench_mix ? bench_mix : BENCH_DEFAULT_MIX)) {
+        return 1;
+    }
 
-    return value;
+    bench_callers = MAX(bench_callers, 1);
+
+    bench_view_ids   = query_id_vector("query_view_vector_taskman_ids");
+    bench_output_ids = query_id_vector("query_output_ids");
+    for (bench_method_t& method : bench_methods)
+    {
+        if ((method.takes_view_id && bench_view_ids.empty()) ||
+            (method.takes_output_id && bench_output_ids.empty())) {
+            g_printerr("bench: no views or outputs to call %s on\n",
+                       method.name.c_str());
+
+            return 1;
+        }
+    }
+
+    g_print("bench: %i callers for %i s, %zu views, %zu outputs\n",
+            bench_callers, bench_duration, bench_view_ids.size(),
+            bench_output_ids.size());
+
+    bench_loop = g_main_loop_new(NULL, FALSE);
+    start = g_get_monotonic_time();
+    bench_deadline = start + (gint64)bench_duration * G_USEC_PER_SEC;
+    for (int i = 0; i < bench_callers; i++)
+    {
+        bench_issue_call();
+    }
+
+    g_main_loop_run(bench_loop);
+    elapsed = (g_get_monotonic_time() - start) / (double)G_USEC_PER_SEC;
+
+    g_print("%-40s %9s %7s %9s %9s %9s\n", "method", "calls", "errors",
+            "p50 ms", "p95 ms", "p99 ms");
+    for (bench_method_t& method : bench_methods)
+    {
+        std::sort(method.latencies.begin(), method.latencies.end());
+        g_print("%-40s %9zu %7u %9.3f %9.3f %9.3f\n", method.name.c_str(),
+                method.latencies.size(), method.errors,
+                bench_percentile_ms(method.latencies, 0.50),
+                bench_percentile_ms(method.latencies, 0.95),
+                bench_percentile_ms(method.latencies, 0.99));
+        calls  += method.latencies.size();
+        errors += method.errors;
+    }
+
+    g_print("total: %lu calls in %.1f s, %.0f calls/s, %lu errors\n",
+            (unsigned long)calls, elapsed, calls / elapsed,
+            (unsigned long)errors);
+    g_main_loop_unref(bench_loop);
+
+    return errors ? 1 : 0;
 }
 
-static gchar*
-query_view_app_id (uint view_id)
+/*
+ * watch mode: the table is read from the mirror, which is filled
+ * once and from then on maintained from signals. Every signal is
+ * counted, per name and per app id.
+ */
+static std::map<std::string, uint64_t> watch_signal_counts;
+static std::map<std::string, uint64_t> watch_signal_counts_last;
+/* signals per app id, to see who floods the bus */
+static std::map<std::string, uint64_t> watch_app_counts;
+static gboolean watch_dirty = TRUE;
+static gint64 watch_last_redraw = 0;
+
+static void
+on_watch_signal (const gchar* signal_name, guint id, GVariant* parameters)
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gchar* value = NULL;
+    const wfdbus::view_t* view = mirror->find_view(id);
 
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_app_id",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(s)", &value);
-    g_variant_unref(tmp);
+    watch_signal_counts[signal_name]++;
+    watch_dirty = TRUE;
 
-    return value;
+    if (g_str_has_prefix(signal_name, "view_") && view) {
+        watch_app_counts[view->app_id]++;
+    }
 }
 
-static gchar*
-query_view_app_id_gtk_shell (uint view_id)
+static std::string
+watch_truncate (const std::string& value, size_t width)
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gchar* value = NULL;
-
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_app_id_gtk_shell",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(s)", &value);
-    g_variant_unref(tmp);
+    if (value.size() <= width) {
+        return value;
+    }
 
-    return value;
+    return value.substr(0, width - 1) + "~";
 }
 
-static gchar*
-query_view_app_id_xwayland_net_wm_name (uint view_id)
+static void
+watch_redraw ()
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gchar* value = NULL;
+    gint64 now = g_get_monotonic_time();
+    double elapsed = (now - watch_last_redraw) / (double)G_USEC_PER_SEC;
+    std::vector<std::pair<uint64_t, std::string>> apps;
+
+    watch_last_redraw = now;
+    watch_dirty = FALSE;
+
+    /* home and clear */
+    g_print("\033[H\033[2J");
+    g_print("%zu views, outputs:", mirror->get_views().size());
+    for (const std::pair<const guint, wfdbus::output_t>& output :
+         mirror->get_outputs())
+    {
+        g_print(" [%u] %s ws %i,%i", output.first, output.second.name.c_str(),
+                output.second.workspace_x, output.second.workspace_y);
+    }
 
-    tmp = g_dbus_proxy_call_sync(
-        proxy->gobj(), "query_view_app_id_xwayland_net_wm_name",
-        g_variant_new("(u)", view_id), G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(s)", &value);
-    g_variant_unref(tmp);
+    g_print("\n\n%-8s %-5s %-4s %-28s %s\n", "ID", "FLAGS", "OUT", "APP ID",
+            "TITLE");
+    for (const std::pair<const guint, wfdbus::view_t>& entry :
+         mirror->get_views())
+    {
+        const wfdbus::view_t& view = entry.second;
+        gchar flags [] = "----";
+
+        flags[0] = view.active ? 'A' : '-';
+        flags[1] = view.minimized ? 'm' : '-';
+        flags[2] = view.maximized ? 'M' : '-';
+        flags[3] = view.fullscreened ? 'F' : '-';
+        g_print("%-8u %-5s %-4u %-28s %s\n", view.view_id, flags, view.output,
+                watch_truncate(view.app_id, 28).c_str(),
+                watch_truncate(view.title, 60).c_str());
+    }
 
-    return value;
+    g_print("\n%-32s %10s %10s\n", "SIGNAL", "TOTAL", "PER SEC");
+    for (std::pair<const std::string, uint64_t>& count : watch_signal_counts)
+    {
+        uint64_t delta = count.second - watch_signal_counts_last[count.first];
+
+        g_print("%-32s %10lu %10.1f\n", count.first.c_str(),
+                (unsigned long)count.second, elapsed > 0 ? delta / elapsed : 0);
+        watch_signal_counts_last[count.first] = count.second;
+    }
+
+    for (std::pair<const std::string, uint64_t>& count : watch_app_counts)
+    {
+        apps.push_back({count.second, count.first});
+    }
+
+    std::sort(apps.rbegin(), apps.rend());
+    g_print("\n%-32s %10s\n", "TOP SIGNALLING APPS", "TOTAL");
+    for (size_t i = 0; i < apps.size() && i < 5; i++)
+    {
+        g_print("%-32s %10lu\n", watch_truncate(apps[i].second, 32).c_str(),
+                (unsigned long)apps[i].first);
+    }
 }
 
-static gchar*
-query_view_title (uint view_id)
+static gboolean
+watch_tick (gpointer user_data)
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gchar* value = NULL;
-
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_title",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(s)", &value);
-    g_variant_unref(tmp);
+    if (watch_dirty) {
+        watch_redraw();
+    }
 
-    return value;
+    return G_SOURCE_CONTINUE;
 }
 
 static int
-query_view_xwayland_atom_cardinal (uint view_id, const char* val)
+run_watch ()
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    int value;
+    GMainLoop* loop;
 
-    tmp =
-        g_dbus_proxy_call_sync(proxy->gobj(), "query_view_xwayland_atom_cardinal",
-                               g_variant_new("(us)", view_id, val),
-                               G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(u)", &value);
-    g_variant_unref(tmp);
+    mirror->set_signal_callback(on_watch_signal);
+    if (!mirror->sync()) {
+        g_printerr("watch: %s is not reachable\n", DBUS_ID);
 
-    return value;
-}
+        return 1;
+    }
 
-static gboolean
-query_view_active (guint view_id)
-{
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gboolean value;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_active",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    watch_last_redraw = g_get_monotonic_time();
+    watch_redraw();
+    g_timeout_add(MAX(watch_refresh_ms, 10), watch_tick, NULL);
 
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(b)", &value);
-    g_variant_unref(tmp);
+    loop = g_main_loop_new(NULL, FALSE);
+    g_main_loop_run(loop);
 
-    return value;
+    return 0;
 }
 
-static uint
-query_view_xwayland_wid (uint view_id)
+/*
+ * export mode: one JSON line with the current state, with --follow
+ * then one line per signal. Lines go through a fully buffered
+ * stdout that is flushed every EXPORT_FLUSH_MS, so high signal
+ * rates cost one write per batch rather than per event.
+ */
+#define EXPORT_FLUSH_MS 200
+
+static GDBusInterfaceInfo* export_interface_info = NULL;
+static guint64 export_sequence = 0;
+
+static void
+json_append_string (GString* out, const gchar* value)
 {
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    uint value = 0;
+    g_string_append_c(out, '"');
+    for (const gchar* c = value; *c; c++)
+    {
+        switch (*c)
+        {
+          case '"':
+            g_string_append(out, "\\\"");
+            break;
 
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_xwayland_wid",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(u)", &value);
-    g_variant_unref(tmp);
+          case '\\':
+            g_string_append(out, "\\\\");
+            break;
 
-    return value;
+          case '\n':
+            g_string_append(out, "\\n");
+            break;
+
+          case '\t':
+            g_string_append(out, "\\t");
+            break;
+
+          default:
+            if ((guchar)*c < 0x20) {
+                g_string_append_printf(out, "\\u%04x", (guchar)*c);
+            }
+            else
+            {
+                g_string_append_c(out, *c);
+            }
+        }
+    }
+
+    g_string_append_c(out, '"');
 }
 
 static void
-print_view_data (guint view_id)
+json_append_variant (GString* out, GVariant* value)
 {
-    // XXX: is there any point to free memory in such a short lived program?
-    gchar* app_id = query_view_app_id(view_id);
-    gchar* app_id_gtk = query_view_app_id_gtk_shell(view_id);
-    gchar* title = query_view_title(view_id);
-    gboolean minimized = query_view_minimized(view_id);
-    gboolean maximized = query_view_maximized(view_id);
-    gboolean fullscreened = query_view_fullscreen(view_id);
-    gboolean active = query_view_active(view_id);
-    guint above_id = query_view_above_view(view_id);
-    guint below_id = query_view_below_view(view_id);
-    gchar* above_app_id = query_view_app_id(above_id);
-    gchar* below_app_id = query_view_app_id(below_id);
-    guint output = query_view_output(view_id);
-    gchar* output_name = query_output_name(output);
-    guint xwid = query_view_xwayland_wid(view_id);
-    guint role = query_view_role(view_id);
-    guint group_leader = query_view_group_leader(view_id);
-
-    std::vector<std::pair<int, int>> workspaces = query_view_workspaces(view_id);
-    GError* error = NULL;
-    GVariant* tmp = NULL;
-    gint pid;
-    guint uid;
-    guint gid;
-    tmp = g_dbus_proxy_call_sync(proxy->gobj(), "query_view_credentials",
-                                 g_variant_new("(u)", view_id),
-                                 G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-    g_assert_no_error(error);
-    g_variant_get(tmp, "(iuu)", &pid, &uid, &gid);
-    g_variant_unref(tmp);
-
-    g_print("View Id:           %u\n", view_id);
-    g_print("App Id:            [%s, %s]\n", app_id, app_id_gtk);
-    g_print("Title:             %s\n", title);
-    if (role == 1) {
-        g_print("Role:              %s\n", "Toplevel Window");
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
+        json_append_string(out, g_variant_get_string(value, NULL));
     }
     else
-    if (role == 2)
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN))
     {
-        g_print("Role:              %s\n", "Desktop Environment");
+        g_string_append(out, g_variant_get_boolean(value) ? "true" : "false");
     }
     else
-    if (role == 3)
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT32))
     {
-        g_print("Role:              %s\n", "Unmanaged Window");
+        g_string_append_printf(out, "%u", g_variant_get_uint32(value));
     }
     else
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT32))
     {
-        g_print("Role:              %s\n", "Unknown");
+        g_string_append_printf(out, "%i", g_variant_get_int32(value));
     }
+    else
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_DOUBLE))
+    {
+        g_string_append_printf(out, "%.17g", g_variant_get_double(value));
+    }
+    else
+    if (g_variant_is_container(value))
+    {
+        gsize n = g_variant_n_children(value);
 
-    g_print("Group Leader:      %i\n", group_leader);
-    g_print("Process id:        %i\n", pid);
-    g_print("User id:           %u\n", uid);
-    g_print("Group id:          %u\n", gid);
-    g_print("Active:            %s\n", (active ? "True" : "False"));
-    g_print("Minimized:         %s\n", (minimized ? "True" : "False"));
-    g_print("Maximized:         %s\n", (maximized ? "True" : "False"));
-    g_print("Fullscreen:        %s\n", (fullscreened ? "True" : "False"));
-    g_print("Workspaces:        ");
+        g_string_append_c(out, '[');
+        for (gsize i = 0; i < n; i++)
+        {
+            GVariant* child = g_variant_get_child_value(value, i);
+
+            if (i > 0) {
+                g_string_append_c(out, ',');
+            }
+
+            json_append_variant(out, child);
+            g_variant_unref(child);
+        }
 
-    for (auto it = workspaces.begin(); it != workspaces.end(); ++it)
+        g_string_append_c(out, ']');
+    }
+    else
     {
-        std::pair<int, int> ws = *it;
-        g_print("[%i, %i]", ws.first, ws.second);
+        gchar* printed = g_variant_print(value, FALSE);
+
+        json_append_string(out, printed);
+        g_free(printed);
     }
+}
 
-    g_print("\n");
-    g_print("Output:            [%u] %s\n", output, output_name);
-    g_print("Above this view:   [%i] %s\n", above_id,
-            (above_id != -1 ? above_app_id : "None"));
-    g_print("Below this view:   [%i] %s\n", below_id,
-            (below_id != -1 ? below_app_id : "None"));
+static void
+export_write_line (GString* line)
+{
+    g_string_append_c(line, '\n');
+    fwrite(line->str, 1, line->len, stdout);
+    g_string_free(line, TRUE);
+}
 
-    if (xwid == 0) {
-        g_print("\n == This is a native wayland window ==\n");
+static GString*
+export_begin_line (const gchar* type)
+{
+    GString* line = g_string_new("{\"type\":");
+
+    json_append_string(line, type);
+    g_string_append_printf(line, ",\"seq\":%" G_GUINT64_FORMAT
+                                 ",\"time_us\":%" G_GINT64_FORMAT,
+                           export_sequence++, g_get_real_time());
+
+    return line;
+}
+
+static void
+export_snapshot ()
+{
+    GString* line;
+    bool first = true;
+
+    line = export_begin_line("snapshot");
+    g_string_append(line, ",\"views\":[");
+    for (const std::pair<const guint, wfdbus::view_t>& entry :
+         mirror->get_views())
+    {
+        const wfdbus::view_t& view = entry.second;
+
+        g_string_append_printf(line, "%s{\"id\":%u,\"app_id\":",
+                               first ? "" : ",", view.view_id);
+        json_append_string(line, view.app_id.c_str());
+        g_string_append(line, ",\"title\":");
+        json_append_string(line, view.title.c_str());
+        g_string_append_printf(line,
+                               ",\"role\":%u,\"pid\":%i,\"active\":%s"
+                               ",\"minimized\":%s,\"maximized\":%s"
+                               ",\"fullscreen\":%s,\"output\":%u"
+                               ",\"xwayland_wid\":%u,\"workspaces\":[",
+                               view.role, view.pid,
+                               view.active ? "true" : "false",
+                               view.minimized ? "true" : "false",
+                               view.maximized ? "true" : "false",
+                               view.fullscreened ? "true" : "false",
+                               view.output, view.xwid);
+        for (size_t i = 0; i < view.workspaces.size(); i++)
+        {
+            g_string_append_printf(line, "%s[%i,%i]", i ? "," : "",
+                                   view.workspaces[i].first,
+                                   view.workspaces[i].second);
+        }
+
+        g_string_append(line, "]}");
+        first = false;
     }
-    else
+
+    g_string_append(line, "],\"outputs\":[");
+    first = true;
+    for (const std::pair<const guint, wfdbus::output_t>& output :
+         mirror->get_outputs())
     {
-        g_print("\n == This is a xwayland window ==\n\n");
-        std::stringstream stream;
-        stream << std::hex << xwid;
-        std::string result("0x" + stream.str());
-        g_print("X Window id:       %s\n", result.c_str());
-        g_print("Run xwininfo -all -id %s and/or xprop -id %s for more "
-                "information.\n",
-                result.c_str(), result.c_str());
+        g_string_append_printf(line, "%s{\"id\":%u,\"name\":", first ? "" : ",",
+                               output.first);
+        json_append_string(line, output.second.name.c_str());
+        g_string_append_printf(line, ",\"workspace\":[%i,%i]}",
+                               output.second.workspace_x,
+                               output.second.workspace_y);
+        first = false;
+    }
+
+    g_string_append(line, "]}");
+    export_write_line(line);
+}
+
+static void
+on_export_signal (const gchar* signal_name, guint id, GVariant* parameters)
+{
+    GDBusSignalInfo* signal_info = NULL;
+    GString* line;
+    gsize n = g_variant_n_children(parameters);
+    gsize n_named = 0;
+
+    if (export_interface_info) {
+        signal_info = g_dbus_interface_info_lookup_signal(export_interface_info,
+                                                          signal_name);
+    }
+
+    while (signal_info && signal_info->args && signal_info->args[n_named])
+    {
+        n_named++;
+    }
+
+    line = export_begin_line("signal");
+    g_string_append(line, ",\"signal\":");
+    json_append_string(line, signal_name);
+    g_string_append(line, ",\"args\":{");
+    for (gsize i = 0; i < n; i++)
+    {
+        GVariant* child = g_variant_get_child_value(parameters, i);
+        const gchar* arg_name = NULL;
+        gchar fallback [16];
+
+        /* names from the introspection data, positional otherwise */
+        if (i < n_named) {
+            arg_name = signal_info->args[i]->name;
+        }
+        else
+        {
+            g_snprintf(fallback, sizeof(fallback), "arg%zu", i);
+            arg_name = fallback;
+        }
+
+        g_string_append(line, i ? "," : "");
+        json_append_string(line, arg_name);
+        g_string_append_c(line, ':');
+        json_append_variant(line, child);
+        g_variant_unref(child);
+    }
+
+    g_string_append(line, "}}");
+    export_write_line(line);
+}
+
+static gboolean
+export_flush (gpointer user_data)
+{
+    fflush(stdout);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static int
+run_export ()
+{
+    GDBusNodeInfo* node_info = NULL;
+    GMainLoop* loop;
+
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+
+    if (!mirror->sync()) {
+        g_printerr("export: %s is not reachable\n", DBUS_ID);
+
+        return 1;
+    }
+
+    /*
+     * Signals that came in during sync() are part of the snapshot,
+     * the stream starts right after it.
+     */
+    export_snapshot();
+    fflush(stdout);
+    if (!export_follow) {
+        return 0;
     }
+
+    node_info = introspect_node();
+    if (node_info) {
+        export_interface_info =
+            g_dbus_node_info_lookup_interface(node_info, DBUS_ID);
+    }
+
+    mirror->set_signal_callback(on_export_signal);
+    g_timeout_add(EXPORT_FLUSH_MS, export_flush, NULL);
+    loop = g_main_loop_new(NULL, FALSE);
+    g_main_loop_run(loop);
+
+    return 0;
 }
 
 static void
@@ -471,9 +890,11 @@ on_signal (GDBusConnection* connection, const gchar* sender_name,
            const gchar* signal_name, GVariant* parameters,
            gpointer user_data)
 {
+    const wfdbus::view_t* view;
     uint view_id;
     g_variant_get(parameters, "(u)", &view_id);
-    uint _tmp = query_view_role(view_id);
+    view = mirror->fetch_view(view_id);
+    uint _tmp = view ? view->role : 0;
 
     if ((_tmp != 1) && (_tmp != 2))
     {
@@ -486,7 +907,7 @@ on_signal (GDBusConnection* connection, const gchar* sender_name,
     g_dbus_proxy_call_sync(proxy->gobj(), "enable_property_mode",
                            g_variant_new("(b)", FALSE), G_DBUS_CALL_FLAGS_NONE,
                            -1, NULL, NULL);
-    print_view_data(view_id);
+    print_view_data(*view);
     exit(0);
 }
 
@@ -494,6 +915,21 @@ static GOptionEntry entries [] = {
     {"list", 'l', 0, G_OPTION_ARG_NONE, &list,
         "List taskmanager related entries and exit",
         NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_INT, &bench_duration,
+        "bench: seconds to run (default 10)",
+        "SECONDS"},
+    {"callers", 'c', 0, G_OPTION_ARG_INT, &bench_callers,
+        "bench: concurrent callers (default 8)",
+        "M"},
+    {"mix", 'm', 0, G_OPTION_ARG_STRING, &bench_mix,
+        "bench: comma separated method[:weight] list",
+        "MIX"},
+    {"refresh", 'r', 0, G_OPTION_ARG_INT, &watch_refresh_ms,
+        "watch: minimum milliseconds between redraws (default 250)",
+        "MS"},
+    {"follow", 'f', 0, G_OPTION_ARG_NONE, &export_follow,
+        "export: stream one line per signal after the snapshot",
+        NULL},
     {NULL}
 };
 
@@ -504,7 +940,7 @@ main (int argc, char* argv [])
     GOptionContext* context;
     GMainLoop* loop;
 
-    context = g_option_context_new("- get window properties");
+    context = g_option_context_new("[list|bench|watch|export] - get window properties");
     g_option_context_add_main_entries(context, entries, NULL);
 
     if (!g_option_context_parse(context, &argc, &argv, &error)) {
@@ -538,31 +974,36 @@ main (int argc, char* argv [])
         return false;
     }
 
+    mirror = new wfdbus::mirror_t(connection->gobj());
+
     for (char** arg = argv; *arg; arg++)
     {
+        if (g_strcmp0(*arg, "bench") == 0) {
+            exit(run_bench());
+        }
+
+        if (g_strcmp0(*arg, "watch") == 0) {
+            exit(run_watch());
+        }
+
+        if (g_strcmp0(*arg, "export") == 0) {
+            exit(run_export());
+        }
+
         if ((g_strcmp0(*arg, "l") == 0) || (g_strcmp0(*arg, "list") == 0)) {
-            GVariant* value;
             GError* error = NULL;
 
-            value = g_dbus_proxy_call_sync(proxy->gobj(),
-                                           "query_view_vector_taskman_ids", NULL,
-                                           G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-            g_assert_no_error(error);
-            GVariantIter iter;
-            GVariantIter iter2;
-            GVariant* child;
-            GVariant* cchild;
+            if (!mirror->sync()) {
+                g_printerr("list: %s is not reachable\n", DBUS_ID);
+                exit(1);
+            }
 
-            g_variant_iter_init(&iter, value);
-            while ((child = g_variant_iter_next_value(&iter)))
+            for (const std::pair<const guint, wfdbus::view_t>& entry :
+                 mirror->get_views())
             {
-                g_variant_iter_init(&iter2, child);
-                while ((cchild = g_variant_iter_next_value(&iter2)))
-                {
-                    g_print("***************************************\n");
-                    print_view_data(g_variant_get_uint32(cchild));
-                    g_print("***************************************\n\n");
-                }
+                g_print("***************************************\n");
+                print_view_data(entry.second);
+                g_print("***************************************\n\n");
             }
 
             g_dbus_proxy_call_sync(proxy->gobj(), "enable_property_mode",
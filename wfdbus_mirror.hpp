@@ -0,0 +1,816 @@
+/*******************************************************************
+ * This file is licensed under the MIT license.
+ *
+ * wfdbus_mirror.hpp -- header only client for org.wayland.compositor
+ * that keeps an in-process mirror of the views and outputs.
+ *
+ * sync() subscribes to the interface's signals and then fills the
+ * mirror: two id lists, the per view and per output properties as
+ * pipelined async calls (at most MIRROR_MAX_IN_FLIGHT outstanding),
+ * output names are resolved locally instead of per view. From then
+ * on the mirror is kept current from the signals, which carry the
+ * new value for almost everything; only signals without data
+ * (view_added, view_workspaces_changed, output_added) cause
+ * targeted calls. Reads never touch the bus.
+ *
+ * Signals and replies of one connection arrive in the order the
+ * service sent them, so applying both as they come in is
+ * consistent: a reply is never older than a signal before it.
+ *
+ * Everything runs on the thread default main context of the thread
+ * that created the mirror, which has to be iterated to receive
+ * signals (sync() and fetch_view() iterate it themselves).
+ *
+ * The interface has no signal for restacking, above_id / below_id
+ * and their app ids are as of the last fetch, refresh_stacking()
+ * fetches them again.
+ ********************************************************************/
+
+#ifndef WFDBUS_MIRROR_HPP
+#define WFDBUS_MIRROR_HPP
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define MIRROR_MAX_IN_FLIGHT 64
+
+namespace wfdbus
+{
+static const gchar* const BUS_NAME    = "org.wayland.compositor";
+static const gchar* const OBJECT_PATH = "/org/wayland/compositor";
+static const gchar* const INTERFACE   = "org.wayland.compositor";
+
+/* roles as query_view_role reports them */
+static const guint VIEW_ROLE_TOPLEVEL = 1;
+
+struct view_t
+{
+    guint view_id = 0;
+    std::string app_id;
+    std::string app_id_gtk;
+    std::string title;
+    gboolean minimized    = FALSE;
+    gboolean maximized    = FALSE;
+    gboolean fullscreened = FALSE;
+    gboolean active = FALSE;
+    /* as of the last fetch, see refresh_stacking() */
+    gint above_id   = -1;
+    gint below_id   = -1;
+    std::string above_app_id;
+    std::string below_app_id;
+    guint output = 0;
+    guint xwid   = 0;
+    guint role   = 0;
+    guint group_leader = 0;
+    std::vector<std::pair<int, int>> workspaces;
+    gint pid  = 0;
+    guint uid = 0;
+    guint gid = 0;
+};
+
+struct output_t
+{
+    guint output_id = 0;
+    std::string name;
+    int workspace_x = 0;
+    int workspace_y = 0;
+};
+
+class mirror_t
+{
+  public:
+    /***
+     * Called for every signal of the interface after the mirror has
+     * applied it. id is the view or output id the signal is about,
+     * 0 for signals without one.
+     ***/
+    typedef std::function<void (const gchar* signal_name, guint id,
+                                GVariant* parameters)> signal_callback_t;
+
+    mirror_t (GDBusConnection* connection)
+    {
+        this->connection = (GDBusConnection*)g_object_ref(connection);
+    }
+
+    ~mirror_t ()
+    {
+        if (subscription_id) {
+            g_dbus_connection_signal_unsubscribe(connection, subscription_id);
+        }
+
+        /* replies still in flight find no mirror and are dropped */
+        for (call_t* call : in_flight)
+        {
+            call->owner = nullptr;
+        }
+
+        for (call_t& call : queue)
+        {
+            g_variant_unref(call.parameters);
+        }
+
+        g_object_unref(connection);
+    }
+
+    mirror_t (const mirror_t&) = delete;
+    mirror_t& operator = (const mirror_t&) = delete;
+
+    void
+    set_signal_callback (signal_callback_t callback)
+    {
+        signal_callback = callback;
+    }
+
+    /***
+     * Subscribes and fills the mirror with the mapped toplevels
+     * (what query_view_vector_taskman_ids returns) and all outputs.
+     * Blocks until every reply is in. Returns false if the
+     * service is not reachable.
+     ***/
+    bool
+    sync ()
+    {
+        std::vector<guint> view_ids;
+        std::vector<guint> output_ids;
+
+        subscribe();
+        if (!call_id_list("query_view_vector_taskman_ids", &view_ids) ||
+            !call_id_list("query_output_ids", &output_ids)) {
+            return false;
+        }
+
+        for (guint output_id : output_ids)
+        {
+            outputs[output_id].output_id = output_id;
+            queue_output_data(output_id);
+        }
+
+        for (guint view_id : view_ids)
+        {
+            views[view_id].view_id = view_id;
+            queue_view_data(view_id);
+        }
+
+        wait();
+
+        return true;
+    }
+
+    /***
+     * Fetches one view of any role into the mirror, whether it is
+     * a mapped toplevel or not, and blocks until it is complete.
+     ***/
+    const view_t*
+    fetch_view (guint view_id)
+    {
+        subscribe();
+        views[view_id].view_id = view_id;
+        queue_view_data(view_id);
+        wait();
+
+        return find_view(view_id);
+    }
+
+    /* Fetches above_id / below_id and their app ids for all views */
+    void
+    refresh_stacking ()
+    {
+        for (std::pair<const guint, view_t>& view : views)
+        {
+            queue_stacking(view.first);
+        }
+
+        wait();
+    }
+
+    const view_t*
+    find_view (guint view_id) const
+    {
+        std::map<guint, view_t>::const_iterator it = views.find(view_id);
+
+        return (it != views.end()) ? &it->second : nullptr;
+    }
+
+    const output_t*
+    find_output (guint output_id) const
+    {
+        std::map<guint, output_t>::const_iterator it = outputs.find(output_id);
+
+        return (it != outputs.end()) ? &it->second : nullptr;
+    }
+
+    const std::map<guint, view_t>&
+    get_views () const
+    {
+        return views;
+    }
+
+    const std::map<guint, output_t>&
+    get_outputs () const
+    {
+        return outputs;
+    }
+
+    /* the name of output_id, "" if it is not known */
+    std::string
+    get_output_name (guint output_id) const
+    {
+        const output_t* output = find_output(output_id);
+
+        return output ? output->name : "";
+    }
+
+    /* D-Bus calls made and failed so far, signals received */
+    uint64_t
+    get_call_count () const
+    {
+        return call_count;
+    }
+
+    uint64_t
+    get_error_count () const
+    {
+        return error_count;
+    }
+
+    uint64_t
+    get_signal_count () const
+    {
+        return signal_count;
+    }
+
+  private:
+    typedef void (*reply_handler_t)(mirror_t* mirror, guint id, GVariant* reply);
+
+    struct call_t
+    {
+        mirror_t* owner;
+        guint id;
+        const gchar* method_name;
+        GVariant* parameters;
+        reply_handler_t handler;
+    };
+
+    GDBusConnection* connection;
+    guint subscription_id = 0;
+    signal_callback_t signal_callback;
+    std::map<guint, view_t> views;
+    std::map<guint, output_t> outputs;
+    std::deque<call_t> queue;
+    std::vector<call_t*> in_flight;
+    uint64_t call_count   = 0;
+    uint64_t error_count  = 0;
+    uint64_t signal_count = 0;
+
+    void
+    subscribe ()
+    {
+        if (subscription_id) {
+            return;
+        }
+
+        subscription_id = g_dbus_connection_signal_subscribe(connection,
+            BUS_NAME, INTERFACE, nullptr, OBJECT_PATH, nullptr,
+            G_DBUS_SIGNAL_FLAGS_NONE, on_signal, this, nullptr);
+    }
+
+    bool
+    call_id_list (const gchar* method_name, std::vector<guint>* ids)
+    {
+        GVariantIter* iter;
+        GVariant* reply;
+        guint id;
+
+        call_count++;
+        reply = g_dbus_connection_call_sync(connection, BUS_NAME, OBJECT_PATH,
+                                            INTERFACE, method_name, nullptr,
+                                            G_VARIANT_TYPE("(au)"),
+                                            G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+                                            nullptr);
+        if (!reply) {
+            error_count++;
+
+            return false;
+        }
+
+        g_variant_get(reply, "(au)", &iter);
+        while (g_variant_iter_next(iter, "u", &id))
+        {
+            ids->push_back(id);
+        }
+
+        g_variant_iter_free(iter);
+        g_variant_unref(reply);
+
+        return true;
+    }
+
+    /************************* Call pipeline ************************/
+    static void
+    call_done (GObject* source, GAsyncResult* res, gpointer user_data)
+    {
+        call_t* call = (call_t*)user_data;
+        mirror_t* mirror = call->owner;
+        GVariant* reply;
+
+        reply = g_dbus_connection_call_finish((GDBusConnection*)source, res,
+                                              nullptr);
+        if (mirror) {
+            mirror->in_flight.erase(std::find(mirror->in_flight.begin(),
+                                              mirror->in_flight.end(), call));
+            if (reply) {
+                call->handler(mirror, call->id, reply);
+            }
+            else
+            {
+                /* the view / output is gone, its signal follows */
+                mirror->error_count++;
+            }
+
+            mirror->pump();
+        }
+
+        if (reply) {
+            g_variant_unref(reply);
+        }
+
+        delete call;
+    }
+
+    void
+    pump ()
+    {
+        while (!queue.empty() && (in_flight.size() < MIRROR_MAX_IN_FLIGHT))
+        {
+            call_t* call = new call_t(queue.front());
+
+            queue.pop_front();
+            in_flight.push_back(call);
+            call_count++;
+            g_dbus_connection_call(connection, BUS_NAME, OBJECT_PATH, INTERFACE,
+                                   call->method_name, call->parameters, nullptr,
+                                   G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+                                   call_done, call);
+            g_variant_unref(call->parameters);
+        }
+    }
+
+    void
+    queue_call (guint id, const gchar* method_name, GVariant* parameters,
+                reply_handler_t handler)
+    {
+        queue.push_back({this, id, method_name, g_variant_ref_sink(parameters),
+            handler});
+        pump();
+    }
+
+    void
+    wait ()
+    {
+        GMainContext* context = g_main_context_ref_thread_default();
+
+        while (!queue.empty() || !in_flight.empty())
+        {
+            g_main_context_iteration(context, TRUE);
+        }
+
+        g_main_context_unref(context);
+    }
+
+    /* the view the reply belongs to, nullptr if it closed meanwhile */
+    view_t*
+    lookup_view (guint view_id)
+    {
+        std::map<guint, view_t>::iterator it = views.find(view_id);
+
+        return (it != views.end()) ? &it->second : nullptr;
+    }
+
+    static std::string
+    get_string_reply (GVariant* reply)
+    {
+        const gchar* value;
+
+        g_variant_get(reply, "(&s)", &value);
+
+        return value;
+    }
+
+    void
+    queue_output_data (guint output_id)
+    {
+        /* shared by the calls, see queue_view_state */
+        GVariant* id = g_variant_ref_sink(g_variant_new("(u)", output_id));
+
+        queue_call(output_id, "query_output_name", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (m->outputs.count(id)) {
+                m->outputs[id].name = get_string_reply(v);
+            }
+        });
+        queue_call(output_id, "query_output_workspace", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            guint x, y;
+
+            g_variant_get(v, "(uu)", &x, &y);
+            if (m->outputs.count(id)) {
+                m->outputs[id].workspace_x = x;
+                m->outputs[id].workspace_y = y;
+            }
+        });
+        g_variant_unref(id);
+    }
+
+    void
+    queue_workspaces (guint view_id)
+    {
+        queue_call(view_id, "query_view_workspaces",
+                   g_variant_new("(u)", view_id),
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            view_t* view = m->lookup_view(id);
+            GVariantIter* iter;
+            int x, y;
+
+            if (!view) {
+                return;
+            }
+
+            view->workspaces.clear();
+            g_variant_get(v, "(a(ii))", &iter);
+            while (g_variant_iter_next(iter, "(ii)", &x, &y))
+            {
+                view->workspaces.push_back(std::make_pair(x, y));
+            }
+
+            g_variant_iter_free(iter);
+        });
+    }
+
+    /* app id of the neighbour, from the mirror if it is in there */
+    static void
+    resolve_neighbour (mirror_t* m, guint view_id, gint neighbour_id,
+                       bool above)
+    {
+        const view_t* neighbour;
+
+        if (neighbour_id == -1) {
+            return;
+        }
+
+        neighbour = m->find_view(neighbour_id);
+        if (neighbour && !neighbour->app_id.empty()) {
+            view_t* view = m->lookup_view(view_id);
+
+            (above ? view->above_app_id : view->below_app_id) = neighbour->app_id;
+
+            return;
+        }
+
+        if (above) {
+            m->queue_call(view_id, "query_view_app_id",
+                          g_variant_new("(u)", neighbour_id),
+                          [] (mirror_t* m, guint id, GVariant* v)
+            {
+                if (view_t* view = m->lookup_view(id)) {
+                    view->above_app_id = get_string_reply(v);
+                }
+            });
+        }
+        else
+        {
+            m->queue_call(view_id, "query_view_app_id",
+                          g_variant_new("(u)", neighbour_id),
+                          [] (mirror_t* m, guint id, GVariant* v)
+            {
+                if (view_t* view = m->lookup_view(id)) {
+                    view->below_app_id = get_string_reply(v);
+                }
+            });
+        }
+    }
+
+    void
+    queue_stacking (guint view_id)
+    {
+        /* shared by the calls, see queue_view_state */
+        GVariant* id = g_variant_ref_sink(g_variant_new("(u)", view_id));
+
+        queue_call(view_id, "query_view_above_view", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            view_t* view = m->lookup_view(id);
+
+            if (view) {
+                g_variant_get(v, "(i)", &view->above_id);
+                view->above_app_id.clear();
+                resolve_neighbour(m, id, view->above_id, true);
+            }
+        });
+        queue_call(view_id, "query_view_below_view", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            view_t* view = m->lookup_view(id);
+
+            if (view) {
+                g_variant_get(v, "(i)", &view->below_id);
+                view->below_app_id.clear();
+                resolve_neighbour(m, id, view->below_id, false);
+            }
+        });
+        g_variant_unref(id);
+    }
+
+    void
+    queue_app_id (guint view_id)
+    {
+        /* shared by the calls, see queue_view_state */
+        GVariant* id = g_variant_ref_sink(g_variant_new("(u)", view_id));
+
+        queue_call(view_id, "query_view_app_id", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                view->app_id = get_string_reply(v);
+            }
+        });
+        queue_call(view_id, "query_view_app_id_gtk_shell", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                view->app_id_gtk = get_string_reply(v);
+            }
+        });
+        g_variant_unref(id);
+    }
+
+    /* everything but the role, see queue_view_data */
+    void
+    queue_view_state (guint view_id)
+    {
+        /***
+         * The same parameters go into every call, held here until all
+         * are queued: a call sent right away may drop its ref first.
+         ***/
+        GVariant* id = g_variant_ref_sink(g_variant_new("(u)", view_id));
+
+        queue_app_id(view_id);
+        queue_call(view_id, "query_view_title", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                view->title = get_string_reply(v);
+            }
+        });
+        queue_call(view_id, "query_view_minimized", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(b)", &view->minimized);
+            }
+        });
+        queue_call(view_id, "query_view_maximized", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(b)", &view->maximized);
+            }
+        });
+        queue_call(view_id, "query_view_fullscreen", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(b)", &view->fullscreened);
+            }
+        });
+        queue_call(view_id, "query_view_active", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(b)", &view->active);
+            }
+        });
+        queue_call(view_id, "query_view_output", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(u)", &view->output);
+            }
+        });
+        queue_call(view_id, "query_view_xwayland_wid", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(u)", &view->xwid);
+            }
+        });
+        queue_call(view_id, "query_view_group_leader", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(u)", &view->group_leader);
+            }
+        });
+        queue_call(view_id, "query_view_credentials", id,
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(iuu)", &view->pid, &view->uid, &view->gid);
+            }
+        });
+        g_variant_unref(id);
+        queue_workspaces(view_id);
+        queue_stacking(view_id);
+    }
+
+    void
+    queue_view_data (guint view_id)
+    {
+        queue_call(view_id, "query_view_role", g_variant_new("(u)", view_id),
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            if (view_t* view = m->lookup_view(id)) {
+                g_variant_get(v, "(u)", &view->role);
+            }
+        });
+        queue_view_state(view_id);
+    }
+
+    /***
+     * A view announced by view_added: only its role is asked for,
+     * the rest only if it is a toplevel the mirror tracks.
+     ***/
+    void
+    queue_added_view (guint view_id)
+    {
+        queue_call(view_id, "query_view_role", g_variant_new("(u)", view_id),
+                   [] (mirror_t* m, guint id, GVariant* v)
+        {
+            view_t* view = m->lookup_view(id);
+
+            if (!view) {
+                return;
+            }
+
+            g_variant_get(v, "(u)", &view->role);
+            if (view->role != VIEW_ROLE_TOPLEVEL) {
+                m->views.erase(id);
+
+                return;
+            }
+
+            m->queue_view_state(id);
+        });
+    }
+
+    /************************* Signals ************************/
+    static void
+    on_signal (GDBusConnection* connection, const gchar* sender_name,
+               const gchar* object_path, const gchar* interface_name,
+               const gchar* signal_name, GVariant* parameters,
+               gpointer user_data)
+    {
+        mirror_t* mirror = (mirror_t*)user_data;
+        guint id = 0;
+
+        /* view and output signals start with the id */
+        if (g_str_has_prefix(g_variant_get_type_string(parameters), "(u")) {
+            g_variant_get_child(parameters, 0, "u", &id);
+        }
+
+        mirror->signal_count++;
+        mirror->apply_signal(signal_name, id, parameters);
+        if (mirror->signal_callback) {
+            mirror->signal_callback(signal_name, id, parameters);
+        }
+    }
+
+    void
+    apply_signal (const gchar* signal_name, guint id, GVariant* parameters)
+    {
+        view_t* view = lookup_view(id);
+
+        if (g_strcmp0(signal_name, "view_added") == 0) {
+            if (!view) {
+                views[id].view_id = id;
+                queue_added_view(id);
+            }
+        }
+        else
+        if (g_strcmp0(signal_name, "view_closed") == 0)
+        {
+            views.erase(id);
+        }
+        else
+        if (g_strcmp0(signal_name, "output_added") == 0)
+        {
+            if (!outputs.count(id)) {
+                outputs[id].output_id = id;
+                queue_output_data(id);
+            }
+        }
+        else
+        if (g_strcmp0(signal_name, "output_removed") == 0)
+        {
+            outputs.erase(id);
+        }
+        else
+        if (g_strcmp0(signal_name, "output_workspace_changed") == 0)
+        {
+            if (outputs.count(id)) {
+                g_variant_get(parameters, "(uii)", &id,
+                              &outputs[id].workspace_x,
+                              &outputs[id].workspace_y);
+            }
+        }
+        else
+        if (!view)
+        {
+            return;
+        }
+        else
+        if (g_strcmp0(signal_name, "view_app_id_changed") == 0)
+        {
+            const gchar* value;
+
+            g_variant_get(parameters, "(u&s)", &id, &value);
+            view->app_id = value;
+            /* the gtk-shell id is not in the signal */
+            queue_call(id, "query_view_app_id_gtk_shell",
+                       g_variant_new("(u)", id),
+                       [] (mirror_t* m, guint id, GVariant* v)
+            {
+                if (view_t* view = m->lookup_view(id)) {
+                    view->app_id_gtk = get_string_reply(v);
+                }
+            });
+        }
+        else
+        if (g_strcmp0(signal_name, "view_title_changed") == 0)
+        {
+            const gchar* value;
+
+            g_variant_get(parameters, "(u&s)", &id, &value);
+            view->title = value;
+        }
+        else
+        if (g_strcmp0(signal_name, "view_minimized_changed") == 0)
+        {
+            g_variant_get(parameters, "(ub)", &id, &view->minimized);
+        }
+        else
+        if (g_strcmp0(signal_name, "view_maximized_changed") == 0)
+        {
+            g_variant_get(parameters, "(ub)", &id, &view->maximized);
+        }
+        else
+        if (g_strcmp0(signal_name, "view_fullscreen_changed") == 0)
+        {
+            g_variant_get(parameters, "(ub)", &id, &view->fullscreened);
+        }
+        else
+        if (g_strcmp0(signal_name, "view_focus_changed") == 0)
+        {
+            for (std::pair<const guint, view_t>& other : views)
+            {
+                other.second.active = FALSE;
+            }
+
+            view->active = TRUE;
+        }
+        else
+        if (g_strcmp0(signal_name, "view_output_moved") == 0)
+        {
+            guint old_output;
+
+            g_variant_get(parameters, "(uuu)", &id, &old_output, &view->output);
+        }
+        else
+        if (g_strcmp0(signal_name, "view_role_changed") == 0)
+        {
+            g_variant_get(parameters, "(uu)", &id, &view->role);
+        }
+        else
+        if (g_strcmp0(signal_name, "view_group_leader_changed") == 0)
+        {
+            g_variant_get(parameters, "(uu)", &id, &view->group_leader);
+        }
+        else
+        if (g_strcmp0(signal_name, "view_workspaces_changed") == 0)
+        {
+            queue_workspaces(id);
+        }
+    }
+};
+}
+
+#endif